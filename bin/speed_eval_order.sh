@@ -0,0 +1,100 @@
+#! /bin/bash -e
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Time the fit command, and count its cache misses, with the data_model
+# eval_order_ sorted (SORT_EVAL_ORDER 1) and in subset_id order
+# (SORT_EVAL_ORDER 0). The data in example/user/speed.py alternates between
+# children and integrands, so subset_id order jumps between model information.
+# ----------------------------------------------------------------------------
+# parameters that can be changed
+#
+# non-zero so same random see each time.
+random_seed='123'
+#
+# number of random effects is 2 * n_children
+n_children='20'
+#
+# use quasi-Newton (otherwise Newton)
+quasi_fixed='false'
+#
+# smaller increase work per function evaluation
+ode_step_size='1.0'
+#
+# n_data
+n_data=2000
+#
+# max_fit
+max_fit=1000
+# -----------------------------------------------------------------------------
+if [ "$0" != 'bin/speed_eval_order.sh' ]
+then
+   echo 'bin/speed_eval_order.sh must be run from its parent directory'
+   exit 1
+fi
+if [ "$1" != '' ]
+then
+   echo 'usage: bin/speed_eval_order.sh'
+   echo 'see settings at top of bin/speed_eval_order.sh'
+   exit 1
+fi
+if ! grep "^build_type *= *'release'" bin/install_settings.py > /dev/null
+then
+   echo 'bin/speed_eval_order.sh: install_settings.py build_type is not release'
+   exit 1
+fi
+if ! grep '^# define SORT_EVAL_ORDER 1$' devel/model/data_model.cpp > /dev/null
+then
+   echo 'bin/speed_eval_order.sh: SORT_EVAL_ORDER is not 1 in data_model.cpp'
+   exit 1
+fi
+#
+# restore data_model.cpp when this script exits
+trap 'sed -i -e "s|^# define SORT_EVAL_ORDER 0$|# define SORT_EVAL_ORDER 1|" \
+   devel/model/data_model.cpp' EXIT
+#
+# perf_command
+if which perf > /dev/null 2> /dev/null
+then
+   perf_command='perf stat -e cache-references,cache-misses'
+else
+   echo 'bin/speed_eval_order.sh: perf not found, cache misses not counted'
+   perf_command=''
+fi
+# -----------------------------------------------------------------------------
+echo "bin/run_cmake.sh > build/speed_eval_order.log"
+bin/run_cmake.sh > build/speed_eval_order.log
+for sort in 1 0
+do
+   name="sort_eval_order_$sort"
+   define='# define SORT_EVAL_ORDER'
+   sed -i -e "s|^$define [01]\$|$define $sort|" devel/model/data_model.cpp
+   #
+   # build dismod_at
+   echo "make dismod_at >> build/speed_eval_order.log"
+   cd build
+   make dismod_at >> speed_eval_order.log
+   cd ..
+   #
+   # create database
+   arguments="$random_seed $n_children $quasi_fixed $ode_step_size"
+   arguments+=" $n_data $max_fit"
+   echo "python3 example/user/speed.py $arguments >> build/$name.log"
+   python3 example/user/speed.py $arguments > build/$name.log
+   #
+   # run timing and cache miss test
+   pushd build/example/user > /dev/null
+   program="../../devel/dismod_at"
+   echo "time $perf_command $program example.db fit both 0 >& build/$name.out"
+   ( time $perf_command $program example.db fit both 0 ) >& ../../$name.out
+   popd > /dev/null
+done
+# -----------------------------------------------------------------------------
+for sort in 1 0
+do
+   name="sort_eval_order_$sort"
+   echo "build/$name.out:"
+   grep -E 'cache-|^real|^user' build/$name.out || true
+done
+echo 'bin/speed_eval_order.sh: OK'
@@ -4,6 +4,12 @@
 // SPDX-FileContributor: 2014-25 Bradley M. Bell
 // ----------------------------------------------------------------------------
 
+# include <cmath>
+# include <limits>
+# include <algorithm>
+# include <chrono>
+# include <memory>
+# include <cstring>
 # include <dismod_at/fit_command.hpp>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/get_prior_sim_table.hpp>
@@ -16,6 +22,295 @@
 # include <dismod_at/blob_table.hpp>
 # include <dismod_at/pack_warm_start.hpp>
 # include <dismod_at/get_str_map.hpp>
+# include <dismod_at/get_prior_mean.hpp>
+# include <dismod_at/fixed_effect.hpp>
+# include <dismod_at/null_int.hpp>
+# include <dismod_at/log_message.hpp>
+# include <dismod_at/configure.hpp>
+# include <dismod_at/process_loop.hpp>
+
+namespace { // BEGIN_EMPTY_NAMESPACE
+   // multistart_var
+   // Set the fixed effects in start_vec, that are not constant, to the
+   // starting point for multistart index start_index > 0; see
+   // fit_command@multistart@Starting Points.
+   void multistart_var(
+      size_t                                        start_index ,
+      const CppAD::vector<size_t>&                  fixed2var   ,
+      const CppAD::vector<double>&                  var_lower   ,
+      const CppAD::vector<double>&                  var_upper   ,
+      const CppAD::vector<double>&                  prior_mean  ,
+      const dismod_at::pack_prior&                  var2prior   ,
+      const CppAD::vector<dismod_at::prior_struct>& prior_table ,
+      CppAD::vector<double>&                        start_vec   )
+   {  assert( start_index > 0 );
+      //
+      // phi: golden ratio minus one
+      double phi = ( std::sqrt(5.0) - 1.0 ) / 2.0;
+      for(size_t j = 0; j < fixed2var.size(); ++j)
+      {  size_t var_id = fixed2var[j];
+         double lower  = var_lower[var_id];
+         double upper  = var_upper[var_id];
+         if( lower < upper )
+         {  // u: deterministic point in (0, 1) for this start and effect
+            double alpha = std::sqrt( double(2 * j + 3) ) * phi;
+            double u     = std::fmod( 0.5 + double(start_index) * alpha, 1.0 );
+            //
+            double value;
+            if( std::isfinite(lower) && std::isfinite(upper) )
+            {  if( 0.0 < lower )
+                  value = lower * std::pow(upper / lower, u);
+               else
+                  value = lower + u * (upper - lower);
+            }
+            else
+            {  double mean     = prior_mean[var_id];
+               double std      = std::numeric_limits<double>::quiet_NaN();
+               size_t prior_id = var2prior.value_prior_id(var_id);
+               if( prior_id != DISMOD_AT_NULL_SIZE_T )
+                  std = prior_table[prior_id].std;
+               if( std::isfinite(std) && 0.0 < std )
+                  value = mean + 2.0 * std * (2.0 * u - 1.0);
+               else
+                  value = 2.0 * u * mean;
+               value = std::max(lower, std::min(upper, value) );
+            }
+            start_vec[var_id] = value;
+         }
+      }
+   }
+   //
+   // start_struct
+   // solution for one start and the messages it logged
+   struct start_struct {
+      double                                     obj_value;
+      double                                     inf_pr;
+      double                                     inf_du;
+      size_t                                     n_iter;
+      CppAD::vector<double>                      opt_value;
+      CppAD::vector<double>                      lag_value;
+      CppAD::vector<double>                      lag_dage;
+      CppAD::vector<double>                      lag_dtime;
+      CppAD::vector<CppAD::mixed::trace_struct>  trace_vec;
+      CppAD::mixed::warm_start_struct            warm_start;
+      CppAD::mixed::d_sparse_rcv                 random_hes_rcv;
+      std::map<std::string, size_t>              mixed_info;
+      CppAD::vector<std::string>                 log_type;
+      CppAD::vector<std::string>                 log_table;
+      CppAD::vector<size_t>                      log_row_id;
+      CppAD::vector<std::string>                 log_text;
+   };
+   //
+   // put_value, put_string, put_vector
+   // append a value to a sequence of bytes
+   void put_value(std::string& bytes, double value)
+   {  bytes.append( reinterpret_cast<const char*>(&value), sizeof(double) ); }
+   void put_string(std::string& bytes, const std::string& str)
+   {  put_value(bytes, double( str.size() ) );
+      bytes.append(str);
+   }
+   void put_vector(std::string& bytes, const CppAD::vector<double>& vec)
+   {  put_value(bytes, double( vec.size() ) );
+      for(size_t i = 0; i < vec.size(); ++i)
+         put_value(bytes, vec[i]);
+   }
+   //
+   // get_value, get_string, get_vector
+   // read a value starting at index in a sequence of bytes
+   // and advance index to the end of the value
+   double get_value(const std::string& bytes, size_t& index)
+   {  double value;
+      assert( index + sizeof(double) <= bytes.size() );
+      std::memcpy(&value, bytes.data() + index, sizeof(double) );
+      index += sizeof(double);
+      return value;
+   }
+   std::string get_string(const std::string& bytes, size_t& index)
+   {  size_t size = size_t( get_value(bytes, index) );
+      assert( index + size <= bytes.size() );
+      std::string str = bytes.substr(index, size);
+      index += size;
+      return str;
+   }
+   CppAD::vector<double> get_vector(const std::string& bytes, size_t& index)
+   {  CppAD::vector<double> vec( size_t( get_value(bytes, index) ) );
+      for(size_t i = 0; i < vec.size(); ++i)
+         vec[i] = get_value(bytes, index);
+      return vec;
+   }
+   //
+   // start2bytes
+   // convert a start_struct to a sequence of bytes
+   std::string start2bytes(const start_struct& start)
+   {  std::string bytes;
+      put_value(bytes, start.obj_value);
+      put_value(bytes, start.inf_pr);
+      put_value(bytes, start.inf_du);
+      put_value(bytes, double( start.n_iter ) );
+      put_vector(bytes, start.opt_value);
+      put_vector(bytes, start.lag_value);
+      put_vector(bytes, start.lag_dage);
+      put_vector(bytes, start.lag_dtime);
+      //
+      // trace_vec
+      put_value(bytes, double( start.trace_vec.size() ) );
+      for(size_t i = 0; i < start.trace_vec.size(); ++i)
+      {  const CppAD::mixed::trace_struct& trace = start.trace_vec[i];
+         put_value(bytes, double( trace.iter ) );
+         put_value(bytes, trace.obj_value);
+         put_value(bytes, trace.inf_pr);
+         put_value(bytes, trace.inf_du);
+         put_value(bytes, trace.mu);
+         put_value(bytes, trace.d_norm);
+         put_value(bytes, trace.regularization_size);
+         put_value(bytes, trace.alpha_du);
+         put_value(bytes, trace.alpha_pr);
+         put_value(bytes, double( trace.ls_trials ) );
+         put_value(bytes, double( trace.restoration ) );
+      }
+      //
+      // warm_start
+      CppAD::vector<double> random_opt(0);
+      put_vector(bytes, dismod_at::pack_warm_start(start.warm_start, random_opt));
+      //
+      // random_hes_rcv
+      const CppAD::mixed::d_sparse_rcv& rcv = start.random_hes_rcv;
+      put_value(bytes, double( rcv.nr() ) );
+      put_value(bytes, double( rcv.nc() ) );
+      put_value(bytes, double( rcv.nnz() ) );
+      for(size_t k = 0; k < rcv.nnz(); ++k)
+      {  put_value(bytes, double( rcv.row()[k] ) );
+         put_value(bytes, double( rcv.col()[k] ) );
+         put_value(bytes, rcv.val()[k] );
+      }
+      //
+      // mixed_info
+      put_value(bytes, double( start.mixed_info.size() ) );
+      std::map<std::string, size_t>::const_iterator itr;
+      for(itr = start.mixed_info.begin(); itr != start.mixed_info.end(); ++itr)
+      {  put_string(bytes, itr->first);
+         put_value(bytes, double( itr->second ) );
+      }
+      //
+      // log messages
+      put_value(bytes, double( start.log_type.size() ) );
+      for(size_t i = 0; i < start.log_type.size(); ++i)
+      {  put_string(bytes, start.log_type[i]);
+         put_string(bytes, start.log_table[i]);
+         put_value(bytes, double( start.log_row_id[i] ) );
+         put_string(bytes, start.log_text[i]);
+      }
+      return bytes;
+   }
+   //
+   // bytes2start
+   // convert a sequence of bytes to a start_struct
+   void bytes2start(const std::string& bytes, start_struct& start)
+   {  size_t index = 0;
+      start.obj_value = get_value(bytes, index);
+      start.inf_pr    = get_value(bytes, index);
+      start.inf_du    = get_value(bytes, index);
+      start.n_iter    = size_t( get_value(bytes, index) );
+      start.opt_value = get_vector(bytes, index);
+      start.lag_value = get_vector(bytes, index);
+      start.lag_dage  = get_vector(bytes, index);
+      start.lag_dtime = get_vector(bytes, index);
+      //
+      // trace_vec
+      start.trace_vec.resize( size_t( get_value(bytes, index) ) );
+      for(size_t i = 0; i < start.trace_vec.size(); ++i)
+      {  CppAD::mixed::trace_struct& trace = start.trace_vec[i];
+         trace.iter = decltype(trace.iter)( get_value(bytes, index) );
+         trace.obj_value           = get_value(bytes, index);
+         trace.inf_pr              = get_value(bytes, index);
+         trace.inf_du              = get_value(bytes, index);
+         trace.mu                  = get_value(bytes, index);
+         trace.d_norm              = get_value(bytes, index);
+         trace.regularization_size = get_value(bytes, index);
+         trace.alpha_du            = get_value(bytes, index);
+         trace.alpha_pr            = get_value(bytes, index);
+         trace.ls_trials =
+            decltype(trace.ls_trials)( get_value(bytes, index) );
+         trace.restoration = get_value(bytes, index) != 0.0;
+      }
+      //
+      // warm_start
+      CppAD::vector<double> random_opt;
+      start.warm_start = dismod_at::unpack_warm_start(
+         get_vector(bytes, index), random_opt
+      );
+      //
+      // random_hes_rcv
+      size_t nr  = size_t( get_value(bytes, index) );
+      size_t nc  = size_t( get_value(bytes, index) );
+      size_t nnz = size_t( get_value(bytes, index) );
+      CppAD::mixed::sparse_rc pattern(nr, nc, nnz);
+      CppAD::vector<double>   val(nnz);
+      for(size_t k = 0; k < nnz; ++k)
+      {  size_t r = size_t( get_value(bytes, index) );
+         size_t c = size_t( get_value(bytes, index) );
+         pattern.set(k, r, c);
+         val[k] = get_value(bytes, index);
+      }
+      CppAD::mixed::d_sparse_rcv rcv(pattern);
+      for(size_t k = 0; k < nnz; ++k)
+         rcv.set(k, val[k]);
+      start.random_hes_rcv = rcv;
+      //
+      // mixed_info
+      start.mixed_info.clear();
+      size_t n_info = size_t( get_value(bytes, index) );
+      for(size_t i = 0; i < n_info; ++i)
+      {  std::string name = get_string(bytes, index);
+         start.mixed_info[name] = size_t( get_value(bytes, index) );
+      }
+      //
+      // log messages
+      size_t n_log = size_t( get_value(bytes, index) );
+      start.log_type.resize(n_log);
+      start.log_table.resize(n_log);
+      start.log_row_id.resize(n_log);
+      start.log_text.resize(n_log);
+      for(size_t i = 0; i < n_log; ++i)
+      {  start.log_type[i]   = get_string(bytes, index);
+         start.log_table[i]  = get_string(bytes, index);
+         start.log_row_id[i] = size_t( get_value(bytes, index) );
+         start.log_text[i]   = get_string(bytes, index);
+      }
+      assert( index == bytes.size() );
+   }
+   //
+   // get_log_rows
+   // messages in the log table of db (if it exists)
+   void get_log_rows(sqlite3* db, start_struct& start)
+   {  const char*   sql_cmd =
+         "select message_type, table_name, row_id, message from log "
+         "order by log_id";
+      sqlite3_stmt* p_stmt  = DISMOD_AT_NULL_PTR;
+      int rc = sqlite3_prepare_v2(db, sql_cmd, -1, &p_stmt, DISMOD_AT_NULL_PTR);
+      if( rc != SQLITE_OK )
+      {  sqlite3_finalize(p_stmt);
+         return;
+      }
+      while( sqlite3_step(p_stmt) == SQLITE_ROW )
+      {  std::string text[3];
+         int col[3] = {0, 1, 3};
+         for(size_t j = 0; j < 3; ++j)
+         {  const unsigned char* ptr = sqlite3_column_text(p_stmt, col[j]);
+            if( ptr != DISMOD_AT_NULL_PTR )
+               text[j] = reinterpret_cast<const char*>(ptr);
+         }
+         size_t row_id = DISMOD_AT_NULL_SIZE_T;
+         if( sqlite3_column_type(p_stmt, 2) != SQLITE_NULL )
+            row_id = size_t( sqlite3_column_int64(p_stmt, 2) );
+         start.log_type.push_back( text[0] );
+         start.log_table.push_back( text[1] );
+         start.log_row_id.push_back( row_id );
+         start.log_text.push_back( text[2] );
+      }
+      sqlite3_finalize(p_stmt);
+   }
+} // END_EMPTY_NAMESPACE
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 /*
@@ -37,6 +332,7 @@ Syntax
 | ``dismod_at`` *database* ``fit`` *variables* *simulate_index*
 | ``dismod_at`` *database* ``fit`` *variables* ``warm_start``
 | ``dismod_at`` *database* ``fit`` *variables* *simulate_index* ``warm_start``
+| ``dismod_at`` *database* ``fit`` *variables* ``multistart`` *number_start*
 
 database
 ********
@@ -118,6 +414,12 @@ If ``warm_start`` is at the end of the command, the
 written by the previous fit,
 is used to start the optimization of the fixed effects
 where the previous fit left off.
+If the previous fit was a ``fit both`` command,
+the random effects start at their optimal values from that fit
+(instead of the :ref:`start_var_table-name` values).
+The limited memory quasi-Newton approximation used when
+:ref:`option_table@Optimize Fixed Only@quasi_fixed` is true
+is not saved and starts over.
 This is intended to be used in the following cases:
 
 #. Termination of previous fit is due to reaching
@@ -129,65 +431,52 @@ This is intended to be used in the following cases:
 Other options besides those listed above,
 should be the same as for the previous fit.
 
-data_subset_table
-*****************
-Only the data table rows with :ref:`data_table@data_id`
-that also appear in the :ref:`data_subset table<data_subset_table@data_id>`
-are included in the fit and residuals.
-
-hold_out
-********
-A data table :ref:`data_table@meas_value`
-is held out from the fit, but included in the residuals,
-if any of the following conditions hold:
-
-#. The data table :ref:`data_table@hold_out` is non-zero.
-#. The corresponding data_subset table
-   :ref:`data_subset_table@hold_out` is non-zero;
-   see :ref:`hold_out_command-name` .
-#. The data table :ref:`integrand<data_table@integrand_id>`
-   corresponds to an :ref:`integrand_table@integrand_name`
-   that is in the option table
-   :ref:`option_table@hold_out_integrand` list
-
-After the optimal variable values are found,
-the hold out residuals are computed so one can check the
-predictive validity for hold out data.
-The residuals for hold out data (other data) are computed once (many times)
-for each fit.
-
-Output Tables
-*************
-
-fit_var_table
-=============
-A new :ref:`fit_var_table-name` is created each time this command is run.
-It contains the results of the fit in its
-:ref:`fit_var_table@fit_var_value` column.
+multistart
+**********
+If ``multistart`` is present,
+*number_start* is a positive integer and
+the fixed effects are optimized *number_start* times,
+each time starting from a different point and using a separate
+fit of the model.
+The solution with the smallest fixed effects objective,
+evaluated without the Ipopt scaling at the solution for each start,
+is used for the output tables
+(the :ref:`trace_fixed_table@obj_value` is scaled using the starting point
+and cannot be compared between starts).
+If there are random effects, this objective includes the
+Laplace approximation term.
+In this case *variables* must be ``fixed`` or ``both`` .
 
-fit_data_subset_table
-=====================
-A new :ref:`fit_data_subset_table-name` is created each time this command is run.
-It is a comparison of the model and data corresponding to the fit results.
+Starting Points
+===============
+The first start uses the :ref:`start_var_table-name` .
+The other starts use the start_var table values for the random effects
+and the following values for each fixed effect that is not constant:
+Let *k* be the index of the start and *j* the index of the fixed effect.
+A deterministic number *u* in the interval (0, 1) is chosen using
+the fractional part of *k* times an irrational number that depends on *j* .
+If the lower and upper limits for the variable are finite,
+the starting value is *u* of the way between the limits
+(in log scale when the lower limit is positive).
+Otherwise, it is within two prior standard deviations of the prior mean
+(within a factor of two of the prior mean if the standard deviation
+is not finite) and is then projected onto the limits.
+Hence running the same command twice gives the same results.
 
-trace_fixed
-===========
-A new :ref:`trace_fixed_table-name` is created each time a
-``fit fixed`` or ``fit both`` command is run.
-It contains a trace of the corresponding optimization.
+Processes
+=========
+The starts are run at the same time, each in a separate process,
+using at most :ref:`option_table@number_thread` processes.
+(Separate processes are used because the sparse linear solvers used by Ipopt,
+and the cppad_mixed object for each start, are not thread safe.)
+The database is read and the model set up once, before the processes
+are created, and only this process writes to the database.
+The messages that a start logs are written to the log table
+when it is done, in order of the start index.
+The output tables do not depend on the number of processes.
+If *number_thread* is one, or the system does not support ``fork`` ,
+the starts are run one after the other.
 
-hes_random_table
-================
-A new :ref:`hes_random_table-name` is created each time this command is run
-with *variables* equal to ``random`` or ``both`` .
-The Hessian of the random effects objective is written in this table.
-If *simulate_index* is present (is not present) the Hessian corresponds
-to the simulated measurements in the :ref:`data_sim_table-name`
-(measurements in the :ref:`data_table-name` ).
-
-mixed_info
-==========
-A new :ref:`mixed_info_table-name` table is created each time this command is run.
 
 ipopt_info_table
 ================
@@ -195,9 +484,40 @@ The fixed effect are optimized when
 *variables* is equal to ``both`` or ``fixed`` .
 In the case a new ``ipopt_info`` table, corresponding to the final
 fit for the fixed effects, is written to the ipopt_info table.
+If *variables* is ``both`` , it also contains the optimal random effects.
 The contents of this table are unspecified; i.e., not part of the
 dismod_at API and my change.
 
+multistart_table
+================
+If ``multistart`` is present, a new ``multistart`` table is created.
+It has one row for each start and the following columns:
+
+.. list-table::
+   :widths: auto
+
+   * - Column
+     - Type
+     - Meaning
+   * - multistart_id
+     - integer
+     - primary key for this table and index of the start
+   * - obj_value
+     - real
+     - fixed effects objective, without scaling, at the solution for this start
+   * - inf_pr
+     - real
+     - final :ref:`trace_fixed_table@inf_pr` for this start
+   * - inf_du
+     - real
+     - final :ref:`trace_fixed_table@inf_du` for this start
+   * - n_iter
+     - integer
+     - number of fixed effects iterations for this start
+   * - best
+     - integer
+     - one for the start used for the other output tables, zero otherwise
+
 Random Effects
 **************
 A model has random effects if one of the
@@ -246,11 +566,16 @@ using this command.
 // subset_data_obj and prior_object are const when simulate_index == ""
 void fit_command(
    bool                                          use_warm_start   ,
+   size_t                                        number_start     ,
    const std::string&                            variables        ,
    const std::string&                            simulate_index   ,
    sqlite3*                                      db               ,
    CppAD::vector<dismod_at::subset_data_struct>& subset_data_obj  ,
    dismod_at::data_model&                        data_object      ,
+   const CppAD::vector<double>&                  stage_step_size  ,
+   const std::function<
+      dismod_at::data_model*(double)
+   >&                                            new_stage_model  ,
    dismod_at::prior_model&                       prior_object     ,
    const dismod_at::pack_info&                   pack_object      ,
    const dismod_at::pack_prior&                  var2prior        ,
@@ -275,6 +600,12 @@ void fit_command(
       msg       += "only optimizing random effects";
       dismod_at::error_exit(msg);
    }
+   assert( number_start > 0 );
+   if( number_start > 1 && variables == "random" )
+   {  string msg = "dismod_at fit command: cannot use multistart when ";
+      msg       += "only optimizing random effects";
+      dismod_at::error_exit(msg);
+   }
    //
    // bound_random
    double bound_random = 0.0;
@@ -405,11 +736,23 @@ void fit_command(
       vector<double> vec( sizeof_data / sizeof(double) );
       data = reinterpret_cast<void*>( vec.data() );
       read_blob_table(db, table_name, col_name, sizeof_data, data);
-      warm_start_in = unpack_warm_start(vec);
+      vector<double> random_opt;
+      warm_start_in = unpack_warm_start(vec, random_opt);
+      //
+      // start the random effects at their previous optimal values
+      if( random_opt.size() == n_random )
+      {  for(size_t j = 0; j < n_random; ++j)
+         {  random_opt[j] = std::max( random_opt[j], random_lower[j] );
+            random_opt[j] = std::min( random_opt[j], random_upper[j] );
+         }
+         pack_random(pack_object, start_var, random_opt);
+      }
    }
    // ------------------ run fit_model ------------------------------------
    // quasi_fixed
    bool quasi_fixed = get_str_map(option_map, "quasi_fixed") == "true";
+   bool zero_sum_basis =
+      get_str_map(option_map, "zero_sum_basis") == "true";
    //
    // trace_init_fit_model
    bool trace_init =
@@ -418,38 +761,261 @@ void fit_command(
    // warn_on_stderr
    bool warn_on_stderr = get_str_map(option_map, "warn_on_stderr") == "true";
    //
-   dismod_at::fit_model fit_object(
-      db                   ,
-      simulation_index     ,
-      warn_on_stderr       ,
-      bound_random         ,
-      pack_object          ,
-      var2prior            ,
-      start_var            ,
-      scale_var            ,
-      db_input.prior_table ,
-      prior_object         ,
-      random_const         ,
-      quasi_fixed          ,
-      zero_sum_child_rate  ,
-      zero_sum_mulcov_group,
-      data_object          ,
-      trace_init
-   );
-   fit_object.run_fit(random_only, option_map, warm_start_in);
+   // ------------------ ode_step_schedule stages --------------------------
+   // Each stage starts where the previous one left off, and the last
+   // stage provides start_var and warm_start_in for the final fit.
+   size_t n_stage = stage_step_size.size();
+   assert( n_stage == 0 || number_start == 1 );
+   assert( n_stage == 0 || ! (use_warm_start || random_only) );
+   std::chrono::steady_clock::time_point fit_begin =
+      std::chrono::steady_clock::now();
+   for(size_t stage = 0; stage < n_stage; ++stage)
+   {  // stage_data
+      // only exists during this stage
+      std::unique_ptr<dismod_at::data_model> stage_ptr(
+         new_stage_model( stage_step_size[stage] )
+      );
+      dismod_at::data_model& stage_data( *stage_ptr );
+      stage_data.replace_like(subset_data_obj);
+      dismod_at::fit_model stage_fit(
+         db                   ,
+         simulation_index     ,
+         warn_on_stderr       ,
+         bound_random         ,
+         pack_object          ,
+         var2prior            ,
+         start_var            ,
+         scale_var            ,
+         db_input.prior_table ,
+         prior_object         ,
+         random_const         ,
+         quasi_fixed          ,
+         zero_sum_child_rate  ,
+         zero_sum_mulcov_group,
+         zero_sum_basis       ,
+         stage_data           ,
+         trace_init
+      );
+      stage_fit.run_fit(random_only, option_map, warm_start_in);
+      vector<double> opt_tmp, lag_value_tmp, lag_dage_tmp, lag_dtime_tmp;
+      vector<CppAD::mixed::trace_struct> trace_tmp;
+      CppAD::mixed::warm_start_struct warm_start_tmp;
+      stage_fit.get_solution(
+         opt_tmp,
+         lag_value_tmp,
+         lag_dage_tmp,
+         lag_dtime_tmp,
+         trace_tmp,
+         warm_start_tmp
+      );
+      start_var     = opt_tmp;
+      warm_start_in = warm_start_tmp;
+      //
+      // log this stage
+      std::chrono::steady_clock::time_point stage_end =
+         std::chrono::steady_clock::now();
+      std::chrono::duration<double> seconds = stage_end - fit_begin;
+      fit_begin = stage_end;
+      size_t n_iter = 0;
+      if( trace_tmp.size() > 0 )
+         n_iter = size_t( trace_tmp[ trace_tmp.size() - 1 ].iter );
+      string msg = "ode_step_schedule: ode_step_size = ";
+      msg += to_string( stage_step_size[stage] );
+      msg += ", iterations = " + to_string(n_iter);
+      msg += ", seconds = " + to_string( seconds.count() );
+      log_message(db, DISMOD_AT_NULL_PTR, "value", msg);
+   }
+   // ----------------------------------------------------------------------
+   // fixed2var, prior_mean
+   vector<size_t> fixed2var;
+   vector<double> prior_mean;
+   if( number_start > 1 )
+   {  fixed2var  = fixed2var_id(pack_object);
+      prior_mean = get_prior_mean(db_input.prior_table, var2prior);
+   }
+   //
+   // multistart_obj, multistart_inf_pr, multistart_inf_du, multistart_n_iter
+   vector<double> multistart_obj(number_start);
+   vector<double> multistart_inf_pr(number_start);
+   vector<double> multistart_inf_du(number_start);
+   vector<size_t> multistart_n_iter(number_start);
+   //
+   // best_start, opt_value, lag_value, lag_dage, lag_dtime, trace_vec,
+   // warm_start_out, random_hes_rcv, mixed_info
+   // solution corresponding to the best start
+   size_t best_start = 0;
    vector<double> opt_value, lag_value, lag_dage, lag_dtime;
    vector<CppAD::mixed::trace_struct> trace_vec;
    CppAD::mixed::warm_start_struct warm_start_out;
-   fit_object.get_solution(
-      opt_value, lag_value, lag_dage, lag_dtime, trace_vec, warm_start_out
-   );
+   CppAD::mixed::d_sparse_rcv      random_hes_rcv;
+   std::map<std::string, size_t>   mixed_info;
+   //
+   // start_work
+   // fit starting at start_index; if child is true, this is a separate
+   // process and its log messages are returned instead of written to db
+   auto start_work = [&](size_t start_index, bool child)
+   {  //
+      // log_db
+      sqlite3* log_db = db;
+      if( child )
+      {  int rc = sqlite3_open(":memory:", &log_db);
+         if( rc != SQLITE_OK )
+            std::exit(1);
+         dismod_at::error_exit(log_db);
+      }
+      //
+      // start_vec
+      vector<double> start_vec = start_var;
+      if( start_index > 0 ) multistart_var(
+         start_index,
+         fixed2var,
+         var_lower,
+         var_upper,
+         prior_mean,
+         var2prior,
+         db_input.prior_table,
+         start_vec
+      );
+      //
+      dismod_at::fit_model fit_object(
+         log_db               ,
+         simulation_index     ,
+         warn_on_stderr       ,
+         bound_random         ,
+         pack_object          ,
+         var2prior            ,
+         start_vec            ,
+         scale_var            ,
+         db_input.prior_table ,
+         prior_object         ,
+         random_const         ,
+         quasi_fixed          ,
+         zero_sum_child_rate  ,
+         zero_sum_mulcov_group,
+         zero_sum_basis       ,
+         data_object          ,
+         trace_init
+      );
+      fit_object.run_fit(random_only, option_map, warm_start_in);
+      start_struct start;
+      fit_object.get_solution(
+         start.opt_value,
+         start.lag_value,
+         start.lag_dage,
+         start.lag_dtime,
+         start.trace_vec,
+         start.warm_start
+      );
+      //
+      // obj_value
+      // the trace_fixed objective is scaled using the starting point,
+      // so the starts are compared using the objective without scaling
+      double nan = std::numeric_limits<double>::quiet_NaN();
+      start.obj_value = nan;
+      if( number_start > 1 )
+         start.obj_value = fit_object.fixed_objective(start.opt_value);
+      //
+      // inf_pr, inf_du, n_iter
+      size_t n_trace = start.trace_vec.size();
+      if( n_trace == 0 )
+      {  start.n_iter = 0;
+         start.inf_pr = nan;
+         start.inf_du = nan;
+      }
+      else
+      {  const CppAD::mixed::trace_struct& last = start.trace_vec[n_trace - 1];
+         start.n_iter = size_t( last.iter );
+         start.inf_pr = last.inf_pr;
+         start.inf_du = last.inf_du;
+      }
+      //
+      // mixed_info, random_hes_rcv
+      start.mixed_info = fit_object.cppad_mixed_info();
+      if( variables != "fixed" )
+         start.random_hes_rcv = fit_object.random_obj_hes(start.opt_value);
+      //
+      // log messages
+      if( child )
+      {  get_log_rows(log_db, start);
+         sqlite3_close(log_db);
+      }
+      return start2bytes(start);
+   };
+   //
+   // start_result
+   // keep the solution for start_index if it is the best so far
+   auto start_result = [&](size_t start_index, const std::string& bytes)
+   {  start_struct start;
+      bytes2start(bytes, start);
+      //
+      // log messages from a separate process
+      for(size_t i = 0; i < start.log_type.size(); ++i) log_message(
+         db,
+         DISMOD_AT_NULL_PTR,
+         start.log_type[i],
+         start.log_text[i],
+         start.log_table[i],
+         start.log_row_id[i]
+      );
+      //
+      // multistart_obj, multistart_inf_pr, multistart_inf_du,
+      // multistart_n_iter
+      multistart_obj[start_index]    = start.obj_value;
+      multistart_inf_pr[start_index] = start.inf_pr;
+      multistart_inf_du[start_index] = start.inf_du;
+      multistart_n_iter[start_index] = start.n_iter;
+      //
+      // better: is this start better than the best so far
+      double obj_tmp  = multistart_obj[start_index];
+      double obj_best = multistart_obj[best_start];
+      bool   better   = start_index == 0;
+      if( ! std::isnan(obj_tmp) )
+         better |= std::isnan(obj_best) || obj_tmp < obj_best;
+      if( better )
+      {  best_start = start_index;
+         opt_value.swap(start.opt_value);
+         lag_value.swap(start.lag_value);
+         lag_dage.swap(start.lag_dage);
+         lag_dtime.swap(start.lag_dtime);
+         trace_vec.swap(start.trace_vec);
+         warm_start_out = start.warm_start;
+         mixed_info     = start.mixed_info;
+         random_hes_rcv = start.random_hes_rcv;
+      }
+   };
+   //
+   // n_process
+   size_t n_process = 1;
+   if( number_start > 1 )
+   {  n_process = std::atoi( get_str_map(option_map, "number_thread").c_str() );
+      n_process = std::max( size_t(1), std::min(n_process, number_start) );
+   }
+   //
+   // run the starts
+   // (messages held by log_buffer are written before the processes start)
+   if( n_process > 1 )
+      log_buffer(db, false);
+   string msg = process_loop(n_process, number_start, start_work, start_result);
+   if( n_process > 1 )
+      log_buffer(db, true);
+   if( msg != "" )
+   {  msg = "dismod_at fit command: multistart: " + msg;
+      dismod_at::error_exit(msg);
+   }
+   if( n_stage > 0 )
+   {  // log the final stage
+      std::chrono::duration<double> seconds =
+         std::chrono::steady_clock::now() - fit_begin;
+      size_t n_iter = multistart_n_iter[0];
+      string msg = "ode_step_schedule: ode_step_size = ";
+      msg += get_str_map(option_map, "ode_step_size");
+      msg += ", iterations = " + to_string(n_iter);
+      msg += ", seconds = " + to_string( seconds.count() );
+      log_message(db, DISMOD_AT_NULL_PTR, "value", msg);
+   }
    // ------------------ hes_random table ----------------------------------
    if( variables != "fixed" )
    {  //
-      // random_hes_rcv
-      CppAD::mixed::d_sparse_rcv random_hes_rcv =
-         fit_object.random_obj_hes(opt_value);
-      //
       // drop previous verison of this table
       string sql_cmd = "drop table if exists hes_random";
       dismod_at::exec_sql_cmd(db, sql_cmd);
@@ -495,7 +1061,7 @@ void fit_command(
       dismod_at::exec_sql_cmd(db, sql_cmd);
       //
       // copy of map
-      std::map<std::string, size_t> info = fit_object.cppad_mixed_info();
+      std::map<std::string, size_t> info = mixed_info;
       //
       // iterator for elements of map
       std::map<std::string, size_t>::iterator itr;
@@ -534,8 +1100,16 @@ void fit_command(
    {  string sql_cmd = "drop table if exists ipopt_info";
       dismod_at::exec_sql_cmd(db, sql_cmd);
       //
+      // random_opt: only a fit of both fixed and random effects
+      // determines the random effects for a warm start
+      vector<double> random_opt;
+      if( variables == "both" )
+      {  random_opt.resize(n_random);
+         unpack_random(pack_object, opt_value, random_opt);
+      }
+      //
       // pack the warm start information in a vector
-      vector<double> vec = pack_warm_start(warm_start_out);
+      vector<double> vec = pack_warm_start(warm_start_out, random_opt);
       //
       table_name         = "ipopt_info";
       string col_name    = "warm_start";
@@ -543,6 +1117,54 @@ void fit_command(
       void* data         = reinterpret_cast<void*>( vec.data() );
       write_blob_table(db, table_name, col_name, sizeof_data, data);
    }
+   // ------------------ multistart table -----------------------------------
+   if( number_start > 1 )
+   {  string sql_cmd = "drop table if exists multistart";
+      dismod_at::exec_sql_cmd(db, sql_cmd);
+      //
+      table_name   = "multistart";
+      size_t n_col = 5;
+      vector<string> col_name(n_col), col_type(n_col);
+      vector<string> row_value(n_col * number_start);
+      vector<bool>   col_unique(n_col, false);
+      //
+      col_name[0]   = "obj_value";
+      col_type[0]   = "real";
+      //
+      col_name[1]   = "inf_pr";
+      col_type[1]   = "real";
+      //
+      col_name[2]   = "inf_du";
+      col_type[2]   = "real";
+      //
+      col_name[3]   = "n_iter";
+      col_type[3]   = "integer";
+      //
+      col_name[4]   = "best";
+      col_type[4]   = "integer";
+      //
+      for(size_t start_index = 0; start_index < number_start; ++start_index)
+      {  // empty corresponds to null in database
+         for(size_t k = 0; k < 3; ++k)
+            row_value[start_index * n_col + k] = "";
+         if( ! std::isnan( multistart_obj[start_index] ) )
+            row_value[start_index * n_col + 0] =
+               to_string( multistart_obj[start_index] );
+         if( ! std::isnan( multistart_inf_pr[start_index] ) )
+         {  row_value[start_index * n_col + 1] =
+               to_string( multistart_inf_pr[start_index] );
+            row_value[start_index * n_col + 2] =
+               to_string( multistart_inf_du[start_index] );
+         }
+         row_value[start_index * n_col + 3] =
+            to_string( multistart_n_iter[start_index] );
+         row_value[start_index * n_col + 4] =
+            to_string( int( start_index == best_start ) );
+      }
+      dismod_at::create_table(
+         db, table_name, col_name, col_type, col_unique, row_value
+      );
+   }
    // -------------------- fit_var table --------------------------------------
    string sql_cmd = "drop table if exists fit_var";
    dismod_at::exec_sql_cmd(db, sql_cmd);
@@ -641,18 +1263,17 @@ void fit_command(
    col_type[1]   = "real";
    col_unique[1] = false;
    //
+   // compute average integrand and residual for all the data
+   CppAD::vector<double> avg_vec, delta_vec;
+   CppAD::vector< dismod_at::residual_struct<double> > residual_vec;
+   data_object.average_all(opt_value, avg_vec, delta_vec, residual_vec);
    for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
-   {  // compute average integrand for this data item
-      double avg = data_object.average(subset_id, opt_value);
+   {  double avg = avg_vec[subset_id];
       assert( ! CppAD::isnan(avg) );
-
-      // compute its residual and log likelihood
-      double not_used;
-      dismod_at::residual_struct<double> residual =
-         data_object.like_one(subset_id, opt_value, avg, not_used);
       //
       row_value[ subset_id * n_col + 0] = to_string( avg );
-      row_value[ subset_id * n_col + 1] = to_string( residual.wres );
+      row_value[ subset_id * n_col + 1] =
+         to_string( residual_vec[subset_id].wres );
    }
    dismod_at::create_table(
       db, table_name, col_name, col_type, col_unique, row_value
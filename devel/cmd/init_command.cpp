@@ -191,6 +191,7 @@ void init_command(
    const char* drop_list[] = {
       "bnd_mulcov",
       "data_sim",
+      "data_sim_blob",
       "data_subset",
       "depend_var",
       "fit_data_subset",
@@ -198,10 +199,14 @@ void init_command(
       "hes_fixed",
       "hes_random",
       "ipopt_info",
+      "mcmc_diagnostic",
       "mixed_info",
+      "multistart",
       "predict",
+      "predict_summary",
       "prior_sim",
       "sample",
+      "sample_blob",
       "scale_var",
       "start_var",
       "trace_fixed",
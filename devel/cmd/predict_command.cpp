@@ -8,14 +8,24 @@
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/get_table_column.hpp>
 # include <dismod_at/get_sample_table.hpp>
+# include <dismod_at/compact_table.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
 # include <dismod_at/create_table.hpp>
 # include <dismod_at/censor_var_limit.hpp>
+# include <dismod_at/stream_summary.hpp>
+# include <dismod_at/block_cholesky.hpp>
+# include <dismod_at/does_table_exist.hpp>
+# include <dismod_at/a1_double.hpp>
+# include <dismod_at/fixed_effect.hpp>
+# include <dismod_at/null_int.hpp>
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 /*
 -------------------------------------------------------------------------------
 {xrst_begin predict_command}
+{xrst_spell
+   avgint
+}
 
 The Predict Command
 ###################
@@ -24,6 +34,9 @@ Syntax
 ******
 ``dismod_at`` *database* ``predict`` *source*
 ``dismod_at`` *database* ``predict`` *source* ``zero_meas_value``
+``dismod_at`` *database* ``predict`` *source* ``summary``
+``dismod_at`` *database* ``predict`` *source* ``zero_meas_value summary``
+``dismod_at`` *database* ``predict fit_var delta``
 
 database
 ********
@@ -74,6 +87,122 @@ If this argument is present, the value zero is used for the
 This predicts what the mean of the corresponding data
 would be if there were no measurement value covariate effects.
 
+summary
+*******
+If this argument is present,
+the predict table is not changed and a new
+predict_summary table is created (see below).
+This is intended for use with *source* equal to ``sample``
+when there are many samples and only summary statistics
+for each *avgint_id* are needed.
+
+predict_summary
+===============
+This table has one row for each
+:ref:`predict_table@avgint_id` in the
+:ref:`predict_table@Avgint Subset` and the following columns:
+
+.. list-table::
+   :widths: auto
+
+   * - Column
+     - Type
+     - Meaning
+   * - predict_summary_id
+     - integer
+     - primary key for this table
+   * - avgint_id
+     - integer
+     - the avgint table row that this summary corresponds to
+   * - n_sample
+     - integer
+     - number of sets of model variables that were summarized
+   * - mean
+     - real
+     - mean of the average integrand
+   * - std
+     - real
+     - sample standard deviation of the average integrand
+   * - lower
+     - real
+     - 0.025 quantile of the average integrand
+   * - median
+     - real
+     - 0.5 quantile of the average integrand
+   * - upper
+     - real
+     - 0.975 quantile of the average integrand
+
+The statistics are accumulated one set of model variables at a time using
+:ref:`stream_summary-name` .
+Hence the memory used does not depend on the number of samples
+and the quantiles are exact when there are five or less samples
+(approximate otherwise).
+
+delta
+*****
+If this argument is present, *source* must be ``fit_var``
+and the other optional arguments cannot be present.
+In this case the predict table has an extra column
+:ref:`predict_table@avg_std` that contains the delta method
+approximation for the standard deviation of each prediction.
+
+Jacobian
+========
+The Jacobian of the average integrand for all the rows in the
+:ref:`predict_table@Avgint Subset` , with respect to the model variables,
+is computed using one recording of the average integrand
+and a CppAD sparse Jacobian calculation.
+The derivatives with respect to
+:ref:`scaled<prior_table@eta@Scaling Fixed Effects>` fixed effects
+are converted to the scaled space used by the Hessians.
+
+Covariance
+==========
+The covariance of the fixed effects is the inverse of the
+:ref:`hes_fixed_table-name` and the covariance of the random effects
+is the inverse of the :ref:`hes_random_table-name` .
+These tables are created by the
+:ref:`asymptotic<sample_command@asymptotic>` sample command,
+which must be run (after the fit that created the fit_var table)
+before this command.
+Model variables that do not appear in these tables
+(e.g. constants) do not contribute to the variance.
+Each Hessian is factored by
+:ref:`blocks<block_cholesky-name>` of variables that are connected
+by non-zero elements.
+
+Approximation
+=============
+Let :math:`g_\theta` and :math:`g_u` be the derivative of a prediction
+with respect to the fixed and random effects,
+:math:`H_\theta` the :ref:`hes_fixed_table-name` Hessian, and
+:math:`H_u` the :ref:`hes_random_table-name` Hessian.
+The variance reported is
+
+.. math::
+
+   g_\theta^\R{T} H_\theta^{-1} g_\theta + g_u^\R{T} H_u^{-1} g_u
+
+The first term uses the marginal covariance of the fixed effects
+(:math:`H_\theta` is the Hessian of the Laplace approximation
+for the fixed effects objective).
+The second term uses the covariance of the random effects
+conditional on the fixed effects.
+The covariance between the fixed and random effects,
+which comes from the optimal random effects :math:`\hat{u}( \theta )`
+changing with the fixed effects, is not included.
+(It would require the cross Hessian of the random likelihood
+with respect to the fixed and random effects,
+which is not stored in the database.)
+Hence, for predictions that depend on the random effects,
+*avg_std* may understate the marginal standard deviation.
+For predictions that do not depend on the random effects,
+e.g., predictions for the parent node,
+*avg_std* is the delta method approximation using the
+marginal covariance of the fixed effects.
+Use the :ref:`sample_command@asymptotic` samples and
+``predict sample`` if the fixed and random effects covariance is important.
 
 predict_table
 *************
@@ -97,10 +226,154 @@ using this command.
 {xrst_end predict_command}
 */
 
+// ----------------------------------------------------------------------------
+namespace { // BEGIN_EMPTY_NAMESPACE
+   // block Cholesky factor of the Hessian in hes_fixed or hes_random table
+   dismod_at::block_cholesky hessian_factor(
+      sqlite3*            db         ,
+      const std::string&  table_name ,
+      size_t              n_var      )
+   {  using std::string;
+      using CppAD::vector;
+      //
+      if( ! dismod_at::does_table_exist(db, table_name) )
+      {  string msg = "predict fit_var delta: the ";
+         msg += table_name + " table does not exist.\n";
+         msg += "Run the sample asymptotic command first ";
+         msg += "with asymptotic_lanczos_step equal to zero.";
+         dismod_at::error_exit(msg);
+      }
+      vector<int>    row_var_id, col_var_id;
+      vector<double> hes_value;
+      dismod_at::get_table_column(db, table_name, "row_var_id", row_var_id);
+      dismod_at::get_table_column(db, table_name, "col_var_id", col_var_id);
+      dismod_at::get_table_column(
+         db, table_name, table_name + "_value", hes_value
+      );
+      size_t nnz = hes_value.size();
+      vector<size_t> row(nnz), col(nnz);
+      for(size_t k = 0; k < nnz; ++k)
+      {  row[k] = size_t( row_var_id[k] );
+         col[k] = size_t( col_var_id[k] );
+         if( n_var <= row[k] || n_var <= col[k] )
+         {  string msg = "predict fit_var delta: var_id >= number of ";
+            msg       += "model variables";
+            dismod_at::error_exit(msg, table_name, k);
+         }
+      }
+      dismod_at::block_cholesky chol(n_var, row, col, hes_value);
+      if( ! chol.ok() )
+      {  string msg = "predict fit_var delta: the " + table_name;
+         msg       += " Hessian is not positive definite";
+         dismod_at::error_exit(msg);
+      }
+      return chol;
+   }
+   //
+   // delta method approximation for standard deviation of each prediction
+   CppAD::vector<double> delta_std(
+      sqlite3*                                  db            ,
+      const dismod_at::db_input_struct&         db_input      ,
+      const dismod_at::pack_info&               pack_object   ,
+      dismod_at::data_model&                    avgint_object ,
+      size_t                                    n_subset      ,
+      const CppAD::vector<double>&              pack_vec      ,
+      const dismod_at::pack_prior&              var2prior     )
+   {  using std::string;
+      using CppAD::vector;
+      typedef CppAD::sparse_rc< vector<size_t> >           sparsity_pattern;
+      typedef CppAD::sparse_rcv< vector<size_t>, vector<double> > sparse_matrix;
+      //
+      size_t n_var = pack_vec.size();
+      //
+      // fixed_chol, random_chol
+      dismod_at::block_cholesky fixed_chol =
+         hessian_factor(db, "hes_fixed", n_var);
+      dismod_at::block_cholesky random_chol =
+         hessian_factor(db, "hes_random", n_var);
+      //
+      // jac_scale
+      // derivative of model variables w.r.t. variables in Hessian space
+      vector<double> jac_scale(n_var);
+      for(size_t var_id = 0; var_id < n_var; ++var_id)
+         jac_scale[var_id] = 1.0;
+      vector<size_t> fixed2var = dismod_at::fixed2var_id(pack_object);
+      for(size_t j = 0; j < fixed2var.size(); ++j)
+      {  size_t var_id   = fixed2var[j];
+         size_t prior_id = var2prior.value_prior_id(var_id);
+         if( prior_id != DISMOD_AT_NULL_SIZE_T )
+         {  double eta = db_input.prior_table[prior_id].eta;
+            if( ! std::isnan(eta) )
+               jac_scale[var_id] = pack_vec[var_id] + eta;
+         }
+      }
+      //
+      // avg_fun
+      CppAD::vector<a1_double> a1_pack_vec(n_var), a1_avg(n_subset);
+      for(size_t var_id = 0; var_id < n_var; ++var_id)
+         a1_pack_vec[var_id] = pack_vec[var_id];
+      avgint_object.new_pack_vec();
+      CppAD::Independent(a1_pack_vec);
+      for(size_t k = 0; k < n_subset; ++k)
+      {  size_t subset_id = avgint_object.eval_order(k);
+         size_t first     = avgint_object.same_rectangle(subset_id);
+         if( first == subset_id )
+            a1_avg[subset_id] = avgint_object.average(subset_id, a1_pack_vec);
+         else
+            a1_avg[subset_id] = a1_avg[first];
+      }
+      CppAD::ADFun<double> avg_fun;
+      avg_fun.Dependent(a1_pack_vec, a1_avg);
+      //
+      // pattern_jac: sparsity pattern for the Jacobian
+      sparsity_pattern pattern_in(n_subset, n_subset, n_subset);
+      for(size_t k = 0; k < n_subset; ++k)
+         pattern_in.set(k, k, k);
+      bool dependency    = false;
+      bool internal_bool = false;
+      bool transpose     = false;
+      sparsity_pattern pattern_jac;
+      avg_fun.rev_jac_sparsity(
+         pattern_in, transpose, dependency, internal_bool, pattern_jac
+      );
+      //
+      // jac: the Jacobian
+      sparse_matrix jac(pattern_jac);
+      CppAD::sparse_jac_work work;
+      string coloring = "cppad";
+      avg_fun.sparse_jac_rev(pack_vec, jac, pattern_jac, coloring, work);
+      //
+      // result
+      vector<double> result(n_subset), g(n_var);
+      for(size_t var_id = 0; var_id < n_var; ++var_id)
+         g[var_id] = 0.0;
+      vector<size_t> row_major = jac.row_major();
+      size_t ell = 0;
+      for(size_t subset_id = 0; subset_id < n_subset; ++subset_id)
+      {  // g: gradient for this row in Hessian space
+         size_t start = ell;
+         while( ell < jac.nnz() && jac.row()[ row_major[ell] ] == subset_id )
+         {  size_t k      = row_major[ell++];
+            size_t var_id = jac.col()[k];
+            g[var_id]     = jac.val()[k] * jac_scale[var_id];
+         }
+         double variance   = fixed_chol.inv_quad(g) + random_chol.inv_quad(g);
+         result[subset_id] = std::sqrt(variance);
+         //
+         // g: back to zero
+         for(size_t m = start; m < ell; ++m)
+            g[ jac.col()[ row_major[m] ] ] = 0.0;
+      }
+      return result;
+   }
+} // END_EMPTY_NAMESPACE
+
 // ----------------------------------------------------------------------------
 void predict_command(
    const std::string&                                    source              ,
    bool                                                  zero_meas_value     ,
+   bool                                                  summary             ,
+   bool                                                  delta               ,
    sqlite3*                                              db                  ,
    const dismod_at::db_input_struct&                     db_input            ,
    const dismod_at::pack_info&                           pack_object         ,
@@ -121,6 +394,11 @@ void predict_command(
       msg        += "sample, fit_var, truth_var";
       dismod_at::error_exit(msg);
    }
+   if( delta && (source != "fit_var" || zero_meas_value || summary) )
+   {  string msg  = "dismod_at predict command: delta requires ";
+      msg        += "source = fit_var and no other optional arguments";
+      dismod_at::error_exit(msg);
+   }
    // ------------------------------------------------------------------------
    // n_var
    size_t n_var = pack_object.size();
@@ -138,9 +416,19 @@ void predict_command(
       column_name = "fit_var_value";
    else
       column_name = "truth_var_value";
-   dismod_at::get_table_column(
-      db, table_name, column_name, variable_value
-   );
+   bool compact = false;
+   if( source == "sample" )
+   {  vector<string> col_name = {"sample_index", "var_id", "var_value"};
+      vector<int>    index, position;
+      compact = dismod_at::get_compact_table(
+         db, table_name, col_name, index, position, variable_value
+      );
+   }
+   if( ! compact )
+   {  dismod_at::get_table_column(
+         db, table_name, column_name, variable_value
+      );
+   }
    size_t n_sample = variable_value.size() / n_var;
    assert( n_sample * n_var == variable_value.size() );
    //
@@ -218,41 +506,45 @@ void predict_command(
    }
 # endif
    // -----------------------------------------------------------------------
-   // create a new predict table
-   string sql_cmd = "drop table if exists predict";
-   dismod_at::exec_sql_cmd(db, sql_cmd);
-   //
-   table_name = "predict";
-   size_t n_col      = 3;
+   // n_subset
    size_t n_subset   = avgint_subset_obj.size();
-   size_t n_row      = n_sample * n_subset;
-   vector<string> col_name(n_col), col_type(n_col), row_value(n_col * n_row);
-   vector<bool>   col_unique(n_col);
    //
-   col_name[0]   = "sample_index";
-   col_type[0]   = "integer";
-   col_unique[0] = false;
+   // summary_vec
+   // accumulators used when summary is true
+   vector<double> prob(3);
+   prob[0] = 0.025;
+   prob[1] = 0.5;
+   prob[2] = 0.975;
+   std::vector<stream_summary> summary_vec;
+   if( summary )
+      summary_vec.resize(n_subset, stream_summary(prob) );
    //
-   col_name[1]   = "avgint_id";
-   col_type[1]   = "integer";
-   col_unique[1] = false;
+   // row_value
+   // predict table values used when summary is false
+   size_t n_col      = 3;
+   size_t n_row      = summary ? 0 : n_sample * n_subset;
+   vector<string> row_value(n_col * n_row);
    //
-   col_name[2]   = "avg_integrand";
-   col_type[2]   = "real";
-   col_unique[2] = false;
+   // avg_vec
+   // average integrand for each subset_id and the current sample
+   vector<double> avg_vec(n_subset);
    //
    size_t sample_id = 0;
    for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
    {  // copy the variable values for this sample index into pack_vec
       for(size_t var_id = 0; var_id < n_var; var_id++)
          pack_vec[var_id] = variable_value[sample_id++];
+      avgint_object.new_pack_vec();
       //
-      for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
-      {
-         int avgint_id  = avgint_subset_obj[subset_id].original_id;
-         double avg     = 0.0;
+      for(size_t k = 0; k < n_subset; k++)
+      {  size_t subset_id = avgint_object.eval_order(k);
+         int avgint_id    = avgint_subset_obj[subset_id].original_id;
+         size_t first     = avgint_object.same_rectangle(subset_id);
          try
-         {  avg = avgint_object.average(subset_id, pack_vec);
+         {  if( first == subset_id )
+               avg_vec[subset_id] = avgint_object.average(subset_id, pack_vec);
+            else
+               avg_vec[subset_id] = avg_vec[first];
          }
          catch(const std::exception& e)
          {  string message("predict_command: std::exception: ");
@@ -265,16 +557,101 @@ void predict_command(
             table_name        = "avgint";
             dismod_at::error_exit(message, table_name, avgint_id);
          }
+         double avg = avg_vec[subset_id];
          //
-         size_t predict_id = sample_index * n_subset + subset_id;
-         if( source == "sample" )
-            row_value[n_col * predict_id + 0] = to_string( sample_index );
+         if( summary )
+            summary_vec[subset_id].add(avg);
          else
-            row_value[n_col * predict_id + 0] = "";
-         row_value[n_col * predict_id + 1] = to_string( avgint_id );
-         row_value[n_col * predict_id + 2] = to_string( avg );
+         {  size_t predict_id = sample_index * n_subset + subset_id;
+            if( source == "sample" )
+               row_value[n_col * predict_id + 0] = to_string( sample_index );
+            else
+               row_value[n_col * predict_id + 0] = "";
+            row_value[n_col * predict_id + 1] = to_string( avgint_id );
+            row_value[n_col * predict_id + 2] = to_string( avg );
+         }
+      }
+   }
+   if( summary )
+   {  // create a new predict_summary table
+      string sql_cmd = "drop table if exists predict_summary";
+      dismod_at::exec_sql_cmd(db, sql_cmd);
+      //
+      table_name = "predict_summary";
+      n_col      = 7;
+      vector<string> col_name(n_col), col_type(n_col);
+      vector<bool>   col_unique(n_col);
+      col_name[0] = "avgint_id";
+      col_name[1] = "n_sample";
+      col_name[2] = "mean";
+      col_name[3] = "std";
+      col_name[4] = "lower";
+      col_name[5] = "median";
+      col_name[6] = "upper";
+      for(size_t j = 0; j < n_col; ++j)
+      {  col_type[j]   = j < 2 ? "integer" : "real";
+         col_unique[j] = j == 0;
+      }
+      row_value.resize(n_col * n_subset);
+      for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+      {  const stream_summary& sum = summary_vec[subset_id];
+         int avgint_id = avgint_subset_obj[subset_id].original_id;
+         row_value[n_col * subset_id + 0] = to_string( avgint_id );
+         row_value[n_col * subset_id + 1] = to_string( sum.n_value() );
+         row_value[n_col * subset_id + 2] = to_string( sum.mean() );
+         row_value[n_col * subset_id + 3] = to_string( sum.std_dev() );
+         row_value[n_col * subset_id + 4] = to_string( sum.quantile(0) );
+         row_value[n_col * subset_id + 5] = to_string( sum.quantile(1) );
+         row_value[n_col * subset_id + 6] = to_string( sum.quantile(2) );
+      }
+      dismod_at::create_table(
+         db, table_name, col_name, col_type, col_unique, row_value
+      );
+      return;
+   }
+   // avg_std
+   vector<double> avg_std;
+   if( delta )
+   {  assert( n_sample == 1 );
+      avg_std = delta_std(
+         db, db_input, pack_object, avgint_object, n_subset, pack_vec, var2prior
+      );
+      vector<string> delta_value(4 * n_row);
+      for(size_t predict_id = 0; predict_id < n_row; ++predict_id)
+      {  for(size_t j = 0; j < n_col; ++j)
+            delta_value[4 * predict_id + j] = row_value[n_col * predict_id + j];
+         delta_value[4 * predict_id + 3] = to_string( avg_std[predict_id] );
       }
+      n_col     = 4;
+      row_value.swap(delta_value);
    }
+   //
+   // create a new predict table
+   string sql_cmd = "drop table if exists predict";
+   dismod_at::exec_sql_cmd(db, sql_cmd);
+   //
+   table_name = "predict";
+   vector<string> col_name(n_col), col_type(n_col);
+   vector<bool>   col_unique(n_col);
+   //
+   col_name[0]   = "sample_index";
+   col_type[0]   = "integer";
+   col_unique[0] = false;
+   //
+   col_name[1]   = "avgint_id";
+   col_type[1]   = "integer";
+   col_unique[1] = false;
+   //
+   col_name[2]   = "avg_integrand";
+   col_type[2]   = "real";
+   col_unique[2] = false;
+   //
+   if( delta )
+   {  col_name[3]   = "avg_std";
+      col_type[3]   = "real";
+      col_unique[3] = false;
+   }
+   //
    dismod_at::create_table(
       db, table_name, col_name, col_type, col_unique, row_value
    );
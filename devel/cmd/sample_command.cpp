@@ -10,16 +10,22 @@
 # include <dismod_at/get_prior_sim_table.hpp>
 # include <dismod_at/fit_model.hpp>
 # include <dismod_at/create_table.hpp>
+# include <dismod_at/compact_table.hpp>
 # include <dismod_at/null_int.hpp>
 # include <dismod_at/get_var_limits.hpp>
 # include <dismod_at/remove_const.hpp>
 # include <dismod_at/get_str_map.hpp>
+# include <dismod_at/mcmc_diagnostic.hpp>
 
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 /*
 -------------------------------------------------------------------------------
 {xrst_begin sample_command}
+{xrst_spell
+  leapfrog
+  mcmc
+}
 
 The Sample Command
 ##################
@@ -45,7 +51,8 @@ from the posterior distribution; see
 method
 ******
 The sample command argument *method* must be
-``simulate`` , ``asymptotic`` or ``censor_asymptotic`` ; see discussion below:
+``simulate`` , ``asymptotic`` , ``censor_asymptotic`` or ``mcmc`` ;
+see discussion below:
 
 variables
 *********
@@ -67,7 +74,7 @@ in the previous simulate command.
 simulate_index
 **************
 If this argument is present, *method* must be
-``asymptotic`` or ``censor_asymptotic``
+``asymptotic`` , ``censor_asymptotic`` or ``mcmc``
 and *simulate_index* must be the same as in the corresponding
 :ref:`fit command<fit_command@simulate_index>` .
 
@@ -142,6 +149,47 @@ The covariance of the random effects is equal to the inverse of the
 Hessian of the random effect objective
 :ref:`sample_command@Output Tables@hes_fixed_table` .
 
+mcmc
+****
+If *method* is ``mcmc`` ,
+the :ref:`fit_var_table-name` is an additional input and
+it must correspond to the same fit as for the ``asymptotic`` method.
+The samples are draws from the posterior distribution for the
+fixed effects and the random effects jointly
+(the random effects are not integrated out using the Laplace approximation).
+This includes the Laplace density terms and the bounds for the variables.
+If *variables* is ``fixed`` , the random effects are zero
+(or equal to their limits when the limits are equal).
+
+Method
+======
+The draws are generated by static Hamiltonian Monte Carlo chains with a
+diagonal mass matrix, the step size adapted during warmup,
+and a random number of leapfrog steps for each trajectory
+(this is not the No-U-Turn sampler);
+see :ref:`option_table@Markov Chain Monte Carlo` .
+The variables are kept within their bounds by reflecting the trajectories
+at the bounds.
+The limits on age and time differences are not enforced.
+If there are zero sum constraints on the random effects and
+*variables* is ``both`` ,
+:ref:`option_table@Zero Sum Constraints@zero_sum_basis` must be true.
+
+Chains
+======
+The number of samples must be a multiple of
+:ref:`option_table@Markov Chain Monte Carlo@mcmc_number_chain` .
+Each chain generates *number_sample* / *mcmc_number_chain*
+consecutive values of :ref:`sample_table@sample_index` .
+The chains start at the values in the fit_var table.
+Each chain has its own random number generator and the corresponding
+seeds are determined by the :ref:`option_table@random_seed` ;
+hence the samples are reproducible.
+The chains are run in parallel using :ref:`option_table@number_thread`
+threads and the samples do not depend on the number of threads.
+The samples in one chain are not independent; see
+:ref:`sample_command@Output Tables@mcmc_diagnostic_table` .
+
 Extra Input Tables
 ******************
 
@@ -159,7 +207,7 @@ which was created by the previous :ref:`simulate_command-name` .
 
 fit_var_table
 =============
-If *method* is ``asymptotic`` or ``censor_asymptotic`` ,
+If *method* is ``asymptotic`` , ``censor_asymptotic`` or ``mcmc`` ,
 this command has the extra input :ref:`fit_var_table-name`
 which was created by a previous fit command which
 must have included :ref:`fit_command@variables@both`
@@ -195,6 +243,12 @@ hes_fixed_table
 A new :ref:`hes_fixed_table-name` is created each time this command is run
 with *method* equal to ``asymptotic`` or ``censor_asymptotic`` .
 The Hessian of the fixed effects objective is written in this table.
+The one exception is when
+:ref:`option_table@asymptotic_lanczos_step` is non-zero and there are
+no random effects (other than constants).
+In this case the fixed effects are sampled using Hessian vector products
+of the fixed likelihood, the Hessian is not formed,
+and the hes_fixed table is not created.
 If *simulate_index* is present (is not present) the Hessian corresponds
 to the simulated measurements in the :ref:`data_sim_table-name`
 (measurements in the :ref:`data_table-name` ).
@@ -209,6 +263,26 @@ If *simulate_index* is present (is not present) the Hessian corresponds
 to the simulated measurements in the :ref:`data_sim_table-name`
 (measurements in the :ref:`data_table-name` ).
 
+mcmc_diagnostic_table
+=====================
+If *method* is ``mcmc`` ,
+a new ``mcmc_diagnostic`` table is created each time this command is run.
+(Otherwise the mcmc_diagnostic table is removed if it exists.)
+It has the following columns:
+*diagnostic_name* (text), *chain_id* (integer), *var_id* (integer),
+and *diagnostic_value* (real).
+For each chain there is a row with *diagnostic_name*
+``acceptance_rate`` (the average acceptance probability after warmup)
+and a row with *diagnostic_name* ``step_size``
+(the leapfrog step size after warmup).
+The *var_id* is null for these rows.
+For each :ref:`var_table@var_id` there is a row with
+*diagnostic_name* ``r_hat`` (the split potential scale reduction factor)
+and a row with *diagnostic_name* ``ess`` (the effective sample size);
+see :ref:`mcmc_diagnostic-name` .
+The *chain_id* is null for these rows and the *diagnostic_value*
+is null for variables that are constant.
+
 Bounds
 ******
 If you use the ``simulate`` method,
@@ -218,6 +292,8 @@ on the random effects specified by
 If you use the ``asymptotic`` method,
 the only bounds that are enforced are where the upper and lower limits
 are equal.
+If you use the ``mcmc`` method,
+all the samples are within the specified bounds.
 {xrst_toc_hidden
    example/get_started/sample_command.py
 }
@@ -253,10 +329,11 @@ void sample_command(
    // -------------------------------------------------------------------
    if( method != "simulate"
    && method != "asymptotic"
-   && method != "censor_asymptotic" )
+   && method != "censor_asymptotic"
+   && method != "mcmc" )
    {  msg  = "dismod_at sample command method = ";
       msg += method + " is not one of the following: ";
-      msg += "simulate, asymptotic, censor_asymptotic";
+      msg += "simulate, asymptotic, censor_asymptotic, mcmc";
       dismod_at::error_exit(msg);
    }
    if( variables != "fixed" && variables != "both" )
@@ -272,29 +349,46 @@ void sample_command(
       dismod_at::error_exit(msg);
    }
    size_t n_sample = size_t(tmp);
+   if( method == "mcmc" )
+   {  string n_chain = get_str_map(option_map, "mcmc_number_chain");
+      if( n_sample % size_t( std::atoi( n_chain.c_str() ) ) != 0 )
+      {  msg  = "dismod_at sample command method = mcmc and ";
+         msg += "number_sample = " + number_sample + " is not a multiple";
+         msg += " of mcmc_number_chain = " + n_chain;
+         dismod_at::error_exit(msg);
+      }
+      bool zero_sum = get_str_map(option_map, "zero_sum_child_rate") != "";
+      zero_sum |= get_str_map(option_map, "zero_sum_mulcov_group") != "";
+      zero_sum &= get_str_map(option_map, "zero_sum_basis") != "true";
+      if( variables == "both" && zero_sum )
+      {  msg  = "dismod_at sample command method = mcmc, ";
+         msg += "there are zero sum constraints, and zero_sum_basis is false";
+         dismod_at::error_exit(msg);
+      }
+   }
    // -----------------------------------------------------------------------
    // create new sample table and prepare to write into it
    //
    string sql_cmd = "drop table if exists sample";
    dismod_at::exec_sql_cmd(db, sql_cmd);
+   sql_cmd = "drop table if exists sample_blob";
+   dismod_at::exec_sql_cmd(db, sql_cmd);
+   sql_cmd = "drop table if exists mcmc_diagnostic";
+   dismod_at::exec_sql_cmd(db, sql_cmd);
    //
    size_t n_col      = 3;
    size_t n_var      = pack_object.size();
    size_t n_row      = n_sample * n_var;
-   vector<string> col_name(n_col), col_type(n_col), row_value(n_col * n_row);
+   vector<string> col_name(n_col), col_type(n_col), row_value;
    vector<bool>   col_unique(n_col);
    //
-   col_name[0]   = "sample_index";
-   col_type[0]   = "integer";
-   col_unique[0] = false;
+   // storage_format, sample_col_name
+   string storage_format = get_str_map(option_map, "storage_format");
+   vector<string> sample_col_name = {"sample_index", "var_id", "var_value"};
    //
-   col_name[1]   = "var_id";
-   col_type[1]   = "integer";
-   col_unique[1] = false;
-   //
-   col_name[2]   = "var_value";
-   col_type[2]   = "real";
-   col_unique[2] = false;
+   // sample_value
+   // value for each (sample_index, var_id) pair in the sample table
+   vector<double> sample_value(n_row);
    // -----------------------------------------------------------------------
    // zero_sum_child_rate
    size_t n_rate      = size_t(dismod_at::number_rate_enum);
@@ -323,6 +417,8 @@ void sample_command(
    // ----------------------------------------------------------------------
    // quasi_fixed
    bool quasi_fixed = get_str_map(option_map, "quasi_fixed") == "true";
+   bool zero_sum_basis =
+      get_str_map(option_map, "zero_sum_basis") == "true";
    //
    // trace_init
    bool trace_init =
@@ -529,6 +625,7 @@ void sample_command(
             quasi_fixed          ,
             zero_sum_child_rate  ,
             zero_sum_mulcov_group,
+            zero_sum_basis       ,
             data_object          ,
             trace_init
          );
@@ -544,15 +641,11 @@ void sample_command(
          );
          assert( opt_value.size() == n_var );
          //
-         // solution for fixed effects and this sample_index -> row_value
-         string sample_index_str = to_string( sample_index );
+         // solution for fixed effects and this sample_index -> sample_value
          for(size_t var_id = 0; var_id < n_var; var_id++)
          if( ! is_random_effect[var_id] )
          {  size_t sample_id = sample_index * n_var + var_id;
-            row_value[n_col * sample_id + 0] = sample_index_str;
-            row_value[n_col * sample_id + 1] = to_string( var_id );
-            row_value[n_col * sample_id + 2] =
-               to_string(opt_value[var_id] );
+            sample_value[sample_id] = opt_value[var_id];
          }
          // --------------------------------------------------------------
          // estimate random effects for this sample_index
@@ -595,6 +688,7 @@ void sample_command(
             quasi_fixed          ,
             zero_sum_child_rate  ,
             zero_sum_mulcov_group,
+            zero_sum_basis       ,
             data_object          ,
             trace_init
          );
@@ -607,24 +701,24 @@ void sample_command(
          opt_value, lag_value, lag_dage, lag_dtime, trace_vec, warm_start_2
          );
          //
-         // solution for random effects and this sample_index -> row_value
+         // solution for random effects and this sample_index -> sample_value
          for(size_t var_id = 0; var_id < n_var; var_id++)
          if( is_random_effect[var_id] )
          {  size_t sample_id = sample_index * n_var + var_id;
-            row_value[n_col * sample_id + 0] = sample_index_str;
-            row_value[n_col * sample_id + 1] = to_string( var_id );
-            row_value[n_col * sample_id + 2] =
-               to_string(opt_value[var_id] );
+            sample_value[sample_id] = opt_value[var_id];
          }
       }
       table_name = "sample";
-      dismod_at::create_table(
-         db, table_name, col_name, col_type, col_unique, row_value
+      dismod_at::put_compact_table(
+         db, storage_format, table_name, sample_col_name, n_sample, sample_value
       );
       return;
    }
    // ----------------------------------------------------------------------
-   assert( method == "asymptotic" || method == "censor_asymptotic" );
+   assert( method == "asymptotic"
+      || method == "censor_asymptotic"
+      || method == "mcmc"
+   );
    //
    sql_cmd = "drop table if exists hes_fixed";
    dismod_at::exec_sql_cmd(db, sql_cmd);
@@ -690,9 +784,104 @@ void sample_command(
       quasi_fixed          ,
       zero_sum_child_rate  ,
       zero_sum_mulcov_group,
+      zero_sum_basis       ,
       data_object          ,
       trace_init
    );
+   // ----------------------------------------------------------------------
+   if( method == "mcmc" )
+   {  // sample_out, acceptance_out, step_size_out
+      vector<double> sample_out, acceptance_out, step_size_out;
+      fit_object.sample_mcmc(
+         n_sample             ,
+         sample_out           ,
+         acceptance_out       ,
+         step_size_out        ,
+         fit_var_value        ,
+         option_map
+      );
+      if( sample_out.size() == 0 )
+      {  msg = "sample_command: sample table was not created";
+         dismod_at::error_exit(msg);
+      }
+      assert( sample_out.size() == n_sample * n_var );
+      //
+      // sample table
+      for(size_t sample_id = 0; sample_id < n_row; ++sample_id)
+         sample_value[sample_id] = sample_out[sample_id];
+      table_name = "sample";
+      dismod_at::put_compact_table(
+         db, storage_format, table_name, sample_col_name, n_sample, sample_value
+      );
+      //
+      // mcmc_diagnostic table
+      size_t n_chain = acceptance_out.size();
+      n_col          = 4;
+      n_row          = 2 * n_chain + 2 * n_var;
+      col_name.resize(n_col);
+      col_type.resize(n_col);
+      col_unique.resize(n_col);
+      row_value.resize(n_col * n_row);
+      //
+      col_name[0]   = "diagnostic_name";
+      col_type[0]   = "text";
+      col_unique[0] = false;
+      //
+      col_name[1]   = "chain_id";
+      col_type[1]   = "integer";
+      col_unique[1] = false;
+      //
+      col_name[2]   = "var_id";
+      col_type[2]   = "integer";
+      col_unique[2] = false;
+      //
+      col_name[3]   = "diagnostic_value";
+      col_type[3]   = "real";
+      col_unique[3] = false;
+      //
+      // empty corresponds to null in database
+      size_t row = 0;
+      for(size_t chain_id = 0; chain_id < n_chain; ++chain_id)
+      {  row_value[n_col * row + 0] = "acceptance_rate";
+         row_value[n_col * row + 1] = to_string(chain_id);
+         row_value[n_col * row + 2] = "";
+         row_value[n_col * row + 3] = to_string( acceptance_out[chain_id] );
+         ++row;
+         row_value[n_col * row + 0] = "step_size";
+         row_value[n_col * row + 1] = to_string(chain_id);
+         row_value[n_col * row + 2] = "";
+         row_value[n_col * row + 3] = to_string( step_size_out[chain_id] );
+         ++row;
+      }
+      vector<double> draw(n_sample);
+      for(size_t var_id = 0; var_id < n_var; ++var_id)
+      {  for(size_t sample_index = 0; sample_index < n_sample; ++sample_index)
+            draw[sample_index] = sample_out[sample_index * n_var + var_id];
+         double r_hat, ess;
+         dismod_at::mcmc_diagnostic(n_chain, draw, r_hat, ess);
+         //
+         row_value[n_col * row + 0] = "r_hat";
+         row_value[n_col * row + 1] = "";
+         row_value[n_col * row + 2] = to_string(var_id);
+         row_value[n_col * row + 3] = "";
+         if( ! std::isnan(r_hat) )
+            row_value[n_col * row + 3] = to_string(r_hat);
+         ++row;
+         row_value[n_col * row + 0] = "ess";
+         row_value[n_col * row + 1] = "";
+         row_value[n_col * row + 2] = to_string(var_id);
+         row_value[n_col * row + 3] = "";
+         if( ! std::isnan(ess) )
+            row_value[n_col * row + 3] = to_string(ess);
+         ++row;
+      }
+      assert( row == n_row );
+      table_name = "mcmc_diagnostic";
+      dismod_at::create_table(
+         db, table_name, col_name, col_type, col_unique, row_value
+      );
+      return;
+   }
    //
    // hes_fixed_obj_out, hes_random_obj_out, sample_out
    CppAD::mixed::d_sparse_rcv hes_fixed_obj_out, hes_random_obj_out;
@@ -706,64 +895,64 @@ void sample_command(
       option_map
    );
    // ----------------------------------------------------------------------
-   // Create sample table first so we can use create_table settings above.
+   // Create sample table first.
    // If sample_out.size() is zero, we will report the error at the end.
    if( sample_out.size() != 0 )
    {  assert( sample_out.size() == n_sample * n_var );
       for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
-      {  string sample_index_str = to_string( sample_index );
-         for(size_t var_id = 0; var_id < n_var; var_id++)
+      {  for(size_t var_id = 0; var_id < n_var; var_id++)
          {  size_t sample_id = sample_index * n_var + var_id;
-            row_value[n_col * sample_id + 0] = sample_index_str;
-            row_value[n_col * sample_id + 1] = to_string( var_id );
             //
             double var_value = sample_out[ sample_index * n_var + var_id];
             if( method == "censor_asymptotic" )
             {  var_value        = std::max(var_value, var_lower[var_id] );
                var_value        = std::min(var_value, var_upper[var_id] );
             }
-            row_value[n_col * sample_id + 2] = to_string(var_value);
+            sample_value[sample_id] = var_value;
          }
       }
       table_name = "sample";
-      dismod_at::create_table(
-         db, table_name, col_name, col_type, col_unique, row_value
+      dismod_at::put_compact_table(
+         db, storage_format, table_name, sample_col_name, n_sample, sample_value
       );
    }
    // ----------------------------------------------------------------------
    // create hes_fixed table
-   n_col         = 3;
-   n_row         = hes_fixed_obj_out.nnz();
-   col_name.resize(n_col);
-   col_type.resize(n_col);
-   row_value.resize(n_col * n_row);
-   //
-   col_name[0]   = "row_var_id";
-   col_type[0]   = "integer";
-   col_unique[0] = false;
-   //
-   col_name[1]   = "col_var_id";
-   col_type[1]   = "integer";
-   col_unique[1] = false;
-   //
-   col_name[2]   = "hes_fixed_value";
-   col_type[2]   = "integer";
-   col_unique[2] = false;
-   //
-   CppAD::mixed::s_vector row_major = hes_fixed_obj_out.row_major();
-   for(size_t k = 0; k < n_row; ++k)
-   {  size_t ell             = row_major[k];
-      size_t row_var_id      = hes_fixed_obj_out.row()[ell];
-      size_t col_var_id      = hes_fixed_obj_out.col()[ell];
-      double hes_fixed_value = hes_fixed_obj_out.val()[ell];
-      row_value[n_col * k + 0] = to_string(row_var_id);
-      row_value[n_col * k + 1] = to_string(col_var_id);
-      row_value[n_col * k + 2] = to_string(hes_fixed_value);
+   // (not created when the Hessian was not formed by sample_posterior)
+   if( hes_fixed_obj_out.nr() != 0 )
+   {  n_col         = 3;
+      n_row         = hes_fixed_obj_out.nnz();
+      col_name.resize(n_col);
+      col_type.resize(n_col);
+      row_value.resize(n_col * n_row);
+      //
+      col_name[0]   = "row_var_id";
+      col_type[0]   = "integer";
+      col_unique[0] = false;
+      //
+      col_name[1]   = "col_var_id";
+      col_type[1]   = "integer";
+      col_unique[1] = false;
+      //
+      col_name[2]   = "hes_fixed_value";
+      col_type[2]   = "integer";
+      col_unique[2] = false;
+      //
+      CppAD::mixed::s_vector row_major = hes_fixed_obj_out.row_major();
+      for(size_t k = 0; k < n_row; ++k)
+      {  size_t ell             = row_major[k];
+         size_t row_var_id      = hes_fixed_obj_out.row()[ell];
+         size_t col_var_id      = hes_fixed_obj_out.col()[ell];
+         double hes_fixed_value = hes_fixed_obj_out.val()[ell];
+         row_value[n_col * k + 0] = to_string(row_var_id);
+         row_value[n_col * k + 1] = to_string(col_var_id);
+         row_value[n_col * k + 2] = to_string(hes_fixed_value);
+      }
+      table_name = "hes_fixed";
+      dismod_at::create_table(
+         db, table_name, col_name, col_type, col_unique, row_value
+      );
    }
-   table_name = "hes_fixed";
-   dismod_at::create_table(
-      db, table_name, col_name, col_type, col_unique, row_value
-   );
    // ----------------------------------------------------------------------
    // create hes_random table
    n_col         = 3;
@@ -784,9 +973,7 @@ void sample_command(
    col_type[2]   = "integer";
    col_unique[2] = false;
    //
-   // re-size to zero to avoid error on assignment
-   row_major.resize(0);
-   row_major = hes_random_obj_out.row_major();
+   CppAD::mixed::s_vector row_major = hes_random_obj_out.row_major();
    for(size_t k = 0; k < n_row; ++k)
    {  size_t ell              = row_major[k];
       size_t row_var_id       = hes_random_obj_out.row()[ell];
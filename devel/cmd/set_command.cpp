@@ -8,6 +8,7 @@
 # include <dismod_at/exec_sql_cmd.hpp>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/get_table_column.hpp>
+# include <dismod_at/compact_table.hpp>
 # include <cppad/utility/to_string.hpp>
 # include <dismod_at/create_table.hpp>
 
@@ -330,10 +331,17 @@ void set_command(
       // var_value
       vector<double> var_value;
       string table_name_in  = "sample";
-      string column_name    = "var_value";
-      get_table_column(
-         db, table_name_in, column_name, var_value
+      vector<string> col_name_in = {"sample_index", "var_id", "var_value"};
+      vector<int>    index_in, position_in;
+      bool compact = get_compact_table(
+         db, table_name_in, col_name_in, index_in, position_in, var_value
       );
+      if( ! compact )
+      {  string column_name = "var_value";
+         get_table_column(
+            db, table_name_in, column_name, var_value
+         );
+      }
       // n_sample
       if( var_value.size() % n_var != 0 )
       {  msg  = "sample table size not a multiple of number of variables";
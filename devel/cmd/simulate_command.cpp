@@ -8,6 +8,7 @@
 # include <dismod_at/get_table_column.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
 # include <dismod_at/create_table.hpp>
+# include <dismod_at/compact_table.hpp>
 # include <dismod_at/sim_random.hpp>
 # include <dismod_at/null_int.hpp>
 # include <dismod_at/get_density_table.hpp>
@@ -114,32 +115,39 @@ void simulate_command(
    // ----------------- data_sim_table ----------------------------------
    string sql_cmd = "drop table if exists data_sim";
    exec_sql_cmd(db, sql_cmd);
+   sql_cmd = "drop table if exists data_sim_blob";
+   exec_sql_cmd(db, sql_cmd);
    //
    table_name      = "data_sim";
    size_t n_col    = 3;
    size_t n_subset = subset_data_obj.size();
    size_t n_row    = n_simulate * n_subset;
-   vector<string> col_name(n_col), col_type(n_col), row_value(n_col * n_row);
+   vector<string> col_name(n_col), col_type(n_col), row_value;
    vector<bool>   col_unique(n_col);
    //
    col_name[0]   = "simulate_index";
-   col_type[0]   = "integer";
-   col_unique[0] = false;
-   //
    col_name[1]   = "data_subset_id";
-   col_type[1]   = "integer";
-   col_unique[1] = false;
-   //
    col_name[2]   = "data_sim_value";
-   col_type[2]   = "real";
-   col_unique[2] = false;
+   //
+   // storage_format
+   string storage_format = option_map["storage_format"];
+   //
+   // data_sim_value
+   // value for each (simulate_index, data_subset_id) pair in data_sim table
+   vector<double> data_sim_value(n_row);
+   //
+   // compute the average integrand and adjusted standard deviation
+   // for all the data
+   CppAD::vector<double> avg_vec, delta_vec;
+   CppAD::vector< residual_struct<double> > residual_vec;
+   data_object.average_all(truth_var, avg_vec, delta_vec, residual_vec);
    //
    // for each measurement in the data_subset table
    for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
    {
       //
-      // compute the average integrand, avg
-      double avg = data_object.average(subset_id, truth_var);
+      // the average integrand, avg
+      double avg = avg_vec[subset_id];
       //
       // density corresponding to this data point
       density_enum density = subset_data_obj[subset_id].density;
@@ -157,8 +165,7 @@ void simulate_command(
       double nu           = subset_data_obj[subset_id].nu;
       //
       // data table adjusted standard deviation, delta
-      double delta;
-      data_object.like_one(subset_id, truth_var, avg, delta);
+      double delta = delta_vec[subset_id];
       //
       for(size_t sim_index = 0; sim_index < n_simulate; sim_index++)
       {  // for each simulate_index
@@ -167,13 +174,11 @@ void simulate_command(
          double sim_value   = sim_random(density, avg, delta, eta, nu);
          //
          size_t data_sim_id = sim_index * n_subset + subset_id;
-         row_value[data_sim_id * n_col + 0] = to_string( sim_index );
-         row_value[data_sim_id * n_col + 1] = to_string( subset_id );
-         row_value[data_sim_id * n_col + 2] = to_string( sim_value );
+         data_sim_value[data_sim_id] = sim_value;
       }
    }
-   create_table(
-      db, table_name, col_name, col_type, col_unique, row_value
+   put_compact_table(
+      db, storage_format, table_name, col_name, n_simulate, data_sim_value
    );
    // ----------------- prior_sim_table ----------------------------------
    sql_cmd = "drop table if exists prior_sim";
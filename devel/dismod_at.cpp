@@ -7,6 +7,7 @@
 # include <cassert>
 # include <string>
 # include <filesystem>
+# include <memory>
 
 # include <cppad/utility/vector.hpp>
 # include <cppad/mixed/exception.hpp>
@@ -43,10 +44,12 @@
 # include <dismod_at/hold_out_command.hpp>
 # include <dismod_at/init_command.hpp>
 # include <dismod_at/log_message.hpp>
+# include <dismod_at/memory_connection.hpp>
 # include <dismod_at/min_max_vector.hpp>
 # include <dismod_at/null_int.hpp>
 # include <dismod_at/old2new_command.hpp>
 # include <dismod_at/open_connection.hpp>
+# include <dismod_at/sqlite_profile.hpp>
 # include <dismod_at/pack_info.hpp>
 # include <dismod_at/pack_prior.hpp>
 # include <dismod_at/predict_command.hpp>
@@ -54,6 +57,7 @@
 # include <dismod_at/set_command.hpp>
 # include <dismod_at/sim_random.hpp>
 # include <dismod_at/simulate_command.hpp>
+# include <dismod_at/split_space.hpp>
 // END_SORT_THIS_LINE_MINUS_1
 
 # define DISMOD_AT_TRACE 0
@@ -93,6 +97,7 @@ int main(int n_arg, const char** argv)
       {"old2new",      3},
       {"predict",      4},
       {"predict",      5},
+      {"predict",      6},
       {"sample",       6},
       {"sample",       7},
       {"set",          5},
@@ -190,6 +195,23 @@ int main(int n_arg, const char** argv)
    database_path.remove_filename();
    if( ! database_path.empty() )
       std::filesystem::current_path( database_path );
+   // --------------- memory_database ---------------------------------------
+   // Switch to the in memory copy before logging the start of this command
+   // so that none of the changes made by the command are in the file until
+   // it is done. The old2new command must fix the database first.
+   bool memory_database = false;
+   if( command_arg != "old2new" )
+   {  CppAD::vector<dismod_at::option_struct> option_table =
+         dismod_at::get_option_table(db);
+      for(size_t id = 0; id < option_table.size(); ++id)
+      {  if( option_table[id].option_name == "memory_database" )
+            memory_database = option_table[id].option_value == "true";
+      }
+   }
+   if( memory_database )
+   {  db = dismod_at::open_memory_connection(db);
+      dismod_at::error_exit(db);
+   }
    // --------------- log start of this command -----------------------------
    message = "begin";
    for(int i_arg = 2; i_arg < n_arg; i_arg++)
@@ -204,7 +226,7 @@ int main(int n_arg, const char** argv)
    {  dismod_at::old2new_command(db);
       message = "end " + command_arg;
       dismod_at::log_message(db, DISMOD_AT_NULL_PTR, "command", message);
-      sqlite3_close(db);
+      dismod_at::close_connection(db);
       return 0;
    }
    // ----------------------------------------------------------------------
@@ -224,7 +246,7 @@ int main(int n_arg, const char** argv)
       //
       message = "end " + command_arg;
       dismod_at::log_message(db, DISMOD_AT_NULL_PTR, "command", message);
-      sqlite3_close(db);
+      dismod_at::close_connection(db);
       return 0;
    }
    // --------------- get the input tables ---------------------------------
@@ -240,9 +262,27 @@ int main(int n_arg, const char** argv)
       option_map[name] = value;
    }
    // ---------------------------------------------------------------------
+   // sqlite_profile
+   // (the default profile safe does not change any settings and the
+   // settings have no effect on an in memory copy of the database)
+   if( option_map["sqlite_profile"] != "safe" && ! memory_database )
+   {  message = dismod_at::sqlite_profile(db, option_map["sqlite_profile"]);
+      dismod_at::log_message(db, DISMOD_AT_NULL_PTR, "value", message);
+   }
+   //
+   // hold warnings until the next command or error message
+   dismod_at::log_buffer(db, true);
+   // ---------------------------------------------------------------------
    // ode_step_size
    double ode_step_size  = std::atof( option_map["ode_step_size"].c_str() );
    assert( ode_step_size > 0.0 );
+   //
+   // ode_lexis_grid
+   bool ode_lexis_grid = option_map["ode_lexis_grid"] == "true";
+   //
+   // number_thread
+   size_t number_thread = std::atoi( option_map["number_thread"].c_str() );
+   assert( number_thread > 0 );
    // ---------------------------------------------------------------------
    // initialize random number generator
    size_t random_seed = std::atoi( option_map["random_seed"].c_str() );
@@ -444,13 +484,15 @@ int main(int n_arg, const char** argv)
    {  if( n_arg == 5 )
          fit_simulated_data = string(argv[4]) != "warm_start";
       if( n_arg == 6 )
-         fit_simulated_data = true;
+         fit_simulated_data = string(argv[4]) != "multistart";
    }
    if( command_arg == "sample" )
    {  if( std::strcmp(argv[3], "simulate") == 0 )
          fit_simulated_data = true;
       if( std::strcmp(argv[3], "asymptotic") == 0 && n_arg == 7 )
          fit_simulated_data = true;
+      if( std::strcmp(argv[3], "mcmc") == 0 && n_arg == 7 )
+         fit_simulated_data = true;
    }
    //
    // cov2weight_obj
@@ -629,21 +671,32 @@ int main(int n_arg, const char** argv)
          pack_object              ,
          child_info4avgint
       );
+      avgint_object.set_ode_lexis_grid( ode_lexis_grid );
       //
       std::string source   = argv[3];
       bool zero_meas_value = false;
-      if( n_arg > 4 )
-      {  string argv_4 = argv[4];
-         if( strcmp(argv[4], "zero_meas_value") != 0 )
-         {  message  = "dismod_at database predict " + source + " " + argv_4;
-            message += "\nexpected " + argv_4 + " to be zero_meas_value\n";
+      bool summary         = false;
+      bool delta           = false;
+      for(int i = 4; i < n_arg; ++i)
+      {  string argv_i = argv[i];
+         if( argv_i == "zero_meas_value" && ! zero_meas_value )
+            zero_meas_value = true;
+         else if( argv_i == "summary" && ! summary )
+            summary = true;
+         else if( argv_i == "delta" && ! delta )
+            delta = true;
+         else
+         {  message  = "dismod_at database predict " + source + " " + argv_i;
+            message += "\nexpected " + argv_i;
+            message += " to be zero_meas_value, summary, or delta\n";
             dismod_at::error_exit(message);
          }
-         zero_meas_value = true;
       }
       dismod_at::predict_command(
          source               ,
          zero_meas_value      ,
+         summary              ,
+         delta                ,
          db                   ,
          db_input             ,
          pack_object          ,
@@ -711,30 +764,46 @@ int main(int n_arg, const char** argv)
             db_input.weight_grid_table
          );
       }
+      // new_data_model
+      // a data model that uses the specified ode step size and age grid
+      auto new_data_model = [&](
+         double step_size, const vector<double>& avg_grid
+      ) -> dismod_at::data_model*
+      {  dismod_at::data_model* result = new dismod_at::data_model(
+            cov2weight_obj           ,
+            n_covariate              ,
+            fit_simulated_data       ,
+            meas_noise_effect        ,
+            rate_case                ,
+            bound_random             ,
+            step_size                ,
+            avg_grid                 ,
+            db_input.age_table       ,
+            db_input.time_table      ,
+            db_input.covariate_table ,
+            db_input.subgroup_table  ,
+            db_input.integrand_table ,
+            db_input.mulcov_table    ,
+            db_input.prior_table     ,
+            subset_data_obj          ,
+            subset_data_cov_value    ,
+            w_info_vec               ,
+            s_info_vec               ,
+            pack_object              ,
+            child_info4data
+         );
+         result->set_ode_lexis_grid( ode_lexis_grid );
+         result->set_number_thread( number_thread );
+         result->set_aggregate_data(
+            option_map["aggregate_data"] == "true"
+         );
+         return result;
+      };
       // data_object
-      dismod_at::data_model data_object(
-         cov2weight_obj           ,
-         n_covariate              ,
-         fit_simulated_data       ,
-         meas_noise_effect        ,
-         rate_case                ,
-         bound_random             ,
-         ode_step_size            ,
-         age_avg_grid             ,
-         db_input.age_table       ,
-         db_input.time_table      ,
-         db_input.covariate_table ,
-         db_input.subgroup_table  ,
-         db_input.integrand_table ,
-         db_input.mulcov_table    ,
-         db_input.prior_table     ,
-         subset_data_obj          ,
-         subset_data_cov_value    ,
-         w_info_vec               ,
-         s_info_vec               ,
-         pack_object              ,
-         child_info4data
+      std::unique_ptr<dismod_at::data_model> data_ptr(
+         new_data_model(ode_step_size, age_avg_grid)
       );
+      dismod_at::data_model& data_object( *data_ptr );
       //
       if( command_arg == "depend" )
       {  depend_command(
@@ -749,13 +818,23 @@ int main(int n_arg, const char** argv)
       {  string variables      = argv[3];
          string simulate_index = "";
          bool   use_warm_start = false;
+         size_t number_start   = 1;
          if( n_arg == 5 )
          {  if( string( argv[4] ) == "warm_start" )
                use_warm_start = true;
             else
                simulate_index = argv[4];
          }
-         if( n_arg == 6 )
+         if( n_arg == 6 && string( argv[4] ) == "multistart" )
+         {  int tmp = std::atoi( argv[5] );
+            if( tmp <= 0 )
+            {  message  = "dismod_at fit command: number_start = ";
+               message += string( argv[5] ) + " is not a positive integer";
+               dismod_at::error_exit(message);
+            }
+            number_start = size_t(tmp);
+         }
+         else if( n_arg == 6 )
          {  simulate_index = argv[4];
             use_warm_start = string( argv[5] ) == "warm_start";
             if( ! use_warm_start )
@@ -763,13 +842,37 @@ int main(int n_arg, const char** argv)
                dismod_at::error_exit(message);
             }
          }
+         // stage_step_size
+         // ode_step_schedule stages that are run before the final fit
+         vector<double> stage_step_size;
+         bool use_schedule = variables != "random";
+         use_schedule     &= ! use_warm_start && number_start == 1;
+         if( use_schedule )
+         {  vector<string> schedule =
+               dismod_at::split_space( option_map["ode_step_schedule"] );
+            size_t n_stage = schedule.size();
+            stage_step_size.resize(n_stage);
+            for(size_t stage = 0; stage < n_stage; ++stage)
+               stage_step_size[stage] = std::atof( schedule[stage].c_str() );
+         }
+         // new_stage_model
+         // data model for one stage; fit_command frees it when the stage ends
+         auto new_stage_model = [&](double step_size)
+         {  vector<double> avg_grid = dismod_at::age_avg_grid(
+               step_size, age_avg_split, db_input.age_table
+            );
+            return new_data_model(step_size, avg_grid);
+         };
          fit_command(
             use_warm_start   ,
+            number_start     ,
             variables        ,
             simulate_index   ,
             db               ,
             subset_data_obj  ,
             data_object      , // not  const
+            stage_step_size  ,
+            new_stage_model  ,
             prior_object     , // not  const
             pack_object      ,
             var2prior        ,
@@ -838,6 +941,7 @@ int main(int n_arg, const char** argv)
    // ---------------------------------------------------------------------
    message = "end " + command_arg;
    dismod_at::log_message(db, DISMOD_AT_NULL_PTR, "command", message);
-   sqlite3_close(db);
+   dismod_at::log_buffer(db, false);
+   dismod_at::close_connection(db);
    return 0;
 }
@@ -9,6 +9,7 @@
 # include <dismod_at/grid2line.hpp>
 # include <dismod_at/cohort_ode.hpp>
 # include <dismod_at/cohort_ode.hpp>
+# include <dismod_at/ode2_checkpoint.hpp>
 # include <dismod_at/get_integrand_table.hpp>
 # include <dismod_at/get_subgroup_table.hpp>
 
@@ -53,6 +54,22 @@ Syntax
 | |tab| *x* ,
 | |tab| *pack_vec*
 | )
+| *adj_line* = *adjint_obj* . ``line`` (
+| |tab| *node_id* ,
+| |tab| *line_age* ,
+| |tab| *line_time* ,
+| |tab| *integrand_id* ,
+| |tab| *n_child* ,
+| |tab| *child* ,
+| |tab| *subgroup_id* ,
+| |tab| *x* ,
+| |tab| *a1_x* ,
+| |tab| *pack_vec*
+| )
+| *adjint_obj* . ``depend`` (
+| |tab| *integrand_id* , *n_child* , *child* , *subgroup_id* ,
+| |tab| *pack_index* , *covariate_index*
+| )
 
 Prototype
 *********
@@ -194,6 +211,11 @@ subgroup_id
 is the :ref:`avgint_table@subgroup_id` corresponding
 to this adjustment of the integrand.
 
+x
+*
+is the vector of covariate values, relative to their
+:ref:`covariate_table@reference` , for this adjustment.
+
 pack_vec
 ********
 is all the :ref:`model_variables-name` in the order
@@ -204,6 +226,32 @@ Float
 The type *Float* must be ``double`` or
 :ref:`a1_double-name` .
 
+a1_x
+****
+If this argument is present, it has the same type as *pack_vec* ,
+the same size as *x* ,
+and it is used in place of *x* when multiplying covariate values by
+covariate multipliers; i.e., the covariate values can be variables
+in the tape being recorded.
+The ``double`` values in *x* are still used to choose the
+:ref:`cov2weight_map-name` weighting for the covariates.
+This is used to record one function for many data points;
+see :ref:`data_model_record_checkpoint-name` .
+
+depend
+******
+This ``const`` member function determines the components of
+*pack_vec* and *x* that the adjusted integrand can depend on;
+i.e., the other components do not affect the value of *adj_line*
+for any *node_id* , *line_age* , *line_time* , or value of *pack_vec* .
+The arguments *integrand_id* , *n_child* , *child* , *subgroup_id*
+have the same meaning as for ``line`` .
+The input size and value of *pack_index* and *covariate_index*
+do not matter.
+Upon return, *pack_index* ( *covariate_index* ) is a monotone increasing
+vector containing the indices in *pack_vec* ( *x* )
+that the adjusted integrand can depend on.
+
 adj_line
 ********
 The return value is a vector with size *n_line*
@@ -303,6 +351,181 @@ a1_double_rate_    (number_rate_enum)
       }
       assert( mulcov_pack_info_[mulcov_id].smooth_id == size_t(smooth_id) );
    }
+   // record the ODE checkpoint functions before any a1_double tapes
+   if( rate_case != "no_ode" )
+      ode2_checkpoint_setup();
+}
+
+namespace {
+   // which rates, the ODE, and covariate multipliers an integrand uses
+   void integrand_need(
+      integrand_enum                integrand   ,
+      bool&                         need_ode    ,
+      bool&                         need_mulcov ,
+      CppAD::vector<bool>&          need_rate   )
+   {  need_ode     = false;
+      need_mulcov  = false;
+      need_rate.resize(number_rate_enum);
+      for(size_t k = 0; k < number_rate_enum; ++k)
+         need_rate[k] = false;
+      switch( integrand )
+      {
+         // --------------------------------------------------------------
+         // need_ode = true;
+         case susceptible_enum:
+         case withC_enum:
+         case prevalence_enum:
+         case Tincidence_enum:
+         case mtspecific_enum:
+         case mtall_enum:
+         case mtstandard_enum:
+         need_ode = true;
+         //
+         // need_rate = true
+         for(size_t k = 0; k < number_rate_enum; ++k)
+            need_rate[k] = true;
+         break;
+
+         // --------------------------------------------------------------
+         case Sincidence_enum:
+         need_rate[iota_enum] = true;
+         break;
+
+         case remission_enum:
+         need_rate[rho_enum] = true;
+         break;
+
+         case mtexcess_enum:
+         need_rate[chi_enum] = true;
+         break;
+
+         case mtother_enum:
+         need_rate[omega_enum] = true;
+         break;
+
+         case mtwith_enum:
+         need_rate[omega_enum] = true;
+         need_rate[chi_enum]   = true;
+         break;
+
+         case relrisk_enum:
+         need_rate[chi_enum]   = true;
+         need_rate[omega_enum] = true;
+         break;
+
+         case mulcov_enum:
+         need_mulcov = true;
+         break;
+
+         // --------------------------------------------------------------
+         default:
+         assert( false);
+      }
+   }
+}
+
+// depend
+void adj_integrand::depend(
+   size_t                  integrand_id    ,
+   size_t                  n_child         ,
+   size_t                  child           ,
+   size_t                  subgroup_id     ,
+   CppAD::vector<size_t>&  pack_index      ,
+   CppAD::vector<size_t>&  covariate_index ) const
+{  pack_info::subvec_info info;
+   //
+   // need_ode, need_mulcov, need_rate
+   integrand_enum integrand = integrand_table_[integrand_id].integrand;
+   bool need_ode, need_mulcov;
+   CppAD::vector<bool> need_rate;
+   integrand_need(integrand, need_ode, need_mulcov, need_rate);
+   //
+   // group_id, first_subgroup_id
+   size_t group_id          = subgroup_table_[subgroup_id].group_id;
+   size_t first_subgroup_id = pack_object_.first_subgroup_id(group_id);
+   //
+   // pack_depend, cov_depend
+   CppAD::vector<bool> pack_depend( pack_object_.size() );
+   CppAD::vector<bool> cov_depend( covariate_table_.size() );
+   for(size_t i = 0; i < pack_depend.size(); ++i)
+      pack_depend[i] = false;
+   for(size_t j = 0; j < cov_depend.size(); ++j)
+      cov_depend[j] = false;
+   auto add_info = [&pack_depend](const pack_info::subvec_info& info)
+   {  if( info.smooth_id != DISMOD_AT_NULL_SIZE_T )
+      {  for(size_t k = 0; k < info.n_var; ++k)
+            pack_depend[info.offset + k] = true;
+      }
+   };
+   //
+   if( need_mulcov )
+   {  int mulcov_id = integrand_table_[integrand_id].mulcov_id;
+      add_info( mulcov_pack_info_[mulcov_id] );
+   }
+   else
+   {  for(size_t rate_id = 0; rate_id < number_rate_enum; ++rate_id)
+      if( need_rate[rate_id] )
+      {  // parent and child rates
+         add_info( pack_object_.node_rate_value_info(rate_id, n_child) );
+         if( child < n_child )
+            add_info( pack_object_.node_rate_value_info(rate_id, child) );
+         //
+         // group covariate multipliers for this rate
+         size_t n_cov = pack_object_.group_rate_value_n_cov(rate_id);
+         for(size_t j = 0; j < n_cov; ++j)
+         {  info = pack_object_.group_rate_value_info(rate_id, j);
+            if( info.group_id == group_id )
+            {  add_info( info );
+               cov_depend[info.covariate_id] = true;
+            }
+         }
+         //
+         // subgroup covariate multipliers for this rate
+         n_cov = pack_object_.subgroup_rate_value_n_cov(rate_id);
+         for(size_t j = 0; j < n_cov; ++j)
+         {  info = pack_object_.subgroup_rate_value_info(rate_id, j, 0);
+            if( info.group_id == group_id )
+            {  size_t k = subgroup_id - first_subgroup_id;
+               info     = pack_object_.subgroup_rate_value_info(rate_id, j, k);
+               add_info( info );
+               cov_depend[info.covariate_id] = true;
+            }
+         }
+      }
+      //
+      // group measurement covariate multipliers
+      size_t n_cov = pack_object_.group_meas_value_n_cov(integrand_id);
+      for(size_t j = 0; j < n_cov; ++j)
+      {  info = pack_object_.group_meas_value_info(integrand_id, j);
+         if( info.group_id == group_id )
+         {  add_info( info );
+            cov_depend[info.covariate_id] = true;
+         }
+      }
+      //
+      // subgroup measurement covariate multipliers
+      n_cov = pack_object_.subgroup_meas_value_n_cov(integrand_id);
+      for(size_t j = 0; j < n_cov; ++j)
+      {  info = pack_object_.subgroup_meas_value_info(integrand_id, j, 0);
+         if( info.group_id == group_id )
+         {  size_t k = subgroup_id - first_subgroup_id;
+            info = pack_object_.subgroup_meas_value_info(integrand_id, j, k);
+            add_info( info );
+            cov_depend[info.covariate_id] = true;
+         }
+      }
+   }
+   //
+   // pack_index, covariate_index
+   pack_index.resize(0);
+   covariate_index.resize(0);
+   for(size_t i = 0; i < pack_depend.size(); ++i)
+      if( pack_depend[i] )
+         pack_index.push_back(i);
+   for(size_t j = 0; j < cov_depend.size(); ++j)
+      if( cov_depend[j] )
+         covariate_index.push_back(j);
+   return;
 }
 
 // BEGIN_LINE_PROTOTYPE
@@ -318,6 +541,7 @@ CppAD::vector<Float> adj_integrand::line(
    const CppAD::vector<double>&                       x                ,
    const CppAD::vector<Float>&                        pack_vec         ,
 // END_LINE_PROTOTYPE
+   const CppAD::vector<Float>&                        x_cov            ,
    CppAD::vector<Float>&                              mulcov           ,
    CppAD::vector< CppAD::vector<Float> >&             rate             )
 {  using CppAD::vector;
@@ -336,68 +560,16 @@ CppAD::vector<Float> adj_integrand::line(
    size_t first_subgroup_id = pack_object_.first_subgroup_id(group_id);
    assert( first_subgroup_id <= subgroup_id );
    //
-   // initialize other values for this average
-   bool need_ode     = false;
-   bool need_mulcov  = false;
-   vector<bool> need_rate(number_rate_enum);
-   for(size_t k = 0; k < number_rate_enum; ++k)
-      need_rate[k] = false;
-   switch( integrand )
-   {
-      // -----------------------------------------------------------------
-      // need_ode = true;
-      case susceptible_enum:
-      case withC_enum:
-      case prevalence_enum:
-      case Tincidence_enum:
-      case mtspecific_enum:
-      case mtall_enum:
-      case mtstandard_enum:
-      need_ode = true;
-      //
-      // need_rate = true
-      for(size_t k = 0; k < number_rate_enum; ++k)
-         need_rate[k] = true;
-      break;
-
-      // -----------------------------------------------------------------
-      case Sincidence_enum:
-      need_rate[iota_enum] = true;
-      break;
-
-      case remission_enum:
-      need_rate[rho_enum] = true;
-      break;
-
-      case mtexcess_enum:
-      need_rate[chi_enum] = true;
-      break;
-
-      case mtother_enum:
-      need_rate[omega_enum] = true;
-      break;
-
-      case mtwith_enum:
-      need_rate[omega_enum] = true;
-      need_rate[chi_enum]   = true;
-      break;
-
-      case relrisk_enum:
-      need_rate[chi_enum]   = true;
-      need_rate[omega_enum] = true;
-      break;
-
-      case mulcov_enum:
-      need_mulcov = true;
-      break;
-
-      // -----------------------------------------------------------------
-      default:
-      assert( false);
-   }
+   // need_ode, need_mulcov, need_rate
+   bool need_ode, need_mulcov;
+   vector<bool> need_rate;
+   integrand_need(integrand, need_ode, need_mulcov, need_rate);
    // number of points in line
    size_t n_line = line_age.size();
    //
+   // index of the splitting covariate value for this line
+   size_t split_id = cov2weight_obj_.split_id(x);
+   //
    // vector of effects
    vector<Float> effect(n_line), temp_1(n_line), temp_2(n_line), cov_grid;
    //
@@ -518,11 +690,11 @@ CppAD::vector<Float> adj_integrand::line(
             // temp_2 = covariate value
             size_t covariate_id = info.covariate_id;
             size_t weight_id = cov2weight_obj_.weight_id(
-               covariate_id, node_id, x
+               covariate_id, node_id, split_id
             );
             if( weight_id == cov2weight_obj_.n_weight() || (! need_ode) )
             {  for(size_t k = 0; k < n_line; ++k)
-                  temp_2[k] = x[ info.covariate_id ];
+                  temp_2[k] = x_cov[covariate_id];
             }
             else
             {  const weight_info& w_info = w_info_vec_[weight_id];
@@ -577,11 +749,11 @@ CppAD::vector<Float> adj_integrand::line(
             // temp_2 = covariate value
             size_t covariate_id = info.covariate_id;
             size_t weight_id = cov2weight_obj_.weight_id(
-               covariate_id, node_id, x
+               covariate_id, node_id, split_id
             );
             if( weight_id == cov2weight_obj_.n_weight() || (! need_ode) )
             {  for(size_t ell = 0; ell < n_line; ++ell)
-                  temp_2[ell] = x[ info.covariate_id ];
+                  temp_2[ell] = x_cov[covariate_id];
             }
             else
             {  const weight_info& w_info = w_info_vec_[weight_id];
@@ -773,7 +945,7 @@ CppAD::vector<Float> adj_integrand::line(
    {  info  = pack_object_.group_meas_value_info(integrand_id, j);
       if( info.group_id == group_id )
       {  size_t smooth_id = info.smooth_id;
-         double x_j       = x[ info.covariate_id ];
+         Float  x_j       = x_cov[info.covariate_id];
          // interpolate from smoothing grid to cohort
          smooth_value.resize(info.n_var);
          for(size_t k = 0; k < info.n_var; ++k)
@@ -802,7 +974,7 @@ CppAD::vector<Float> adj_integrand::line(
       {  size_t k = subgroup_id - first_subgroup_id;
          info  = pack_object_.subgroup_meas_value_info(integrand_id, j, k);
          size_t smooth_id = info.smooth_id;
-         double x_j       = x[ info.covariate_id ];
+         Float  x_j       = x_cov[info.covariate_id];
          // interpolate from smoothing grid to cohort
          smooth_value.resize(info.n_var);
          for(size_t ell = 0; ell < info.n_var; ++ell)
@@ -842,37 +1014,128 @@ CppAD::vector<Float> adj_integrand::line(
       size_t                                        subgroup_id      ,    \
       const CppAD::vector<double>&                  x                ,    \
       const CppAD::vector<Float>&                   pack_vec         ,    \
+      const CppAD::vector<Float>&                   x_cov            ,    \
       CppAD::vector<Float>&                         mulcov           ,    \
       CppAD::vector< CppAD::vector<Float> >&        rate                  \
-   );                                                                     \
-\
-   CppAD::vector<Float> adj_integrand::line(                              \
-      size_t                                        node_id          ,    \
-      const CppAD::vector<double>&                  line_age         ,    \
-      const CppAD::vector<double>&                  line_time        ,    \
-      size_t                                        integrand_id     ,    \
-      size_t                                        n_child          ,    \
-      size_t                                        child            ,    \
-      size_t                                        subgroup_id      ,    \
-      const CppAD::vector<double>&                  x                ,    \
-      const CppAD::vector<Float>&                   pack_vec         )    \
-   {  return line(                                                        \
-         node_id,                                                        \
-         line_age,                                                       \
-         line_time,                                                      \
-         integrand_id,                                                   \
-         n_child,                                                        \
-         child,                                                          \
-         subgroup_id,                                                    \
-         x,                                                              \
-         pack_vec,                                                       \
-         Float ## _mulcov_,                                              \
-         Float ## _rate_                                                 \
-      );                                                                 \
-   }
+   );
 
 // instantiations
 DISMOD_AT_INSTANTIATE_ADJ_INTEGTAND_LINE( double )
 DISMOD_AT_INSTANTIATE_ADJ_INTEGTAND_LINE( a1_double )
 
+// double version of line
+CppAD::vector<double> adj_integrand::line(
+   size_t                                        node_id          ,
+   const CppAD::vector<double>&                  line_age         ,
+   const CppAD::vector<double>&                  line_time        ,
+   size_t                                        integrand_id     ,
+   size_t                                        n_child          ,
+   size_t                                        child            ,
+   size_t                                        subgroup_id      ,
+   const CppAD::vector<double>&                  x                ,
+   const CppAD::vector<double>&                  pack_vec         )
+{  return line(
+      node_id,
+      line_age,
+      line_time,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      x,
+      double_mulcov_,
+      double_rate_
+   );
+}
+
+// a1_double version of line
+CppAD::vector<a1_double> adj_integrand::line(
+   size_t                                        node_id          ,
+   const CppAD::vector<double>&                  line_age         ,
+   const CppAD::vector<double>&                  line_time        ,
+   size_t                                        integrand_id     ,
+   size_t                                        n_child          ,
+   size_t                                        child            ,
+   size_t                                        subgroup_id      ,
+   const CppAD::vector<double>&                  x                ,
+   const CppAD::vector<a1_double>&               pack_vec         )
+{  a1_double_x_.resize( x.size() );
+   for(size_t j = 0; j < x.size(); ++j)
+      a1_double_x_[j] = x[j];
+   return line(
+      node_id,
+      line_age,
+      line_time,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      a1_double_x_,
+      a1_double_mulcov_,
+      a1_double_rate_
+   );
+}
+
+// double version of line with separate covariate values for effects
+CppAD::vector<double> adj_integrand::line(
+   size_t                                        node_id          ,
+   const CppAD::vector<double>&                  line_age         ,
+   const CppAD::vector<double>&                  line_time        ,
+   size_t                                        integrand_id     ,
+   size_t                                        n_child          ,
+   size_t                                        child            ,
+   size_t                                        subgroup_id      ,
+   const CppAD::vector<double>&                  x                ,
+   const CppAD::vector<double>&                  x_cov            ,
+   const CppAD::vector<double>&                  pack_vec         )
+{  assert( x_cov.size() == x.size() );
+   return line(
+      node_id,
+      line_age,
+      line_time,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      x_cov,
+      double_mulcov_,
+      double_rate_
+   );
+}
+
+// a1_double version of line with covariate values that are variables
+CppAD::vector<a1_double> adj_integrand::line(
+   size_t                                        node_id          ,
+   const CppAD::vector<double>&                  line_age         ,
+   const CppAD::vector<double>&                  line_time        ,
+   size_t                                        integrand_id     ,
+   size_t                                        n_child          ,
+   size_t                                        child            ,
+   size_t                                        subgroup_id      ,
+   const CppAD::vector<double>&                  x                ,
+   const CppAD::vector<a1_double>&               a1_x             ,
+   const CppAD::vector<a1_double>&               pack_vec         )
+{  assert( a1_x.size() == x.size() );
+   return line(
+      node_id,
+      line_age,
+      line_time,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      a1_x,
+      a1_double_mulcov_,
+      a1_double_rate_
+   );
+}
+
 } // END_DISMOD_AT_NAMESPACE
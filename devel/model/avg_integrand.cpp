@@ -145,8 +145,12 @@ age_table_                 ( age_table )       ,
 time_table_                ( time_table )      ,
 integrand_table_           ( integrand_table ) ,
 w_info_vec_                ( w_info_vec )      ,
+ode_lexis_grid_            ( false )           ,
+pack_generation_           ( 0 )               ,
 double_time_line_object_   ( age_avg_grid )    ,
 a1_double_time_line_object_( age_avg_grid )    ,
+double_lexis_object_       ( ode_step_size, age_avg_grid ) ,
+a1_double_lexis_object_    ( ode_step_size, age_avg_grid ) ,
 adjint_obj_(
    cov2weight_obj,
    w_info_vec,
@@ -163,6 +167,83 @@ adjint_obj_(
 { }
 /*
 ------------------------------------------------------------------------------
+{xrst_begin avg_integrand_lexis dev}
+{xrst_spell
+  lexis
+}
+
+Using a Lexis Grid for Integrands that Require the ODE
+######################################################
+
+Syntax
+******
+
+| *avgint_obj* . ``set_ode_lexis_grid`` ( *ode_lexis_grid* )
+| *avgint_obj* . ``new_pack_vec`` ()
+
+ode_lexis_grid
+**************
+If this is true, the :ref:`rectangle<avg_integrand_rectangle-name>`
+function will use a :ref:`lexis_grid-name` ODE solution
+for integrands that require the ODE.
+Otherwise it will solve the ODE for each cohort in each rectangle.
+The constructor sets this value to false; i.e., the Lexis grid is not used.
+
+new_pack_vec
+************
+This increments the generation counter that is passed to
+:ref:`lexis_grid@set_generation` for the
+``double`` and ``a1_double`` Lexis grids.
+It must be called each time the *pack_vec* argument to
+:ref:`rectangle<avg_integrand_rectangle-name>` changes value
+and before each new recording of an ``a1_double`` version of *rectangle* .
+It is not necessary to call it when *ode_lexis_grid* is false.
+
+{xrst_end avg_integrand_lexis}
+*/
+void avg_integrand::set_ode_lexis_grid(bool ode_lexis_grid)
+{  ode_lexis_grid_ = ode_lexis_grid;
+   new_pack_vec();
+}
+void avg_integrand::new_pack_vec(void)
+{  ++pack_generation_; }
+/*
+------------------------------------------------------------------------------
+{xrst_begin avg_integrand_depend dev}
+
+Variables and Covariates that Rectangle Depends On
+##################################################
+
+Syntax
+******
+
+| *avgint_obj* . ``depend`` (
+| |tab| *integrand_id* , *n_child* , *child* , *subgroup_id* ,
+| |tab| *pack_index* , *covariate_index*
+| )
+
+Purpose
+*******
+This is a structural (value independent) set of the
+*pack_vec* and *x* components that the
+:ref:`rectangle<avg_integrand_rectangle-name>` function depends on;
+see :ref:`adj_integrand@depend` for the meaning of the arguments.
+
+{xrst_end avg_integrand_depend}
+*/
+void avg_integrand::depend(
+   size_t                 integrand_id    ,
+   size_t                 n_child         ,
+   size_t                 child           ,
+   size_t                 subgroup_id     ,
+   CppAD::vector<size_t>& pack_index      ,
+   CppAD::vector<size_t>& covariate_index ) const
+{  adjint_obj_.depend(
+      integrand_id, n_child, child, subgroup_id, pack_index, covariate_index
+   );
+}
+/*
+------------------------------------------------------------------------------
 {xrst_begin avg_integrand_rectangle dev}
 
 Computing One Average Integrand
@@ -185,6 +266,11 @@ Syntax
 | |tab| *x* ,
 | |tab| *pack_vec*
 | )
+| *avg* = *avgint_obj* . ``rectangle`` (
+| |tab| *node_id*, *age_lower* , *age_upper* , *time_lower* , *time_upper* ,
+| |tab| *weight_id* , *integrand_id* , *n_child* , *child* , *subgroup_id* ,
+| |tab| *x* , *a1_x* , *pack_vec*
+| )
 
 Prototype
 *********
@@ -240,6 +326,14 @@ x
 *
 This is the vector of covariates for this average.
 
+a1_x
+****
+If this argument is present, *pack_vec* has type ``a1_double`` and
+*a1_x* is used in place of *x* when multiplying covariate values
+by covariate multipliers; see :ref:`adj_integrand@a1_x` .
+This argument cannot be used when
+:ref:`avg_integrand_lexis@ode_lexis_grid` is true.
+
 Float
 *****
 The type *Float* must be ``double`` or
@@ -282,7 +376,9 @@ Float avg_integrand::rectangle(
    const CppAD::vector<double>&     x                ,
    const CppAD::vector<Float>&      pack_vec         ,
 // END_RECTANGLE_PROTOTYPE
+   const CppAD::vector<Float>*      x_cov            ,
    time_line_vec<Float>&            time_line_object ,
+   lexis_grid<Float>&               lexis_object     ,
    CppAD::vector<Float>&            line_adj         )
 {  using CppAD::vector;
    typedef typename time_line_vec<Float>::time_point  time_point;
@@ -368,7 +464,7 @@ Float avg_integrand::rectangle(
    bool one_time = time_line_vec<double>::near_equal(time_lower, time_upper);
 
    // -----------------------------------------------------------------------
-   if( ! need_ode )
+   if( ! need_ode || ode_lexis_grid_ )
    // -----------------------------------------------------------------------
    {  // n_time: number times in each time line
       // d_time: spacing between time points
@@ -398,17 +494,52 @@ Float avg_integrand::rectangle(
       }
       // line_adj
       line_adj.resize(n_line);
-      line_adj = adjint_obj_.line(
-         node_id,
-         line_age_,
-         line_time_,
-         integrand_id,
-         n_child,
-         child,
-         subgroup_id,
-         x,
-         pack_vec
-      );
+      if( ! need_ode && x_cov != nullptr )
+      {  line_adj = adjint_obj_.line(
+            node_id,
+            line_age_,
+            line_time_,
+            integrand_id,
+            n_child,
+            child,
+            subgroup_id,
+            x,
+            *x_cov,
+            pack_vec
+         );
+      }
+      else if( ! need_ode )
+      {  line_adj = adjint_obj_.line(
+            node_id,
+            line_age_,
+            line_time_,
+            integrand_id,
+            n_child,
+            child,
+            subgroup_id,
+            x,
+            pack_vec
+         );
+      }
+      else
+      {  // use ODE solution on the Lexis grid
+         assert( x_cov == nullptr );
+         lexis_object.set_generation( pack_generation_ );
+         for(size_t k = 0; k < n_line; ++k)
+         {  line_adj[k] = lexis_object.value(
+               adjint_obj_,
+               line_age_[k],
+               line_time_[k],
+               node_id,
+               integrand_id,
+               n_child,
+               child,
+               subgroup_id,
+               x,
+               pack_vec
+            );
+         }
+      }
       // line_weight_
       line_weight_.resize(n_line);
       line_weight_ = grid2line(
@@ -455,6 +586,7 @@ Float avg_integrand::rectangle(
          subgroup_id,
          x,
          pack_vec,
+         x_cov,
          time_line_object,
          line_adj
       );
@@ -495,6 +627,7 @@ Float avg_integrand::rectangle(
             subgroup_id,
             x,
             pack_vec,
+            x_cov,
             time_line_object,
             line_adj
          );
@@ -553,6 +686,7 @@ Float avg_integrand::rectangle(
          subgroup_id,
          x,
          pack_vec,
+         x_cov,
          time_line_object,
          line_adj
       );
@@ -654,6 +788,13 @@ pack_vec
 is all the :ref:`model_variables-name` in the order
 specified by *pack_object* .
 
+x_cov
+*****
+If this pointer is null, the covariate values in *x* are used
+when multiplying covariate values by covariate multipliers.
+Otherwise, it points to the :ref:`adj_integrand@a1_x` values
+that are used in place of *x* .
+
 time_line_object
 ****************
 This is the object that are adding the cohort to.
@@ -698,6 +839,7 @@ void avg_integrand::add_cohort(
    size_t                       subgroup_id                      ,
    const CppAD::vector<double>& x                                ,
    const CppAD::vector<Float>&  pack_vec                         ,
+   const CppAD::vector<Float>*  x_cov                            ,
    time_line_vec<Float>&        time_line_object                 ,
    CppAD::vector<Float>&        line_adj                         )
 // END_ADD_COHORT_PROTOTYPE
@@ -754,17 +896,33 @@ void avg_integrand::add_cohort(
 
    // line_adj
    line_adj.resize(n_line);
-   line_adj = adjint_obj_.line(
-      node_id,
-      line_age_,
-      line_time_,
-      integrand_id,
-      n_child,
-      child,
-      subgroup_id,
-      x,
-      pack_vec
-   );
+   if( x_cov == nullptr )
+   {  line_adj = adjint_obj_.line(
+         node_id,
+         line_age_,
+         line_time_,
+         integrand_id,
+         n_child,
+         child,
+         subgroup_id,
+         x,
+         pack_vec
+      );
+   }
+   else
+   {  line_adj = adjint_obj_.line(
+         node_id,
+         line_age_,
+         line_time_,
+         integrand_id,
+         n_child,
+         child,
+         subgroup_id,
+         x,
+         *x_cov,
+         pack_vec
+      );
+   }
 
    // line_weight_
    line_weight_.resize(n_line);
@@ -816,7 +974,9 @@ void avg_integrand::add_cohort(
       size_t                           subgroup_id      ,    \
       const CppAD::vector<double>&     x                ,    \
       const CppAD::vector<Float>&      pack_vec         ,    \
+      const CppAD::vector<Float>*      x_cov            ,    \
       time_line_vec<Float>&            time_line_object ,    \
+      lexis_grid<Float>&               lexis_object     ,    \
       CppAD::vector<Float>&            line_adj              \
    );                                                         \
 \
@@ -833,7 +993,7 @@ void avg_integrand::add_cohort(
       size_t                           subgroup_id      ,    \
       const CppAD::vector<double>&     x                ,    \
       const CppAD::vector<Float>&      pack_vec         )    \
-   {  return rectangle(                                      \
+   {  return rectangle<Float>(                               \
          node_id,                                           \
          age_lower,                                         \
          age_upper,                                         \
@@ -846,7 +1006,9 @@ void avg_integrand::add_cohort(
          subgroup_id,                                       \
          x,                                                 \
          pack_vec,                                          \
+         nullptr,                                           \
          Float ## _time_line_object_,                       \
+         Float ## _lexis_object_,                           \
          Float ## _line_adj_                                \
       );                                                    \
    }                                                        \
@@ -864,6 +1026,7 @@ void avg_integrand::add_cohort(
       size_t                       subgroup_id          ,    \
       const CppAD::vector<double>& x                    ,    \
       const CppAD::vector<Float>&  pack_vec             ,    \
+      const CppAD::vector<Float>*  x_cov                ,    \
       time_line_vec<Float>&        time_line_object     ,    \
       CppAD::vector<Float>&        line_adj                  \
       );
@@ -872,4 +1035,41 @@ void avg_integrand::add_cohort(
 DISMOD_AT_INSTANTIATE_AVG_INTEGRAND_RECTANGLE( double )
 DISMOD_AT_INSTANTIATE_AVG_INTEGRAND_RECTANGLE( a1_double )
 
+// a1_double version of rectangle with covariate values that are variables
+a1_double avg_integrand::rectangle(
+   size_t                           node_id          ,
+   double                           age_lower        ,
+   double                           age_upper        ,
+   double                           time_lower       ,
+   double                           time_upper       ,
+   size_t                           weight_id        ,
+   size_t                           integrand_id     ,
+   size_t                           n_child          ,
+   size_t                           child            ,
+   size_t                           subgroup_id      ,
+   const CppAD::vector<double>&     x                ,
+   const CppAD::vector<a1_double>&  a1_x             ,
+   const CppAD::vector<a1_double>&  pack_vec         )
+{  assert( a1_x.size() == x.size() );
+   assert( ! ode_lexis_grid_ );
+   return rectangle(
+      node_id,
+      age_lower,
+      age_upper,
+      time_lower,
+      time_upper,
+      weight_id,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      &a1_x,
+      a1_double_time_line_object_,
+      a1_double_lexis_object_,
+      a1_double_line_adj_
+   );
+}
+
 } // END_DISMOD_AT_NAMESPACE
@@ -214,6 +214,41 @@ This ``bool`` value is true (false) if the data point corresponding to
 *subset_id* depends (does not depend) on a random effect
 that is a variable; i.e., not constrained to be a constant.
 
+group
+=====
+This ``size_t`` value identifies the group that this data point belongs to.
+Data points in the same group have the same
+integrand, node, subgroup, weighting, child,
+age and time limits, and covariate weightings
+(see :ref:`cov2weight_map-name` ).
+Hence they only differ in their covariate values and measurements.
+
+eval_order\_
+************
+is a permutation of the *subset_id* values sorted by
+child, node, integrand, weight, lower age, and lower time.
+The average integrands are computed in this order
+by :ref:`data_model_like_all-name` and :ref:`data_model_average_all-name`
+so that consecutive computations use the same model information.
+The results are still returned in *subset_id* order.
+If ``SORT_EVAL_ORDER`` is zero (at the top of ``data_model.cpp`` ),
+``eval_order_`` is the identity permutation.
+The program ``bin/speed_eval_order.sh`` uses this to time the fit command,
+and count its cache misses, with and without the sorting.
+
+same_rectangle\_
+****************
+for each *subset_id* , ``same_rectangle_`` [ *subset_id* ]
+is the first *subset_id* that has the same arguments to
+:ref:`avg_integrand::rectangle<avg_integrand-name>` ; see
+:ref:`data_model_same_rectangle-name` .
+
+group_info\_
+*************
+For each group, the number of data points in the group and
+the checkpoint function recorded by
+:ref:`data_model_record_checkpoint-name` .
+
 avgint_obj\_
 ************
 The ``avg_integrand`` :ref:`constructor<avg_integrand_ctor-name>`
@@ -225,6 +260,8 @@ arguments to the ``data_model`` constructor and are passed through
 {xrst_end data_model_ctor}
 -----------------------------------------------------------------------------
 */
+# include <map>
+# include <algorithm>
 # include <cppad/mixed/exception.hpp>
 # include <dismod_at/min_max_vector.hpp>
 # include <dismod_at/data_model.hpp>
@@ -235,6 +272,10 @@ arguments to the ``data_model`` constructor and are passed through
 # include <dismod_at/avgint_subset.hpp>
 # include <dismod_at/null_int.hpp>
 # include <dismod_at/error_exit.hpp>
+# include <dismod_at/parallel_loop.hpp>
+
+// zero for eval_order_ equal to subset_id order (see speed_eval_order.sh)
+# define SORT_EVAL_ORDER 1
 
 namespace {
    template <class Float>
@@ -347,6 +388,18 @@ avg_noise_obj_(
    // replace_like_called_: initialize
    replace_like_called_ = false;
    //
+   // ode_lexis_grid_: initialize
+   ode_lexis_grid_ = false;
+   //
+   // number_thread_: initialize
+   number_thread_ = 1;
+   //
+   // aggregate_data_: initialize
+   aggregate_data_ = false;
+   //
+   // checkpoint_recorded_: initialize
+   checkpoint_recorded_ = false;
+   //
    // -----------------------------------------------------------------------
    // subset_data_obj_
    //
@@ -482,6 +535,105 @@ avg_noise_obj_(
       }
       data_info_[subset_id].depend_on_ran_var = depend_on_ran_var;
    }
+   // -----------------------------------------------------------------------
+   // data_info_[subset_id].group, group_info_
+   //
+   // key for each group: the values that determine the averaging structure
+   std::map< std::vector<double>, size_t> key2group;
+   CppAD::vector<double> x(n_covariate);
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   {  const subset_data_struct& data_item = subset_data_obj_[subset_id];
+      size_t node_id = size_t( data_item.node_id );
+      for(size_t j = 0; j < n_covariate; j++)
+         x[j] = subset_cov_value[subset_id * n_covariate + j];
+      //
+      std::vector<double> key;
+      key.push_back( double( data_item.integrand_id ) );
+      key.push_back( double( data_item.node_id ) );
+      key.push_back( double( data_item.subgroup_id ) );
+      key.push_back( double( data_item.weight_id ) );
+      key.push_back( double( data_info_[subset_id].child ) );
+      key.push_back( data_item.age_lower );
+      key.push_back( data_item.age_upper );
+      key.push_back( data_item.time_lower );
+      key.push_back( data_item.time_upper );
+      size_t split_id = cov2weight_obj.split_id(x);
+      for(size_t j = 0; j < n_covariate; j++)
+         key.push_back(
+            double( cov2weight_obj.weight_id(j, node_id, split_id) )
+         );
+      //
+      std::map< std::vector<double>, size_t>::iterator itr;
+      itr = key2group.find(key);
+      if( itr == key2group.end() )
+      {  size_t group   = group_info_.size();
+         key2group[key] = group;
+         group_info_.emplace_back();
+         group_info_[group].n_subset = 0;
+         itr = key2group.find(key);
+      }
+      size_t group = itr->second;
+      data_info_[subset_id].group = group;
+      ++group_info_[group].n_subset;
+   }
+   // -----------------------------------------------------------------------
+   // same_rectangle_
+   //
+   // key for each rectangle: all the arguments to avg_integrand::rectangle
+   // except for pack_vec
+   std::map< std::vector<double>, size_t> key2rectangle;
+   same_rectangle_.resize(n_subset);
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   {  const subset_data_struct& data_item = subset_data_obj_[subset_id];
+      std::vector<double> key;
+      key.push_back( double( data_item.integrand_id ) );
+      key.push_back( double( data_item.node_id ) );
+      key.push_back( double( data_item.subgroup_id ) );
+      key.push_back( double( data_item.weight_id ) );
+      key.push_back( double( data_info_[subset_id].child ) );
+      key.push_back( data_item.age_lower );
+      key.push_back( data_item.age_upper );
+      key.push_back( data_item.time_lower );
+      key.push_back( data_item.time_upper );
+      for(size_t j = 0; j < n_covariate; j++)
+         key.push_back( subset_cov_value[subset_id * n_covariate + j] );
+      //
+      std::map< std::vector<double>, size_t>::iterator itr;
+      itr = key2rectangle.find(key);
+      if( itr == key2rectangle.end() )
+      {  key2rectangle[key]         = subset_id;
+         same_rectangle_[subset_id] = subset_id;
+      }
+      else
+         same_rectangle_[subset_id] = itr->second;
+   }
+   // -----------------------------------------------------------------------
+   // eval_order_
+   //
+   // Rows that use the same child, node, integrand and weighting are next
+   // to each other so that consecutive average integrands use the same
+   // smoothing and weight grid information.
+   eval_order_.resize(n_subset);
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+      eval_order_[subset_id] = subset_id;
+   auto less_than = [&](size_t i, size_t j)
+   {  const subset_data_struct& item_i = subset_data_obj_[i];
+      const subset_data_struct& item_j = subset_data_obj_[j];
+      if( data_info_[i].child != data_info_[j].child )
+         return data_info_[i].child < data_info_[j].child;
+      if( item_i.node_id != item_j.node_id )
+         return item_i.node_id < item_j.node_id;
+      if( item_i.integrand_id != item_j.integrand_id )
+         return item_i.integrand_id < item_j.integrand_id;
+      if( item_i.weight_id != item_j.weight_id )
+         return item_i.weight_id < item_j.weight_id;
+      if( item_i.age_lower != item_j.age_lower )
+         return item_i.age_lower < item_j.age_lower;
+      return item_i.time_lower < item_j.time_lower;
+   };
+   if( SORT_EVAL_ORDER ) std::stable_sort(
+      eval_order_.data(), eval_order_.data() + n_subset, less_than
+   );
 }
 /*
 {xrst_begin data_model_replace_like dev}
@@ -598,9 +750,444 @@ void data_model::replace_like(
          error_exit(msg, table_name, data_id);
       }
    }
+   //
+   // like_batch_
+   // one batch for each density that appears in the data subset
+   like_batch_.resize(0);
+   CppAD::vector<size_t> density2batch(number_density_enum);
+   for(size_t k = 0; k < number_density_enum; ++k)
+      density2batch[k] = DISMOD_AT_NULL_SIZE_T;
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   {  const subset_data_struct& data_item = subset_data_obj_[subset_id];
+      density_enum density = data_info_[subset_id].density;
+      size_t&      batch_id = density2batch[density];
+      if( batch_id == DISMOD_AT_NULL_SIZE_T )
+      {  batch_id = like_batch_.size();
+         like_batch_.push_back( residual_batch_struct() );
+         like_batch_[batch_id].density       = density;
+         like_batch_[batch_id].residual_type = real_data_enum;
+         if( fit_simulated_data_ )
+            like_batch_[batch_id].residual_type = simulated_data_enum;
+      }
+      residual_batch_struct& batch = like_batch_[batch_id];
+      double obs = data_item.meas_value;
+      if( fit_simulated_data_ )
+         obs = data_item.data_sim_value;
+      batch.index.push_back( subset_id );
+      batch.obs.push_back( obs );
+      batch.eta.push_back( data_item.eta );
+      batch.nu.push_back( data_item.nu );
+      batch.sample_size.push_back( double( size_t( data_item.sample_size ) ) );
+   }
+   for(size_t batch_id = 0; batch_id < like_batch_.size(); ++batch_id)
+      residual_batch_const( like_batch_[batch_id] );
+   //
    replace_like_called_ = true;
    return;
 }
+/*
+-----------------------------------------------------------------------------
+{xrst_begin data_model_set_ode_lexis_grid dev}
+{xrst_spell
+  lexis
+}
+
+Data Model: Use a Lexis Grid to Approximate the ODE
+###################################################
+
+Syntax
+******
+| *data_object* . ``set_ode_lexis_grid`` ( *ode_lexis_grid* )
+| *data_object* . ``new_pack_vec`` ()
+
+ode_lexis_grid
+**************
+This is the value of
+:ref:`option_table@Age Average Grid@ode_lexis_grid` in the option table
+converted to a ``bool`` .
+If it is true, the average integrands that require the ODE are
+computed using a :ref:`lexis_grid-name` solution
+that is shared by all the data with the same
+node, child, subgroup, covariate values, and integrand.
+The constructor sets this value to false.
+If it is true, the checkpoint functions recorded by
+:ref:`data_model_record_checkpoint-name` are not used
+(this must be set before they are recorded).
+
+new_pack_vec
+************
+The Lexis grid solution depends on the model variables *pack_vec* .
+The routines
+:ref:`like_all<data_model_like_all-name>` and
+:ref:`average_all<data_model_average_all-name>`
+call ``new_pack_vec`` at their start.
+When :ref:`average<data_model_average-name>` is called directly,
+the caller must call ``new_pack_vec`` each time *pack_vec* changes value
+and before each new recording of an ``a1_double`` tape.
+This is only an integer increment, so it is cheap to call.
+
+{xrst_end data_model_set_ode_lexis_grid}
+*/
+void data_model::set_ode_lexis_grid(bool ode_lexis_grid)
+{  assert( ! checkpoint_recorded_ );
+   ode_lexis_grid_ = ode_lexis_grid;
+   avgint_obj_.set_ode_lexis_grid(ode_lexis_grid);
+}
+void data_model::new_pack_vec(void)
+{  avgint_obj_.new_pack_vec(); }
+/*
+-----------------------------------------------------------------------------
+{xrst_begin data_model_set_aggregate_data dev}
+
+Data Model: Share Work Between Duplicate Data Rows
+##################################################
+
+Syntax
+******
+*data_object* . ``set_aggregate_data`` ( *aggregate_data* )
+
+aggregate_data
+**************
+This is the value of
+:ref:`option_table@aggregate_data` in the option table
+converted to a ``bool`` .
+The constructor sets this value to false.
+
+Duplicates
+**********
+Two data rows are duplicates if they have the same
+:ref:`data_model_same_rectangle@first` .
+Duplicates have the same average integrand,
+but they may have different
+density, measurement values, and measurement standard deviations.
+The average integrand is computed once for each set of duplicates
+whether or not *aggregate_data* is true.
+
+Gaussian Family
+***************
+If *aggregate_data* is true, the rows in a set of duplicates
+that are included by ``like_all`` and have the
+:ref:`density_table@density_name@gaussian` density are combined,
+when there is more than one of them.
+The same is done for the rows with the
+:ref:`density_table@density_name@log_gaussian` density and the same
+:ref:`data_table@eta` as the first such row.
+Each combination uses the sufficient statistics for the Gaussian family:
+Let :math:`y_i` be the measurement values
+(:math:`\log( y_i + \eta )` in the log_gaussian case)
+and :math:`\sigma_i` the corresponding adjusted standard deviations,
+:math:`w_i = \sigma_i^{-2}` , :math:`W = \sum_i w_i` ,
+:math:`\bar{y} = W^{-1} \sum_i w_i y_i` and
+:math:`Q = \sum_i w_i ( y_i - \bar{y} )^2`.
+Using the identity
+
+.. math::
+
+   \sum_i w_i ( y_i - \mu )^2 = W ( \bar{y} - \mu )^2 + Q
+
+the sum of the log-densities for these rows is
+
+.. math::
+
+   - \sum_i \log( \sigma_i \sqrt{ 2 \pi } ) - Q / 2
+   - W ( \bar{y} - \mu )^2 / 2
+
+where :math:`\mu` is the average integrand
+(:math:`\log( \mu + \eta )` in the log_gaussian case).
+The residual for the first of these rows has
+``logden_smooth`` equal to this sum and
+``wres`` equal to :math:`\sqrt{W} ( \bar{y} - \mu )`.
+The residuals for the other rows have
+``wres`` , ``logden_smooth`` , and ``logden_sub_abs`` equal to zero.
+The number and order of the residuals does not change.
+
+Likelihood
+**********
+The likelihood is a mathematically identical function of the
+:ref:`model_variables-name` whether or not *aggregate_data* is true.
+Its value is computed in a different order
+and so it may differ in the last bits of floating point precision.
+The other densities are not combined, they only share the
+average integrand for the set of duplicates.
+
+{xrst_end data_model_set_aggregate_data}
+*/
+void data_model::set_aggregate_data(bool aggregate_data)
+{  aggregate_data_ = aggregate_data; }
+/*
+-----------------------------------------------------------------------------
+{xrst_begin data_model_same_rectangle dev}
+
+Data Model: Rows With the Same Average Integrand
+################################################
+
+Syntax
+******
+*first* = *data_object* . ``same_rectangle`` ( *subset_id* )
+
+subset_id
+*********
+is the :ref:`subset_data@subset_data_obj@subset_id`
+(or avgint subset index) for a row.
+
+first
+*****
+is the smallest subset index that has the same
+integrand, node, subgroup, weight, child, age and time limits,
+and covariate values as *subset_id* .
+These are all the arguments to
+:ref:`avg_integrand::rectangle<avg_integrand-name>` except for the
+model variables.
+Hence for every *pack_vec*
+
+   *data_object* . ``average`` ( *subset_id* , *pack_vec* ) ==
+   *data_object* . ``average`` ( *first* , *pack_vec* )
+
+This mapping is computed once by the constructor.
+
+Memoization
+***********
+:ref:`data_model_like_all-name` and :ref:`data_model_average_all-name`
+compute the average integrand once for each distinct *first*
+and copy it to the other rows.
+This is also done for the ``a1_double`` recordings,
+so there is one copy of the rectangle operations in a tape
+for each distinct *first* .
+The predict command uses ``same_rectangle`` in the same way
+for the rows of the avgint table.
+
+{xrst_end data_model_same_rectangle}
+*/
+size_t data_model::same_rectangle(size_t subset_id) const
+{  assert( subset_id < same_rectangle_.size() );
+   return same_rectangle_[subset_id];
+}
+/*
+-----------------------------------------------------------------------------
+{xrst_begin data_model_eval_order dev}
+
+Data Model: Order for Computing Average Integrands
+##################################################
+
+Syntax
+******
+*subset_id* = *data_object* . ``eval_order`` ( *k* )
+
+k
+*
+is an index between zero and the number of subset rows (exclusive).
+
+subset_id
+*********
+As *k* goes from zero to the number of rows minus one,
+*subset_id* goes through all the subset rows sorted by
+child, node, integrand, weight, lower age, and lower time
+(ties are in *subset_id* order).
+Consecutive average integrands in this order use the same
+smoothing, weighting, and covariate multiplier information,
+which improves memory locality and keeps the operations for
+one child together in the ``a1_double`` recordings.
+If *first* is :ref:`data_model_same_rectangle@first`
+for *subset_id* , then *first* comes before, or is equal to,
+*subset_id* in this order.
+
+{xrst_end data_model_eval_order}
+*/
+size_t data_model::eval_order(size_t k) const
+{  assert( k < eval_order_.size() );
+   return eval_order_[k];
+}
+/*
+-----------------------------------------------------------------------------
+{xrst_begin data_model_record_checkpoint dev}
+
+Data Model: Record One Average Integrand Function per Group
+###########################################################
+
+Syntax
+******
+*data_object* . ``record_checkpoint`` ( *n_var* )
+
+n_var
+*****
+is the number of model variables; i.e., the size of *pack_vec* .
+
+When
+****
+The checkpoint functions are only recorded when this routine is called;
+i.e., commands that do not record ``a1_double`` tapes do not pay for them.
+The :ref:`fit_model constructor<fit_model_ctor-name>` calls this routine
+before it records its tapes.
+It must not be called while an ``a1_double`` tape is being recorded
+(a nested recording is not allowed).
+Only the first call records the functions; the other calls do nothing.
+If this routine has not been called, the ``a1_double`` version of
+:ref:`data_model_average-name` does not use checkpoint functions.
+
+Purpose
+*******
+Data points in the same
+:ref:`data_model_ctor@data_info_@group` only differ by their
+covariate values and measurements.
+For each group with more than one data point,
+this routine records the ``a1_double`` version of the
+:ref:`average integrand<data_model_average-name>`
+as a function of the model variables and covariate values it depends on.
+This function is recorded once and stored as a CppAD ``chkpoint_two``
+function.
+The ``a1_double`` version of
+:ref:`data_model_average-name` uses this checkpoint function
+for every data point in the group.
+This reduces the size of the tapes, and the time to record them,
+by about the number of data points in each group.
+
+Arguments
+*********
+The model variables and covariate values that are arguments
+to the checkpoint function are determined by
+:ref:`avg_integrand_depend-name` , before the recording,
+and stored in ``group_info_`` .
+The covariate values are passed to
+:ref:`avg_integrand::rectangle<avg_integrand_rectangle-name>`
+as the explicit argument *a1_x* .
+
+pack_vec
+********
+The value of the checkpoint functions does not depend on the value of the
+model variables used during the recording.
+The value 0.1 is used for all the model variables.
+
+ode_lexis_grid
+**************
+If :ref:`data_model_set_ode_lexis_grid@ode_lexis_grid` is true,
+the checkpoint functions would not be used, so they are not recorded.
+
+{xrst_end data_model_record_checkpoint}
+*/
+void data_model::record_checkpoint(size_t n_var)
+{  typedef CppAD::vector<a1_double> a1_vector;
+   assert( n_var == pack_object_size_ );
+   if( checkpoint_recorded_ || ode_lexis_grid_ )
+      return;
+   checkpoint_recorded_ = true;
+   //
+   size_t n_subset = subset_data_obj_.size();
+   //
+   // a1_pack_vec, a1_x
+   a1_vector a1_pack_vec(n_var), a1_x(n_covariate_);
+   CppAD::vector<double> x(n_covariate_);
+   //
+   for(size_t subset_id = 0; subset_id < n_subset; ++subset_id)
+   {  group_info& info = group_info_[ data_info_[subset_id].group ];
+      if( info.n_subset > 1 && info.checkpoint == nullptr )
+      {  // arguments to avg_integrand::rectangle
+         const subset_data_struct& data_item = subset_data_obj_[subset_id];
+         size_t node_id      = size_t( data_item.node_id );
+         size_t weight_id    = size_t( data_item.weight_id );
+         size_t integrand_id = size_t( data_item.integrand_id );
+         size_t subgroup_id  = size_t( data_item.subgroup_id );
+         size_t child        = size_t( data_info_[subset_id].child );
+         for(size_t j = 0; j < n_covariate_; j++)
+            x[j] = subset_cov_value_[subset_id * n_covariate_ + j];
+         //
+         // info.pack_index, info.covariate_index
+         avgint_obj_.depend(
+            integrand_id,
+            n_child_,
+            child,
+            subgroup_id,
+            info.pack_index,
+            info.covariate_index
+         );
+         size_t n_pack = info.pack_index.size();
+         size_t n_x    = info.covariate_index.size();
+         //
+         // fun: ax = (pack_vec[pack_index], x[covariate_index]), ay = avg
+         if( n_pack + n_x > 0 )
+         {  a1_vector ax(n_pack + n_x), ay(1);
+            for(size_t k = 0; k < n_pack; ++k)
+               ax[k] = 0.1;
+            for(size_t k = 0; k < n_x; ++k)
+               ax[n_pack + k] = x[ info.covariate_index[k] ];
+            CppAD::Independent(ax);
+            for(size_t i = 0; i < n_var; ++i)
+               a1_pack_vec[i] = 0.1;
+            for(size_t j = 0; j < n_covariate_; ++j)
+               a1_x[j] = x[j];
+            for(size_t k = 0; k < n_pack; ++k)
+               a1_pack_vec[ info.pack_index[k] ] = ax[k];
+            for(size_t k = 0; k < n_x; ++k)
+               a1_x[ info.covariate_index[k] ] = ax[n_pack + k];
+            ay[0] = avgint_obj_.rectangle(
+               node_id,
+               data_item.age_lower,
+               data_item.age_upper,
+               data_item.time_lower,
+               data_item.time_upper,
+               weight_id,
+               integrand_id,
+               n_child_,
+               child,
+               subgroup_id,
+               x,
+               a1_x,
+               a1_pack_vec
+            );
+            CppAD::ADFun<double> fun(ax, ay);
+            fun.optimize();
+            //
+            // info.checkpoint
+            std::string name = "data_model_group_" + CppAD::to_string(
+               data_info_[subset_id].group
+            );
+            bool internal_bool    = false;
+            bool use_hes_sparsity = true;
+            bool use_base2ad      = true;
+            bool use_in_parallel  = false;
+            info.checkpoint.reset( new CppAD::chkpoint_two<double>(
+               fun,
+               name,
+               internal_bool,
+               use_hes_sparsity,
+               use_base2ad,
+               use_in_parallel
+            ) );
+         }
+      }
+   }
+   return;
+}
+// checkpoint_average: double case
+// (checkpoint functions are only used when recording a1_double tapes)
+bool data_model::checkpoint_average(
+   size_t                           /* subset_id */ ,
+   const CppAD::vector<double>&     /* pack_vec */  ,
+   double&                          /* avg */       )
+{  return false; }
+//
+// checkpoint_average: a1_double case
+bool data_model::checkpoint_average(
+   size_t                           subset_id ,
+   const CppAD::vector<a1_double>&  pack_vec  ,
+   a1_double&                       avg       )
+{  group_info& info = group_info_[ data_info_[subset_id].group ];
+   if( info.checkpoint == nullptr || ode_lexis_grid_ )
+      return false;
+   //
+   // ax = (pack_vec[pack_index], x[covariate_index])
+   size_t n_pack = info.pack_index.size();
+   size_t n_x    = info.covariate_index.size();
+   CppAD::vector<a1_double> ax(n_pack + n_x), ay(1);
+   for(size_t k = 0; k < n_pack; ++k)
+      ax[k] = pack_vec[ info.pack_index[k] ];
+   for(size_t k = 0; k < n_x; ++k)
+   {  size_t j = info.covariate_index[k];
+      ax[n_pack + k] = subset_cov_value_[subset_id * n_covariate_ + j];
+   }
+   (*info.checkpoint)(ax, ay);
+   avg = ay[0];
+   return true;
+}
 
 /*
 -----------------------------------------------------------------------------
@@ -654,6 +1241,20 @@ The return value has prototype
 This is the
 :ref:`average integrand<avg_integrand@Average Integrand, A_i>`
 for the specified data point.
+
+Checkpoint
+**********
+If *Float* is ``a1_double`` ,
+:ref:`data_model_record_checkpoint-name` has recorded a checkpoint function
+for the group that this data point belongs to, and
+:ref:`data_model_set_ode_lexis_grid@ode_lexis_grid` is false,
+that function is used to compute *avg* .
+
+Lexis Grid
+**********
+If :ref:`data_model_set_ode_lexis_grid@ode_lexis_grid` is true,
+see :ref:`data_model_set_ode_lexis_grid@new_pack_vec` .
+
 {xrst_toc_hidden
    example/devel/model/avg_no_ode_xam.cpp
    example/devel/model/avg_yes_ode_xam.cpp
@@ -670,7 +1271,18 @@ template <class Float>
 Float data_model::average(
    size_t                        subset_id ,
    const CppAD::vector<Float>&   pack_vec  )
-{
+{  return average(subset_id, pack_vec, avgint_obj_); }
+//
+template <class Float>
+Float data_model::average(
+   size_t                        subset_id  ,
+   const CppAD::vector<Float>&   pack_vec   ,
+   avg_integrand&                avgint_obj )
+{  // use the checkpoint function for this group if it has been recorded
+   Float result;
+   if( checkpoint_average(subset_id, pack_vec, result) )
+      return result;
+   //
    // arguments to avg_integrand::rectangle
    const subset_data_struct& data_item = subset_data_obj_[subset_id];
    double age_lower    = data_item.age_lower;
@@ -687,7 +1299,7 @@ Float data_model::average(
       x[j] = subset_cov_value_[subset_id * n_covariate_ + j];
    //
    // compute average integrand
-   Float result = avgint_obj_.rectangle(
+   result = avgint_obj.rectangle(
       node_id,
       age_lower,
       age_upper,
@@ -835,6 +1447,27 @@ residual_struct<Float> data_model::like_one(
    const CppAD::vector<Float>&   pack_vec  ,
    const Float&                  avg       ,
    Float&                        delta_out )
+{  return like_one(subset_id, pack_vec, avg, delta_out, avg_noise_obj_); }
+//
+template <class Float>
+void data_model::binomial_avg_check(
+   size_t                        subset_id     ,
+   const Float&                  avg           ) const
+{  density_enum density = data_info_[subset_id].density;
+   if( density == binomial_enum && avg <= 0.0 )
+   {  int data_id = subset_data_obj_[subset_id].original_id;
+      std::string msg = "like_one: density = binomial, average integrand = ";
+      msg += CppAD::to_string(avg) + " data_id = " + CppAD::to_string(data_id);
+      error_exit(msg);
+   }
+}
+//
+template <class Float>
+Float data_model::like_delta(
+   size_t                        subset_id     ,
+   const CppAD::vector<Float>&   pack_vec      ,
+   const Float&                  avg           ,
+   avg_noise_effect&             avg_noise_obj )
 {
    assert( pack_object_size_ == pack_vec.size() );
    assert( replace_like_called_ );
@@ -844,7 +1477,6 @@ residual_struct<Float> data_model::like_one(
    for(size_t j = 0; j < n_covariate_; j++)
       x[j] = subset_cov_value_[subset_id * n_covariate_ + j];
    double eta          = subset_data_obj_[subset_id].eta;
-   double nu           = subset_data_obj_[subset_id].nu;
    double meas_value   = subset_data_obj_[subset_id].meas_value;
    double meas_std     = subset_data_obj_[subset_id].meas_std;
    double age_lower    = subset_data_obj_[subset_id].age_lower;
@@ -855,19 +1487,13 @@ residual_struct<Float> data_model::like_one(
    size_t weight_id    = size_t( subset_data_obj_[subset_id].weight_id );
    size_t subgroup_id  = size_t( subset_data_obj_[subset_id].subgroup_id );
    size_t integrand_id = size_t( subset_data_obj_[subset_id].integrand_id );
-   double data_sim_value   = subset_data_obj_[subset_id].data_sim_value;
    //
    // density
    density_enum density = data_info_[subset_id].density;
-   if( density == binomial_enum && avg <= 0.0 )
-   {  int data_id = subset_data_obj_[subset_id].original_id;
-      std::string msg = "like_one: density = binomial, average integrand = ";
-      msg += CppAD::to_string(avg) + " data_id = " + CppAD::to_string(data_id);
-      error_exit(msg);
-   }
+   binomial_avg_check(subset_id, avg);
    //
    // average noise effect
-   Float std_effect = avg_noise_obj_.rectangle(
+   Float std_effect = avg_noise_obj.rectangle(
       age_lower,
       age_upper,
       time_lower,
@@ -924,9 +1550,29 @@ residual_struct<Float> data_model::like_one(
    //
    // delta_out
    // transformed standard deviation
-   delta_out = sigma;
+   Float delta_out = sigma;
    if( log_density(density) )
       delta_out = log( meas_value + eta + sigma ) - log( meas_value + eta );
+   return delta_out;
+}
+template <class Float>
+residual_struct<Float> data_model::like_one(
+   size_t                        subset_id     ,
+   const CppAD::vector<Float>&   pack_vec      ,
+   const Float&                  avg           ,
+   Float&                        delta_out     ,
+   avg_noise_effect&             avg_noise_obj )
+{  //
+   // delta_out
+   delta_out = like_delta(subset_id, pack_vec, avg, avg_noise_obj);
+   //
+   double eta            = subset_data_obj_[subset_id].eta;
+   double nu             = subset_data_obj_[subset_id].nu;
+   double meas_value     = subset_data_obj_[subset_id].meas_value;
+   size_t sample_size    = size_t( subset_data_obj_[subset_id].sample_size );
+   double data_sim_value = subset_data_obj_[subset_id].data_sim_value;
+   density_enum density  = data_info_[subset_id].density;
+   //
    residual_enum residual_type;
    double        y;
    if( fit_simulated_data_ )
@@ -1053,6 +1699,15 @@ minus the number for which
 :ref:`data_table@hold_out` is one.
 The order of the residuals is not specified in this case.
 
+Aggregate Data
+==============
+If :ref:`data_model_set_aggregate_data-name` was called with
+*aggregate_data* true, the log density for duplicate Gaussian family rows
+is combined in the residual for the first of these rows
+and the residuals for the other rows are zero;
+see :ref:`data_model_set_aggregate_data@Gaussian Family` .
+The sizes and order above do not change.
+
 Log Density
 ***********
 The log of the density
@@ -1075,30 +1730,351 @@ CppAD::vector< residual_struct<Float> > data_model::like_all(
    bool                        random_depend ,
    const CppAD::vector<Float>& pack_vec      )
 {  assert( replace_like_called_ );
+   size_t n_subset = subset_data_obj_.size();
    //
-   // loop over the subsampled data
-   CppAD::vector< residual_struct<Float> > residual_vec;
-   for(size_t subset_id = 0; subset_id < subset_data_obj_.size(); subset_id++)
-   {  bool keep = hold_out == false;
-      keep     |= subset_data_obj_[subset_id].hold_out == 0;
+   // ODE solutions on the Lexis grid may belong to a previous pack_vec
+   // or a previous recording
+   avgint_obj_.new_pack_vec();
+   //
+   // keep
+   CppAD::vector<bool> keep(n_subset);
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   {  keep[subset_id]  = hold_out == false;
+      keep[subset_id] |= subset_data_obj_[subset_id].hold_out == 0;
       if( random_depend )
-         keep &= data_info_[subset_id].depend_on_ran_var == true;
+         keep[subset_id] &= data_info_[subset_id].depend_on_ran_var == true;
       else
-         keep &= data_info_[subset_id].depend_on_ran_var == false;
+         keep[subset_id] &= data_info_[subset_id].depend_on_ran_var == false;
       assert( data_info_[subset_id].child <= n_child_ );
-      if( keep )
-      {  Float avg = average(subset_id, pack_vec);
-
-         // compute its residual and log likelihood
+   }
+   //
+   // lead, n_combine, combine
+   // The key for a kept Gaussian family row is 2 * first for gaussian and
+   // 2 * first + 1 for log_gaussian, where first is its first duplicate.
+   // lead[key] is the first such row, n_combine[key] is the number of such
+   // rows (log_gaussian rows must also have the same eta as lead[key]),
+   // and combine[subset_id] is true if there is more than one such row.
+   CppAD::vector<size_t> lead(2 * n_subset), n_combine(2 * n_subset);
+   CppAD::vector<bool>   combine(n_subset);
+   CppAD::vector<size_t> key(n_subset);
+   for(size_t k = 0; k < 2 * n_subset; ++k)
+   {  lead[k]      = n_subset;
+      n_combine[k] = 0;
+   }
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   {  combine[subset_id] = false;
+      key[subset_id]     = 2 * n_subset;
+   }
+   if( aggregate_data_ )
+   {  for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+      {  density_enum density = data_info_[subset_id].density;
+         bool log_family = density == log_gaussian_enum;
+         bool family     = log_family || density == gaussian_enum;
+         if( keep[subset_id] && family )
+         {  size_t k = 2 * same_rectangle_[subset_id];
+            if( log_family )
+               ++k;
+            if( lead[k] == n_subset )
+               lead[k] = subset_id;
+            double eta = subset_data_obj_[subset_id].eta;
+            if( ! log_family || eta == subset_data_obj_[ lead[k] ].eta )
+            {  ++n_combine[k];
+               combine[subset_id] = true;
+               key[subset_id]     = k;
+            }
+         }
+      }
+      for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+      if( combine[subset_id] )
+         combine[subset_id] = n_combine[ key[subset_id] ] > 1;
+   }
+   //
+   // avg_first, have_avg
+   // average integrand for each first duplicate, computed in eval_order_
+   CppAD::vector<Float> avg_first(n_subset);
+   CppAD::vector<bool>  have_avg(n_subset);
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+      have_avg[subset_id] = false;
+   for(size_t k = 0; k < n_subset; ++k)
+   {  size_t subset_id = eval_order_[k];
+      size_t first     = same_rectangle_[subset_id];
+      if( keep[subset_id] && ! have_avg[first] )
+      {  avg_first[first] = average(subset_id, pack_vec);
+         have_avg[first]  = true;
+      }
+   }
+   //
+   // combine_key, combine_obs, combine_delta
+   // rows that are combined using sufficient statistics;
+   // combine_obs is the measurement value for gaussian and
+   // log( measurement value + eta ) for log_gaussian.
+   CppAD::vector<size_t> combine_key;
+   CppAD::vector<double> combine_obs;
+   CppAD::vector<Float>  combine_delta;
+   //
+   // lead_index
+   // index in residual_vec corresponding to lead[key]
+   CppAD::vector<size_t> lead_index(2 * n_subset);
+   //
+   // loop over the subsampled data
+   CppAD::vector< residual_struct<Float> > residual_vec;
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   if( keep[subset_id] )
+   {  size_t first = same_rectangle_[subset_id];
+      Float  avg   = avg_first[first];
+      //
+      if( combine[subset_id] )
+      {  // save for combining with its duplicates
+         size_t k   = key[subset_id];
+         double obs = subset_data_obj_[subset_id].meas_value;
+         if( fit_simulated_data_ )
+            obs = subset_data_obj_[subset_id].data_sim_value;
+         if( data_info_[subset_id].density == log_gaussian_enum )
+            obs = std::log( obs + subset_data_obj_[subset_id].eta );
+         combine_key.push_back( k );
+         combine_obs.push_back( obs );
+         combine_delta.push_back(
+            like_delta(subset_id, pack_vec, avg, avg_noise_obj_)
+         );
+         //
+         // the lead residual is set below, the others are zero
+         if( subset_id == lead[k] )
+            lead_index[k] = residual_vec.size();
+         residual_struct<Float> residual;
+         residual.wres           = 0.0;
+         residual.logden_smooth  = 0.0;
+         residual.logden_sub_abs = 0.0;
+         residual.density        = data_info_[subset_id].density;
+         residual.index          = subset_id;
+         residual_vec.push_back( residual );
+      }
+      else
+      {  // compute its residual and log likelihood
          Float not_used;
          residual_struct<Float> residual =
             like_one(subset_id, pack_vec, avg, not_used);
          residual_vec.push_back( residual );
       }
    }
+   if( combine_key.size() == 0 )
+      return residual_vec;
+   //
+   // sum_w, sum_wy, sum_log, sum_q
+   // sufficient statistics for each key
+   double pi2 = 8.0 * std::atan(1.0);
+   CppAD::vector<Float> sum_w(2 * n_subset), sum_wy(2 * n_subset);
+   CppAD::vector<Float> sum_log(2 * n_subset), sum_q(2 * n_subset);
+   for(size_t j = 0; j < combine_key.size(); ++j)
+   {  size_t k = combine_key[j];
+      sum_w[k]   = 0.0;
+      sum_wy[k]  = 0.0;
+      sum_log[k] = 0.0;
+      sum_q[k]   = 0.0;
+   }
+   for(size_t j = 0; j < combine_key.size(); ++j)
+   {  size_t k     = combine_key[j];
+      Float  delta = combine_delta[j];
+      if( delta <= 0.0 )
+      {  std::string msg = "residual_density: delta = ";
+         msg += CppAD::to_string(delta);
+         msg += " is not greater than 0";
+         error_exit(msg);
+      }
+      Float w = 1.0 / (delta * delta);
+      sum_w[k]   += w;
+      sum_wy[k]  += w * combine_obs[j];
+      sum_log[k] += log( delta * sqrt( pi2 ) );
+   }
+   //
+   // y_bar
+   CppAD::vector<Float> y_bar(2 * n_subset);
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   if( combine[subset_id] )
+   {  size_t k = key[subset_id];
+      if( subset_id == lead[k] )
+         y_bar[k] = sum_wy[k] / sum_w[k];
+   }
+   //
+   // sum_q
+   for(size_t j = 0; j < combine_key.size(); ++j)
+   {  size_t k     = combine_key[j];
+      Float  delta = combine_delta[j];
+      Float  diff  = combine_obs[j] - y_bar[k];
+      sum_q[k]    += diff * diff / (delta * delta);
+   }
+   //
+   // set the residual for each lead row
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   if( combine[subset_id] )
+   {  size_t k = key[subset_id];
+      if( subset_id == lead[k] )
+      {  Float mu = avg_first[ same_rectangle_[subset_id] ];
+         if( data_info_[subset_id].density == log_gaussian_enum )
+            mu = log( mu + subset_data_obj_[subset_id].eta );
+         Float wres = sqrt( sum_w[k] ) * ( y_bar[k] - mu );
+         residual_struct<Float>& residual = residual_vec[ lead_index[k] ];
+         residual.wres           = wres;
+         residual.logden_smooth  =
+            - sum_log[k] - sum_q[k] / 2.0 - wres * wres / 2.0;
+      }
+   }
    return residual_vec;
 }
 
+/*
+-----------------------------------------------------------------------------
+{xrst_begin data_model_average_all dev}
+
+Data Model: Average Integrand and Residual for All Data Points
+##############################################################
+
+Syntax
+******
+| *data_object* . ``set_number_thread`` ( *number_thread* )
+| *data_object* . ``average_all`` (
+| |tab| *pack_vec* , *avg_vec* , *delta_vec* , *residual_vec*
+| )
+
+Purpose
+*******
+This computes the ``double`` version of
+:ref:`data_model_average-name` and :ref:`data_model_like_one-name`
+for every *subset_id* and it can use multiple threads to do so.
+The results are the same as calling ``average`` and ``like_one``
+in a serial loop over *subset_id* .
+
+number_thread
+*************
+This is the number of threads that ``average_all`` uses.
+Each thread uses its own copy of the objects
+that compute the average integrand and average noise effect.
+The constructor sets this value to one;
+i.e., no extra threads are used.
+
+pack_vec
+********
+is all the :ref:`model_variables-name` in the order
+specified by :ref:`pack_info-name` .
+
+avg_vec
+*******
+The input size of this vector does not matter.
+Upon return it has size *n_subset* and
+*avg_vec* [ *subset_id* ] is the average integrand for *subset_id* .
+
+delta_vec
+*********
+The input size of this vector does not matter.
+Upon return it has size *n_subset* and
+*delta_vec* [ *subset_id* ] is the
+:ref:`data_model_like_one@delta_out` for *subset_id* .
+
+residual_vec
+************
+The input size of this vector does not matter.
+Upon return it has size *n_subset* and
+*residual_vec* [ *subset_id* ] is the
+:ref:`data_model_like_one@residual` for *subset_id* .
+
+replace_like
+************
+One must call :ref:`replace_like<data_model_replace_like-name>`
+before calling ``average_all`` .
+
+{xrst_end data_model_average_all}
+*/
+void data_model::set_number_thread(size_t number_thread)
+{  assert( number_thread > 0 );
+   number_thread_ = number_thread;
+}
+void data_model::average_all(
+   const CppAD::vector<double>&               pack_vec     ,
+   CppAD::vector<double>&                     avg_vec      ,
+   CppAD::vector<double>&                     delta_vec    ,
+   CppAD::vector< residual_struct<double> >&  residual_vec )
+{  assert( replace_like_called_ );
+   size_t n_subset = subset_data_obj_.size();
+   //
+   // ODE solutions on the Lexis grid may belong to a previous pack_vec
+   avgint_obj_.new_pack_vec();
+   //
+   // results are set by element during parallel_loop
+   avg_vec.resize(n_subset);
+   delta_vec.resize(n_subset);
+   residual_vec.resize(n_subset);
+   //
+   // n_thread
+   size_t n_thread = std::min(number_thread_, std::max(n_subset, size_t(1)));
+   // The average integrand is only computed for the first subset_id
+   // with each rectangle (see same_rectangle_) and in eval_order_
+   if( n_thread == 1 )
+   {  for(size_t k = 0; k < n_subset; ++k)
+      {  size_t subset_id = eval_order_[k];
+         if( same_rectangle_[subset_id] == subset_id )
+            avg_vec[subset_id] = average(subset_id, pack_vec);
+      }
+      for(size_t subset_id = 0; subset_id < n_subset; ++subset_id)
+      {  avg_vec[subset_id]   = avg_vec[ same_rectangle_[subset_id] ];
+         delta_vec[subset_id] = like_delta(
+            subset_id, pack_vec, avg_vec[subset_id], avg_noise_obj_
+         );
+      }
+   }
+   else
+   {  // The other threads must not call error_exit or log_message,
+      // so errors that like_delta would report are detected below,
+      // by this thread, before it is called by the other threads.
+      //
+      // work_avg
+      std::function<void(size_t)> work_avg = [&](size_t thread)
+      {  // workspace for this thread
+         avg_integrand     avgint_obj( avgint_obj_ );
+         //
+         // a contiguous block of eval_order_ for each thread
+         size_t k_begin = (thread * n_subset) / n_thread;
+         size_t k_end   = ((thread + 1) * n_subset) / n_thread;
+         for(size_t k = k_begin; k < k_end; ++k)
+         {  size_t subset_id = eval_order_[k];
+            if( same_rectangle_[subset_id] == subset_id )
+               avg_vec[subset_id] = average(subset_id, pack_vec, avgint_obj);
+         }
+      };
+      parallel_loop(n_thread, work_avg);
+      //
+      // duplicates
+      for(size_t subset_id = 0; subset_id < n_subset; ++subset_id)
+         avg_vec[subset_id] = avg_vec[ same_rectangle_[subset_id] ];
+      //
+      // check for errors
+      for(size_t subset_id = 0; subset_id < n_subset; ++subset_id)
+         binomial_avg_check(subset_id, avg_vec[subset_id]);
+      //
+      // work_delta
+      std::function<void(size_t)> work_delta = [&](size_t thread)
+      {  // workspace for this thread
+         avg_noise_effect  avg_noise_obj( avg_noise_obj_ );
+         //
+         size_t subset_id = thread;
+         for( ; subset_id < n_subset; subset_id += n_thread)
+         {  delta_vec[subset_id] = like_delta(
+               subset_id, pack_vec, avg_vec[subset_id], avg_noise_obj
+            );
+         }
+      };
+      parallel_loop(n_thread, work_delta);
+   }
+   //
+   // residual_vec
+   // The residuals do not depend on the averaging workspace, so they are
+   // computed one density at a time after all the averages are known.
+   for(size_t batch_id = 0; batch_id < like_batch_.size(); ++batch_id)
+   {  residual_density_batch(
+         like_batch_[batch_id], avg_vec, delta_vec, residual_vec
+      );
+   }
+   return;
+}
+
 // ------------------------------------------------------------------------
 # define DISMOD_AT_INSTANTIATE_DATA_MODEL_CTOR(SubsetStruct)       \
 template data_model::data_model(                                   \
@@ -14,9 +14,49 @@
 # include <dismod_at/get_var_limits.hpp>
 # include <dismod_at/ran_con_rcv.hpp>
 # include <dismod_at/get_str_map.hpp>
+# include <dismod_at/lanczos_sample.hpp>
+# include <dismod_at/parallel_loop.hpp>
+# include <gsl/gsl_rng.h>
+# include <gsl/gsl_randist.h>
+# include <cppad/mixed/manage_gsl_rng.hpp>
+# include <Eigen/SparseCholesky>
 
 # define PRINT_SIZE_MAP 0
 
+namespace {
+   // number_zero_sum_set
+   // number of rows in set_rcv that have at least one entry
+   size_t number_zero_sum_set(const CppAD::mixed::d_sparse_rcv& set_rcv)
+   {  CppAD::vector<bool> found( set_rcv.nr() );
+      for(size_t i = 0; i < set_rcv.nr(); ++i)
+         found[i] = false;
+      size_t count = 0;
+      for(size_t k = 0; k < set_rcv.nnz(); ++k)
+      {  size_t row = set_rcv.row()[k];
+         if( ! found[row] )
+         {  found[row] = true;
+            ++count;
+         }
+      }
+      return count;
+   }
+   // zero_sum_eliminate
+   // Each row of con_rcv is a set of random effects, with the constants
+   // removed, that must sum to zero. The return value is true if these sets
+   // are eliminated using a sum-to-zero basis; i.e., zero_sum_basis is true,
+   // there is at least one set, and eliminating one random effect per set
+   // would not leave zero random effects.
+   bool zero_sum_eliminate(
+      const CppAD::mixed::d_sparse_rcv&  con_rcv         ,
+      bool                               zero_sum_basis  ,
+      const dismod_at::remove_const&     random_const    )
+   {  if( ! zero_sum_basis )
+         return false;
+      size_t n_set = number_zero_sum_set(con_rcv);
+      return 0 < n_set && n_set < random_const.n_var();
+   }
+}
+
 namespace dismod_at { // DISMOD_AT_BEGIN_NAMSPACE
 /*
 {xrst_begin fit_model_ctor dev}
@@ -47,6 +87,7 @@ Syntax
 | |tab| *quasi_fixed* ,
 | |tab| *zero_sum_child_rate* ,
 | |tab| *zero_sum_mulcov_group* ,
+| |tab| *zero_sum_basis* ,
 | |tab| *data_object* ,
 | |tab| *trace_init*
 | )
@@ -142,11 +183,26 @@ for each age, time, and :ref:`mulcov_table-name` row,
 the sum of the random effects with respect to subgroup
 is constrained to be zero.
 
+zero_sum_basis
+**************
+If this argument is false,
+the zero sum conditions above are passed to ``cppad_mixed``
+as equality constraints on the random effects.
+Otherwise, for each set of random effects that must sum to zero,
+the last random effect in the set (that is not constant) is removed
+from the random effects seen by ``cppad_mixed`` and is replaced by
+minus the sum of the other random effects in the set.
+This eliminates the constraints from the optimization; see
+:ref:`option_table@Zero Sum Constraints@zero_sum_basis` .
+If eliminating these random effects would leave no random effects,
+the constraints are used instead.
+
 data_object
 ***********
 This object contains the model for the data density;
 see :ref:`data_model<devel_data_model-name>` .
-It is effectively const.
+It is effectively const, except that the constructor calls
+:ref:`data_model_record_checkpoint-name` for this object.
 
 trace_init
 **********
@@ -175,6 +231,7 @@ fit_model::fit_model(
    bool                                  quasi_fixed           ,
    const CppAD::vector<bool>&            zero_sum_child_rate   ,
    const CppAD::vector<bool>&            zero_sum_mulcov_group ,
+   bool                                  zero_sum_basis        ,
    data_model&                           data_object           ,
    bool                                  trace_init            )
 /* {xrst_code}
@@ -182,27 +239,72 @@ fit_model::fit_model(
 
 {xrst_end fit_model_ctor}
 */
+// The zero sum constraints are computed once and passed to the
+// private constructor.
+: fit_model(
+   ran_con_rcv(
+      bound_random,
+      zero_sum_child_rate,
+      zero_sum_mulcov_group,
+      pack_object,
+      random_const
+   ),
+   zero_sum_basis,
+   db,
+   simulate_index,
+   warn_on_stderr,
+   bound_random,
+   pack_object,
+   var2prior,
+   start_var,
+   scale_var,
+   prior_table,
+   prior_object,
+   random_const,
+   quasi_fixed,
+   data_object,
+   trace_init
+)
+{ }
+//
+// private constructor
+// con_rcv: is the return value of ran_con_rcv for this model.
+fit_model::fit_model(
+   const CppAD::mixed::d_sparse_rcv&     con_rcv               ,
+   bool                                  zero_sum_basis        ,
+   sqlite3*                              db                    ,
+   int                                   simulate_index        ,
+   bool                                  warn_on_stderr        ,
+   double                                bound_random          ,
+   const pack_info&                      pack_object           ,
+   const pack_prior&                     var2prior             ,
+   const CppAD::vector<double>&          start_var             ,
+   const CppAD::vector<double>&          scale_var             ,
+   const CppAD::vector<prior_struct>&    prior_table           ,
+   const prior_model&                    prior_object          ,
+   const remove_const&                   random_const          ,
+   bool                                  quasi_fixed           ,
+   data_model&                           data_object           ,
+   bool                                  trace_init            )
 // base class constructor
 // (The value of bool_sparsity does not seem to affect speed test results.)
 : cppad_mixed(
    // n_fixed
    number_fixed(pack_object),
    // n_random in dismod_at minus number random effects that are constant
+   // and minus number of random effects eliminated by zero sum basis
    pack_object.random_size() - number_random_const(
       pack_object, var2prior, prior_table
+   ) - ( zero_sum_eliminate(con_rcv, zero_sum_basis, random_const) ?
+      number_zero_sum_set(con_rcv) : 0
    ),
    // quasi_fixed
    quasi_fixed,
    // bool_sparsity
    false,
-   // A_rcv
-   ran_con_rcv(
-      bound_random,
-      zero_sum_child_rate,
-      zero_sum_mulcov_group,
-      pack_object,
-      random_const
-   ),
+   // A_rcv (empty when the zero sum constraints are eliminated)
+   zero_sum_eliminate(con_rcv, zero_sum_basis, random_const) ?
+      CppAD::mixed::d_sparse_rcv() : con_rcv,
    // trace_init
    trace_init
 ),
@@ -234,6 +336,45 @@ data_object_   ( data_object )
    random_lower_   = random_const_.lower();
    random_upper_   = random_const_.upper();
    n_random_equal_ = random_const_.n_const();
+   //
+   // zero_sum_last_, zero_sum_start_, zero_sum_other_
+   zero_sum_start_.push_back(0);
+   if( zero_sum_eliminate(con_rcv, zero_sum_basis, random_const) )
+   {  const CppAD::mixed::d_sparse_rcv& set_rcv = con_rcv;
+      CppAD::vector<size_t> row_major = set_rcv.row_major();
+      size_t k = 0;
+      while( k < row_major.size() )
+      {  size_t row = set_rcv.row()[ row_major[k] ];
+         size_t col = set_rcv.col()[ row_major[k] ];
+         ++k;
+         while( k < row_major.size() && set_rcv.row()[ row_major[k] ] == row )
+         {  zero_sum_other_.push_back(col);
+            col = set_rcv.col()[ row_major[k] ];
+            ++k;
+         }
+         zero_sum_last_.push_back(col);
+         zero_sum_start_.push_back( zero_sum_other_.size() );
+      }
+   }
+   //
+   // zero_sum_con_
+   if( ! zero_sum_eliminate(con_rcv, zero_sum_basis, random_const) )
+      zero_sum_con_ = con_rcv;
+   //
+   // var2mixed_, mixed2var_
+   {  size_t n_var_random = random_const_.n_var();
+      var2mixed_.resize(n_var_random);
+      for(size_t j = 0; j < n_var_random; ++j)
+         var2mixed_[j] = 0;
+      for(size_t k = 0; k < zero_sum_last_.size(); ++k)
+         var2mixed_[ zero_sum_last_[k] ] = n_var_random;
+      for(size_t j = 0; j < n_var_random; ++j)
+      {  if( var2mixed_[j] < n_var_random )
+         {  var2mixed_[j] = mixed2var_.size();
+            mixed2var_.push_back(j);
+         }
+      }
+   }
    // ----------------------------------------------------------------------
    // diff_prior_
    assert( diff_prior_.size() == 0 );
@@ -306,6 +447,9 @@ data_object_   ( data_object )
       if( fixed_is_scaled_[j] )
          assert( ! (fixed_scale_eta_[j] == - inf) );
 # endif
+   // ---------------------------------------------------------------------
+   // checkpoint functions used by the a1_double data model
+   data_object_.record_checkpoint( pack_object.size() );
    // ---------------------------------------------------------------------
    // initialize the cppad_mixed object
    //
@@ -318,7 +462,7 @@ data_object_   ( data_object )
    unpack_random(pack_object, start_var, random_vec);
    //
    CppAD::vector<double> cppad_mixed_random_vec =
-      random_const_.remove( random_vec );
+      remove_random( random_vec );
    //
    cppad_mixed_info_ = initialize(fixed_vec, cppad_mixed_random_vec);
 # if PRINT_SIZE_MAP
@@ -377,6 +521,7 @@ It must also have
 
 | |tab| *option_map* [ ``"bound_frac_fixed"`` ]
 | |tab| *option_map* [ ``"limited_memory_max_history_fixed"`` ]
+| |tab| *option_map* [ ``"gauss_newton_fixed"`` ]
 
 warm_start
 **********
@@ -514,9 +659,9 @@ void fit_model::run_fit(
    std::string random_options = options;
    //
    // convert from dismod_at random effects to cppad_mixed random effects
-   d_vector cppad_mixed_random_lower = random_const_.remove( random_lower_ );
-   d_vector cppad_mixed_random_upper = random_const_.remove( random_upper_ );
-   d_vector cppad_mixed_random_in    = random_const_.remove( random_in );
+   d_vector cppad_mixed_random_lower = remove_random( random_lower_ );
+   d_vector cppad_mixed_random_upper = remove_random( random_upper_ );
+   d_vector cppad_mixed_random_in    = remove_random( random_in );
    //
    // optimize the fixed effects
    d_vector fixed_opt = fixed_in;
@@ -526,6 +671,26 @@ void fit_model::run_fit(
       fixed_lag[j] = 0.0;
    for(size_t j = 0; j < fixed_con_lag.size(); j++)
       fixed_con_lag[j] = 0.0;
+   // improve the starting fixed and random effects using Gauss-Newton steps
+   // (only the starting values are changed and the default is not to do this)
+   size_t max_iter = size_t( std::atoi(
+      get_str_map(option_map, "gauss_newton_fixed").c_str()
+   ) );
+   if( ! random_only && warm_start.x_info.size() == 0 && max_iter > 0 )
+   {  double tolerance = std::atof(
+         get_str_map(option_map, "tolerance_fixed").c_str()
+      );
+      gauss_newton_fixed(
+         max_iter,
+         tolerance,
+         fixed_lower_scaled,
+         fixed_upper_scaled,
+         cppad_mixed_random_lower,
+         cppad_mixed_random_upper,
+         fixed_in,
+         cppad_mixed_random_in
+      );
+   }
    if( ! random_only )
    {  CppAD::mixed::fixed_solution fixed_sol = optimize_fixed(
          fixed_options,
@@ -557,7 +722,7 @@ void fit_model::run_fit(
          cppad_mixed_random_upper,
          cppad_mixed_random_in
       );
-      random_opt = random_const_.restore( cppad_mixed_random_opt );
+      random_opt = restore_random( cppad_mixed_random_opt );
    }
    else
    {  assert( n_random_ == n_random_equal_ );
@@ -774,7 +939,7 @@ CppAD::mixed::d_sparse_rcv fit_model::random_obj_hes(
    unpack_fixed(pack_object_,   pack_vec, fixed_vec);
    //
    // convert dismod_at random effects to cppad_mixed random effects
-   d_vector cppad_mixed_random_vec = random_const_.remove( random_vec );
+   d_vector cppad_mixed_random_vec = remove_random( random_vec );
    //
    // convert dismod_at fixed effect to cppad_mixed fixed effects
    d_vector cppad_mixed_fixed_vec(n_fixed_);
@@ -788,7 +953,7 @@ CppAD::mixed::d_sparse_rcv fit_model::random_obj_hes(
    //
    // random_hes_rcv
    // This Hessian uses variable indices in dismod_at space
-   CppAD::vector<size_t> var_id = random2var_id(pack_object_);
+   CppAD::vector<size_t> var_id = mixed_random2var_id();
    size_t nnz = hes_random_rcv.nnz();
    CppAD::mixed::sparse_rc pattern(n_var, n_var, nnz);
    for(size_t k = 0; k < nnz; ++k)
@@ -804,6 +969,132 @@ CppAD::mixed::d_sparse_rcv fit_model::random_obj_hes(
 }
 /*
 ---------------------------------------------------------------------------
+{xrst_begin fit_model_fixed_objective dev}
+
+Fixed Effects Objective Without Scaling
+#######################################
+
+Syntax
+******
+
+   ``obj_value`` = *fit_object* . ``fixed_objective`` ( *pack_vec* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_FIXED_OBJECTIVE
+   // END_FIXED_OBJECTIVE
+}
+
+pack_vec
+********
+Is the value of the fixed and random effects,
+in :ref:`pack_info-name` order, at which we are evaluating the objective.
+The corresponding fixed effects are referred to as :math:`\theta`
+and the random effects are referred to as :math:`u` below.
+The random effects should be optimal for the fixed effects; e.g.,
+*pack_vec* is the solution returned by :ref:`fit_model_get_solution-name` .
+
+obj_value
+*********
+If all the random effects are constant, this is the
+negative log of the fixed effects prior and data densities
+(the data that is not held out).
+Otherwise, it is the sum of this value, the negative log of the
+random effects prior and data densities, and the Laplace approximation term
+:math:`\frac{1}{2} \log \det f_{u,u} ( \theta , u )`
+where :math:`f_{u,u}` is the
+:ref:`Hessian of the random effects objective<fit_model_random_obj_hes-name>` .
+The log determinant is computed using a sparse
+:math:`L D L^\mathrm{T}` factorization of :math:`f_{u,u}`
+in the space of the cppad_mixed random effects.
+If this Hessian is not positive definite, *obj_value* is nan.
+
+Scaling
+*******
+The objective values in the :ref:`trace_fixed_table-name` are scaled
+by Ipopt using the gradient at the starting point.
+Hence they cannot be compared between fits with different starting points.
+The value *obj_value* does not depend on the starting point.
+
+{xrst_end fit_model_fixed_objective}
+*/
+// BEGIN_FIXED_OBJECTIVE
+double fit_model::fixed_objective(
+   const CppAD::vector<double>&  pack_vec )
+// END_FIXED_OBJECTIVE
+{  size_t n_var = n_fixed_ + n_random_;
+   assert( pack_vec.size() == n_var );
+   //
+   // residual_vec
+   bool hold_out = true;
+   CppAD::vector< residual_struct<double> > residual_vec =
+      prior_object_.fixed(pack_vec);
+   CppAD::vector< residual_struct<double> > prior_ran =
+      prior_object_.random(pack_vec);
+   for(size_t i = 0; i < prior_ran.size(); ++i)
+      residual_vec.push_back( prior_ran[i] );
+   for(size_t i_depend = 0; i_depend < 2; ++i_depend)
+   {  bool random_depend = i_depend == 1;
+      CppAD::vector< residual_struct<double> > data_tmp =
+         data_object_.like_all(hold_out, random_depend, pack_vec);
+      for(size_t i = 0; i < data_tmp.size(); ++i)
+         residual_vec.push_back( data_tmp[i] );
+   }
+   //
+   // obj_value
+   double obj_value = 0.0;
+   for(size_t i = 0; i < residual_vec.size(); ++i)
+   {  obj_value -= residual_vec[i].logden_smooth;
+      obj_value += std::fabs( residual_vec[i].logden_sub_abs );
+   }
+   //
+   // Laplace approximation term
+   size_t n_mixed = mixed2var_.size();
+   if( n_mixed > 0 )
+   {  CppAD::vector<double> fixed_vec(n_fixed_), random_vec(n_random_);
+      unpack_random(pack_object_, pack_vec, random_vec);
+      unpack_fixed(pack_object_,   pack_vec, fixed_vec);
+      d_vector cppad_mixed_random_vec = remove_random( random_vec );
+      d_vector cppad_mixed_fixed_vec(n_fixed_);
+      scale_fixed_effect(fixed_vec, cppad_mixed_fixed_vec);
+      CppAD::mixed::d_sparse_rcv hes_random_rcv = hes_random_obj(
+         cppad_mixed_fixed_vec, cppad_mixed_random_vec
+      );
+      //
+      // hes: sparse version of the lower triangle in hes_random_rcv
+      typedef Eigen::SparseMatrix<double, Eigen::ColMajor> eigen_sparse;
+      std::vector< Eigen::Triplet<double> > triplet;
+      for(size_t k = 0; k < hes_random_rcv.nnz(); ++k)
+      {  int r = int( hes_random_rcv.row()[k] );
+         int c = int( hes_random_rcv.col()[k] );
+         double v = hes_random_rcv.val()[k];
+         if( r < c )
+            std::swap(r, c);
+         triplet.push_back( Eigen::Triplet<double>(r, c, v) );
+      }
+      int n_row = int(n_mixed);
+      eigen_sparse hes(n_row, n_row);
+      hes.setFromTriplets( triplet.begin(), triplet.end() );
+      //
+      // logdet
+      Eigen::SimplicialLDLT<eigen_sparse, Eigen::Lower> ldlt;
+      ldlt.compute(hes);
+      if( ldlt.info() != Eigen::Success )
+         return std::numeric_limits<double>::quiet_NaN();
+      Eigen::VectorXd diag = ldlt.vectorD();
+      double logdet = 0.0;
+      for(size_t j = 0; j < n_mixed; ++j)
+      {  if( diag[j] <= 0.0 )
+            return std::numeric_limits<double>::quiet_NaN();
+         logdet += std::log( diag[j] );
+      }
+      obj_value += logdet / 2.0;
+   }
+   return obj_value;
+}
+/*
+---------------------------------------------------------------------------
 {xrst_begin fit_model_sample_posterior dev}
 {xrst_spell
   uhat
@@ -860,6 +1151,9 @@ Variables that are :ref:`constant<fit_model_sample_posterior@Constants>`
 are not included in the Hessian.
 The Laplace density terms in the likelihood function are not included
 because the Hessian is not defined at zero for an Laplace density.
+If *hes_fixed_obj_out* . ``nr`` () is zero upon return,
+the Hessian was not formed; see
+:ref:`fit_model_sample_posterior@sample_out@asymptotic_lanczos_step` .
 
 hes_random_obj_out
 ******************
@@ -915,6 +1209,26 @@ The Hessians of the fixed and random effects objectives
 ignore all constraints except for constants
 (lower and upper limits equal).
 
+asymptotic_lanczos_step
+=======================
+If :ref:`option_table@asymptotic_lanczos_step` in *option_map*
+is non-zero, the fixed effect samples are approximated using
+:ref:`lanczos_sample-name` and Hessian vector products.
+In this case the constant fixed effects are equal to their value in
+*fit_var_value* for every sample.
+
+#. If there are no random effects (other than constants),
+   the fixed effects objective is the fixed likelihood.
+   In this case the Hessian vector products are computed
+   using forward and reverse mode on a recording of the fixed likelihood,
+   the fixed effects Hessian is not formed,
+   and *hes_fixed_obj_out* . ``nr`` () is zero upon return.
+#. Otherwise, the Hessian of the fixed effects objective includes
+   the Laplace approximation term and is only available from
+   ``cppad_mixed`` as a sparse matrix.
+   In this case the Hessian is formed, returned in *hes_fixed_obj_out* ,
+   and the Hessian vector products use its sparse representation.
+
 Prototype
 *********
 {xrst_spell_off}
@@ -946,7 +1260,7 @@ void fit_model::sample_posterior(
    unpack_fixed(pack_object_,   fit_var_value, fixed_vec);
    //
    // convert dismod_at random effects to cppad_mixed random effects
-   d_vector cppad_mixed_random_opt = random_const_.remove( random_opt );
+   d_vector cppad_mixed_random_opt = remove_random( random_opt );
    //
    // convert dismod_at fixed effect to cppad_mixed fixed effects
    d_vector cppad_mixed_fixed_vec(n_fixed_);
@@ -956,8 +1270,20 @@ void fit_model::sample_posterior(
    CppAD::mixed::fixed_solution solution;
    solution.fixed_opt = cppad_mixed_fixed_vec;
    //
+   // lanczos_step
+   size_t lanczos_step = size_t( std::atoi(
+      get_str_map(option_map, "asymptotic_lanczos_step").c_str()
+   ) );
+   //
+   // form_hes_fixed
+   // If there are no cppad_mixed random effects and the Lanczos method
+   // is used, only Hessian vector products for the fixed likelihood are
+   // needed and the fixed effects Hessian is not formed.
+   bool form_hes_fixed = lanczos_step == 0 || mixed2var_.size() > 0;
+   //
    // hes_fixed_obj_rcv
-   CppAD::mixed::d_sparse_rcv hes_fixed_obj_rcv = hes_fixed_obj(
+   CppAD::mixed::d_sparse_rcv hes_fixed_obj_rcv;
+   if( form_hes_fixed ) hes_fixed_obj_rcv = hes_fixed_obj(
       cppad_mixed_fixed_vec, cppad_mixed_random_opt
    );
    // hes_random_obj_rcv
@@ -972,6 +1298,9 @@ void fit_model::sample_posterior(
    );
    //
    // hes_fixed_obj_out
+   if( ! form_hes_fixed )
+      hes_fixed_obj_out = CppAD::mixed::d_sparse_rcv();
+   else
    {  CppAD::vector<size_t> var_id = fixed2var_id(pack_object_);
       size_t nnz   = hes_fixed_obj_rcv.nnz();
       CppAD::vector<bool> both_variable(nnz);
@@ -1005,7 +1334,7 @@ void fit_model::sample_posterior(
       hes_fixed_obj_out = info;
    }
    // hes_random_obj_out
-   {  CppAD::vector<size_t> var_id = random2var_id(pack_object_);
+   {  CppAD::vector<size_t> var_id = mixed_random2var_id();
       size_t nnz = hes_random_obj_rcv.nnz();
       CppAD::mixed::sparse_rc pattern(n_var, n_var, nnz);
       for(size_t k = 0; k < nnz; ++k)
@@ -1054,7 +1383,8 @@ void fit_model::sample_posterior(
    scale_fixed_effect(fixed_upper, cppad_mixed_fixed_upper);
    //
    // check diagonal of information matrix is positive
-   // (except for bound constrained variables)
+   // (except for bound constrained variables; the Lanczos method checks
+   // that the Ritz values are positive when the Hessian is not formed)
    std::string msg = "";
    CppAD::vector<size_t> pack_index = fixed2var_id(pack_object_);
    size_t K = hes_fixed_obj_rcv.nnz();
@@ -1069,7 +1399,8 @@ void fit_model::sample_posterior(
          hessian_diagonal[j] = v;
    }
    for(size_t j = 0; j < n_fixed_; ++j)
-   if( fixed_lower[j] != fixed_upper[j] && hessian_diagonal[j] <= 0.0 )
+   if( form_hes_fixed &&
+      fixed_lower[j] != fixed_upper[j] && hessian_diagonal[j] <= 0.0 )
    {  size_t var_id = pack_index[j];
       if( msg == "" )
       {  msg = "sample asymptotic: Following fixed effect's\n"
@@ -1092,45 +1423,106 @@ void fit_model::sample_posterior(
    // sample_fix, rcond
    CppAD::vector<double> sample_fix(n_sample * n_fixed_);
    msg          = "";
-   try {
-      // sample fixed effects
-      double rcond = std::numeric_limits<double>::quiet_NaN();
-      msg = sample_fixed(
+   if( lanczos_step > 0 )
+   {  // hes_vec: y = H * x where H is the fixed effects Hessian
+      std::function<void(const d_vector&, d_vector&)> hes_vec;
+      CppAD::ADFun<double> fix_like_fun;
+      if( form_hes_fixed )
+      {  size_t nnz = hes_fixed_obj_rcv.nnz();
+         hes_vec = [&hes_fixed_obj_rcv, nnz, this]
+         (const d_vector& x, d_vector& y)
+         {  for(size_t i = 0; i < n_fixed_; ++i)
+               y[i] = 0.0;
+            for(size_t k = 0; k < nnz; ++k)
+            {  size_t r = hes_fixed_obj_rcv.row()[k];
+               size_t c = hes_fixed_obj_rcv.col()[k];
+               double v = hes_fixed_obj_rcv.val()[k];
+               y[r] += v * x[c];
+               if( r != c )
+                  y[c] += v * x[r];
+            }
+         };
+      }
+      else
+      {  // fix_like_fun: recording of the fixed likelihood
+         a1_vector a1_fixed_vec(n_fixed_);
+         for(size_t j = 0; j < n_fixed_; ++j)
+            a1_fixed_vec[j] = cppad_mixed_fixed_vec[j];
+         CppAD::Independent(a1_fixed_vec);
+         a1_vector a1_fix_like = fix_likelihood(a1_fixed_vec);
+         if( a1_fix_like.size() == 0 )
+         {  a1_fix_like.resize(1);
+            a1_fix_like[0] = 0.0;
+         }
+         fix_like_fun.Dependent(a1_fixed_vec, a1_fix_like);
+         fix_like_fun.Forward(0, cppad_mixed_fixed_vec);
+         //
+         // w: only the smooth term (Laplace density terms are not included)
+         d_vector w( fix_like_fun.Range() );
+         for(size_t i = 0; i < w.size(); ++i)
+            w[i] = 0.0;
+         w[0] = 1.0;
+         hes_vec = [&fix_like_fun, w, this]
+         (const d_vector& x, d_vector& y)
+         {  fix_like_fun.Forward(1, x);
+            d_vector dw = fix_like_fun.Reverse(2, w);
+            for(size_t j = 0; j < n_fixed_; ++j)
+               y[j] = dw[j * 2 + 0];
+         };
+      }
+      // sample fixed effects using Hessian vector products
+      msg = sample_fixed_lanczos(
+         lanczos_step,
          sample_fix,
-         hes_fixed_obj_rcv,
-         solution,
-         cppad_mixed_fixed_lower,
-         cppad_mixed_fixed_upper,
-         rcond
+         hes_vec,
+         cppad_mixed_fixed_vec,
+         fixed_lower,
+         fixed_upper,
+         option_map
       );
-      std::string str   = get_str_map(option_map, "asymptotic_rcond_lower");
-      double      lower = std::stod( str );
-      str               = get_str_map(option_map, "print_level_fixed");
-      int         level = std::stoi( str );
-      if( 0 < level )
-         std::cout << "sample_fixd: rcond = " << rcond << "\n";
-      if( rcond < lower )
-      {  str  = "sample_fixed: rcond = " + CppAD::to_string(rcond);
-         str += "\nis less than asymptotic_rcond_lower = ";
-         str += CppAD::to_string(lower);
-         if( msg == "" )
-            msg = str;
-         else
-            msg += "\n" + str;
-      }
-   }
-   catch(const std::exception& e)
-   {  std::string message("sample_command: std::exception: ");
-      message += e.what();
-      dismod_at::error_exit(message);
    }
-   catch(const CppAD::mixed::exception& e)
-   {  std::string catcher("sample_command");
-      msg = e.message(catcher);
-      log_message(db_, &std::cerr, "warning", msg);
-      // this case becomes a fatal error after Hessians are stored
-      assert( sample_out.size() == 0 );
-      return;
+   else
+   {
+      try {
+         // sample fixed effects
+         double rcond = std::numeric_limits<double>::quiet_NaN();
+         msg = sample_fixed(
+            sample_fix,
+            hes_fixed_obj_rcv,
+            solution,
+            cppad_mixed_fixed_lower,
+            cppad_mixed_fixed_upper,
+            rcond
+         );
+         std::string str   = get_str_map(option_map, "asymptotic_rcond_lower");
+         double      lower = std::stod( str );
+         str               = get_str_map(option_map, "print_level_fixed");
+         int         level = std::stoi( str );
+         if( 0 < level )
+            std::cout << "sample_fixd: rcond = " << rcond << "\n";
+         if( rcond < lower )
+         {  str  = "sample_fixed: rcond = " + CppAD::to_string(rcond);
+            str += "\nis less than asymptotic_rcond_lower = ";
+            str += CppAD::to_string(lower);
+            if( msg == "" )
+               msg = str;
+            else
+               msg += "\n" + str;
+         }
+      }
+      catch(const std::exception& e)
+      {  std::string message("sample_command: std::exception: ");
+         message += e.what();
+         dismod_at::error_exit(message);
+      }
+      catch(const CppAD::mixed::exception& e)
+      {  std::string catcher("sample_command");
+         msg = e.message(catcher);
+         log_message(db_, &std::cerr, "warning", msg);
+         // this case becomes a fatal error after Hessians are stored
+         assert( sample_out.size() == 0 );
+         return;
+      }
    }
    if( msg != "" )
    {  log_message(db_, &std::cerr, "warning", msg);
@@ -1161,10 +1553,10 @@ void fit_model::sample_posterior(
    unpack_random(pack_object_, start_var_, random_in);
    //
    // convert from dismod_at random effects to cppad_mixed random effects
-   d_vector cppad_mixed_random_in    = random_const_.remove( random_in );
+   d_vector cppad_mixed_random_in    = remove_random( random_in );
    //
    // set lower and upper limits to infinity for cppad_mixed random effects
-   size_t cppad_mixed_n_random = n_random_ - n_random_equal_;
+   size_t cppad_mixed_n_random = mixed2var_.size();
    d_vector cppad_mixed_random_lower(cppad_mixed_n_random);
    d_vector cppad_mixed_random_upper(cppad_mixed_n_random);
    for(size_t i = 0; i < cppad_mixed_n_random; ++i)
@@ -1225,7 +1617,7 @@ void fit_model::sample_posterior(
       {  cppad_mixed_one_sample_random[j] =
          cppad_mixed_sample_random[ i_sample * cppad_mixed_n_random + j];
       }
-      one_sample_random = random_const_.restore(
+      one_sample_random = restore_random(
          cppad_mixed_one_sample_random
       );
       unscale_fixed_effect(cppad_mixed_one_sample_fixed, one_sample_fixed);
@@ -1240,6 +1632,1052 @@ void fit_model::sample_posterior(
    }
    return;
 }
+/*
+------------------------------------------------------------------------------
+{xrst_begin fit_model_sample_mcmc dev}
+{xrst_spell
+  leapfrog
+}
+
+Sample From Posterior Using Hamiltonian Monte Carlo
+###################################################
+
+Syntax
+******
+
+| *fit_object* . ``sample_mcmc`` (
+| |tab| *n_sample* ,
+| |tab| *sample_out* ,
+| |tab| *acceptance_out* ,
+| |tab| *step_size_out* ,
+| |tab| *fit_var_value* ,
+| |tab| *option_map*
+| )
+
+Target Distribution
+*******************
+The chains sample the joint posterior for the fixed effects and the
+random effects that are not constant; i.e., the random effects are not
+integrated out using the Laplace approximation.
+The negative log of this density is the sum of the fixed and random
+likelihood terms that cppad_mixed uses during optimization
+(the :ref:`data_like-name` terms and the priors for all the model variables).
+Note that this includes the Laplace density terms.
+The fixed effects that are log scaled during optimization are also log scaled
+during sampling and the corresponding Jacobian is included in the density.
+If random effects are eliminated using the sum-to-zero basis; see
+:ref:`option_table@Zero Sum Constraints@zero_sum_basis` ,
+the chains sample the remaining random effects.
+
+Method
+******
+Each chain uses static Hamiltonian Monte Carlo with a diagonal mass matrix.
+The number of leapfrog steps in each trajectory is chosen uniformly
+between one and
+:ref:`option_table@Markov Chain Monte Carlo@mcmc_number_leapfrog` ;
+i.e., this is not the No-U-Turn sampler and the trajectory length
+is not adapted.
+
+Warmup
+======
+During the first
+:ref:`option_table@Markov Chain Monte Carlo@mcmc_number_warmup`
+iterations of a chain, the step size is adapted using dual averaging
+with a target acceptance probability of 0.8.
+The diagonal of the mass matrix is set to the inverse of the variance
+of the draws between 15 and 90 percent of the warmup iterations.
+
+Bounds
+======
+The lower and upper limits for the model variables are enforced by
+reflecting the trajectory at the limits.
+The :ref:`prior_table@lower` and :ref:`prior_table@upper` limits
+for age and time differences are ignored.
+
+Chains
+******
+The number of chains *n_chain* is
+:ref:`option_table@Markov Chain Monte Carlo@mcmc_number_chain` .
+All the chains start at *fit_var_value* .
+Each chain has its own random number generator which is seeded using
+the :ref:`manage_gsl_rng-name` generator before any chain is run.
+Hence the samples are determined by the
+:ref:`option_table@random_seed` .
+
+Threads
+=======
+The chains are run using :ref:`parallel_loop-name` with the minimum of
+*n_chain* and :ref:`option_table@number_thread` threads.
+Chain *c* is run by thread *c* % *n_thread* .
+The AD function for the density is recorded once and
+each thread uses its own copy of this function.
+The samples do not depend on the number of threads.
+
+n_sample
+********
+Is the total number of samples to generate; it must be a multiple
+of *n_chain* .
+Each chain generates *n_draw* = *n_sample* / *n_chain* samples.
+
+sample_out
+**********
+The input size value of this argument does not matter.
+If an error occurs (the samples cannot be calculated)
+*sample_out.size* () is zero upon return.
+Otherwise upon return *sample_out.size* () is
+equal to *n_sample* times the number of
+:ref:`model_variables-name` *n_var* .
+For *i* = 0 , ... , *n_sample* ``-1`` ,
+*j* = 0 , ... , *n_var* ``-1`` ,
+
+   *sample_out* [ *i* * *n_var* + *j*  ]
+
+is the *j*-th component of the *i*-th sample of the model variables.
+The samples for chain *c* have index
+*i* = *c* * *n_draw* , ... , ( *c* + 1 ) * *n_draw* ``-1`` .
+
+acceptance_out
+**************
+The input size value of this argument does not matter.
+Upon return it has size *n_chain* and *acceptance_out* [ *c* ]
+is the average acceptance probability for the draws in chain *c*
+(not including warmup).
+
+step_size_out
+*************
+The input size value of this argument does not matter.
+Upon return it has size *n_chain* and *step_size_out* [ *c* ]
+is the leapfrog step size used after warmup by chain *c* .
+
+fit_var_value
+*************
+This vector has size equal to the number of model variables.
+It is the optimal :ref:`variable values<model_variables-name>` in
+:ref:`pack_info-name` order.
+
+option_map
+**********
+This is the option map; the Markov Chain Monte Carlo options
+are used by this routine.
+
+Prototype
+*********
+{xrst_spell_off}
+{xrst_code cpp} */
+void fit_model::sample_mcmc(
+   size_t                                    n_sample           ,
+   CppAD::vector<double>&                    sample_out         ,
+   CppAD::vector<double>&                    acceptance_out     ,
+   CppAD::vector<double>&                    step_size_out      ,
+   const CppAD::vector<double>&              fit_var_value      ,
+   const std::map<std::string, std::string>& option_map         )
+/* {xrst_code}
+{xrst_spell_on}
+
+{xrst_end fit_model_sample_mcmc}
+*/
+{  size_t n_var = n_fixed_ + n_random_;
+   assert( fit_var_value.size() == n_var );
+   //
+   // initialize sample_out as empty
+   sample_out.resize(0);
+   //
+   // warning
+   std::ostream* os = DISMOD_AT_NULL_PTR;
+   if( warn_on_stderr_ )
+      os = &std::cerr;
+   //
+   // n_chain, n_warmup, n_leapfrog
+   size_t n_chain = size_t( std::atoi(
+      get_str_map(option_map, "mcmc_number_chain").c_str()
+   ) );
+   size_t n_warmup = size_t( std::atoi(
+      get_str_map(option_map, "mcmc_number_warmup").c_str()
+   ) );
+   size_t n_leapfrog = size_t( std::atoi(
+      get_str_map(option_map, "mcmc_number_leapfrog").c_str()
+   ) );
+   assert( n_chain > 0 && n_leapfrog > 0 );
+   assert( n_sample % n_chain == 0 );
+   //
+   // n_draw, acceptance_out, step_size_out
+   size_t n_draw = n_sample / n_chain;
+   acceptance_out.resize(n_chain);
+   step_size_out.resize(n_chain);
+   //
+   // var_lower, var_upper
+   d_vector var_lower(n_var), var_upper(n_var);
+   get_var_limits(
+      var_lower, var_upper, var2prior_, prior_table_
+   );
+   //
+   // n_mixed, n_x
+   // x = [ fixed effects in scaled space , cppad_mixed random effects ]
+   size_t n_mixed = mixed2var_.size();
+   size_t n_x     = n_fixed_ + n_mixed;
+   //
+   // x_lower, x_upper, x_start
+   d_vector x_lower(n_x), x_upper(n_x), x_start(n_x);
+   {  d_vector fixed_lower(n_fixed_), fixed_upper(n_fixed_);
+      d_vector fixed_start(n_fixed_);
+      unpack_fixed(pack_object_, var_lower, fixed_lower);
+      unpack_fixed(pack_object_, var_upper, fixed_upper);
+      unpack_fixed(pack_object_, fit_var_value, fixed_start);
+      for(size_t j = 0; j < n_fixed_; ++j)
+      {  fixed_start[j] = std::max(fixed_lower[j], fixed_start[j]);
+         fixed_start[j] = std::min(fixed_upper[j], fixed_start[j]);
+      }
+      scale_fixed_effect(fixed_lower, fixed_lower);
+      scale_fixed_effect(fixed_upper, fixed_upper);
+      scale_fixed_effect(fixed_start, fixed_start);
+      //
+      d_vector random_start(n_random_);
+      unpack_random(pack_object_, fit_var_value, random_start);
+      d_vector mixed_lower = remove_random( random_lower_ );
+      d_vector mixed_upper = remove_random( random_upper_ );
+      d_vector mixed_start = remove_random( random_start );
+      //
+      for(size_t j = 0; j < n_fixed_; ++j)
+      {  x_lower[j] = fixed_lower[j];
+         x_upper[j] = fixed_upper[j];
+         x_start[j] = fixed_start[j];
+      }
+      for(size_t i = 0; i < n_mixed; ++i)
+      {  size_t j = n_fixed_ + i;
+         x_lower[j] = mixed_lower[i];
+         x_upper[j] = mixed_upper[i];
+         x_start[j] = std::max(x_lower[j], mixed_start[i]);
+         x_start[j] = std::min(x_upper[j], x_start[j]);
+      }
+   }
+   //
+   // free: components of x that are not constant
+   CppAD::vector<size_t> free;
+   for(size_t j = 0; j < n_x; ++j)
+      if( x_lower[j] < x_upper[j] )
+         free.push_back(j);
+   size_t n_free = free.size();
+   //
+   // joint_fun
+   // negative log of the joint posterior density as a function of x
+   CppAD::ADFun<double> joint_fun;
+   {  a1_vector a1_x(n_x), a1_fixed(n_fixed_), a1_mixed(n_mixed);
+      for(size_t j = 0; j < n_x; ++j)
+         a1_x[j] = x_start[j];
+      CppAD::Independent(a1_x);
+      for(size_t j = 0; j < n_fixed_; ++j)
+         a1_fixed[j] = a1_x[j];
+      for(size_t i = 0; i < n_mixed; ++i)
+         a1_mixed[i] = a1_x[n_fixed_ + i];
+      //
+      a1_vector a1_y(1);
+      a1_vector fix_den = fix_likelihood(a1_fixed);
+      a1_y[0] = fix_den[0];
+      for(size_t k = 1; k < fix_den.size(); ++k)
+         a1_y[0] += CppAD::abs( fix_den[k] );
+      a1_vector ran_den = ran_likelihood(a1_fixed, a1_mixed);
+      if( ran_den.size() > 0 )
+         a1_y[0] += ran_den[0];
+      //
+      // Jacobian of the log scaling; see fixed_scale_eta_
+      for(size_t j = 0; j < n_fixed_; ++j)
+         if( fixed_is_scaled_[j] && x_lower[j] < x_upper[j] )
+            a1_y[0] -= a1_fixed[j];
+      joint_fun.Dependent(a1_x, a1_y);
+   }
+   //
+   // check the starting value for the chains
+   if( ! std::isfinite( joint_fun.Forward(0, x_start)[0] ) )
+   {  std::string msg = "sample mcmc: the posterior density is not ";
+      msg += "finite at the values in the fit_var table";
+      log_message(db_, os, "warning", msg);
+      return;
+   }
+   //
+   // chain_seed
+   // all the seeds are drawn before any chain is run
+   gsl_rng* global_rng = CppAD::mixed::get_gsl_rng();
+   CppAD::vector<unsigned long> chain_seed(n_chain);
+   for(size_t c = 0; c < n_chain; ++c)
+      chain_seed[c] = gsl_rng_get(global_rng);
+   //
+   // sample_out
+   sample_out.resize(n_sample * n_var);
+   //
+   // run_chain
+   // Runs chain c using fun, a copy of joint_fun that is only used by the
+   // current thread. This does not use the database or log messages.
+   auto run_chain = [&](size_t c, CppAD::ADFun<double>& fun)
+   {  //
+      // potential: value and gradient of fun
+      d_vector w(1);
+      w[0] = 1.0;
+      auto potential = [&](const d_vector& x, d_vector& grad)
+      {  double U = fun.Forward(0, x)[0];
+         grad     = fun.Reverse(1, w);
+         return U;
+      };
+      //
+      gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+      gsl_rng_set(rng, chain_seed[c]);
+      //
+      // x, grad, U: current state of this chain
+      d_vector x = x_start, grad(n_x);
+      double   U = potential(x, grad);
+      //
+      // inv_mass: diagonal of the inverse of the mass matrix
+      d_vector inv_mass(n_x);
+      for(size_t j = 0; j < n_x; ++j)
+         inv_mass[j] = 1.0;
+      //
+      // trajectory
+      // leapfrog trajectory with n_step steps of size eps starting at x;
+      // returns the acceptance probability for the final state
+      auto trajectory = [&](
+         double    eps      ,
+         size_t    n_step   ,
+         d_vector& x_new    ,
+         d_vector& grad_new ,
+         double&   U_new    )
+      {  d_vector p(n_x);
+         double kinetic = 0.0;
+         for(size_t k = 0; k < n_free; ++k)
+         {  size_t j = free[k];
+            p[j]     = gsl_ran_gaussian(rng, 1.0 / std::sqrt(inv_mass[j]) );
+            kinetic += 0.5 * inv_mass[j] * p[j] * p[j];
+         }
+         double H0    = U + kinetic;
+         U_new        = U;
+         x_new        = x;
+         grad_new     = grad;
+         for(size_t s = 0; s < n_step && std::isfinite(U_new); ++s)
+         {  for(size_t k = 0; k < n_free; ++k)
+            {  size_t j  = free[k];
+               p[j]     -= 0.5 * eps * grad_new[j];
+               x_new[j] += eps * inv_mass[j] * p[j];
+               //
+               // reflect at the bounds
+               for(size_t n_reflect = 0; n_reflect < 100; ++n_reflect)
+               {  if( x_new[j] < x_lower[j] )
+                     x_new[j] = 2.0 * x_lower[j] - x_new[j];
+                  else if( x_new[j] > x_upper[j] )
+                     x_new[j] = 2.0 * x_upper[j] - x_new[j];
+                  else
+                     break;
+                  p[j] = - p[j];
+               }
+               x_new[j] = std::max(x_lower[j], x_new[j]);
+               x_new[j] = std::min(x_upper[j], x_new[j]);
+            }
+            U_new = potential(x_new, grad_new);
+            for(size_t k = 0; k < n_free; ++k)
+            {  size_t j = free[k];
+               p[j]    -= 0.5 * eps * grad_new[j];
+            }
+         }
+         kinetic = 0.0;
+         for(size_t k = 0; k < n_free; ++k)
+         {  size_t j = free[k];
+            kinetic += 0.5 * inv_mass[j] * p[j] * p[j];
+         }
+         double H1 = U_new + kinetic;
+         if( ! std::isfinite(H1) )
+            return 0.0;
+         return std::min(1.0, std::exp(H0 - H1) );
+      };
+      //
+      // transition: one Metropolis step using a trajectory
+      auto transition = [&](double eps)
+      {  size_t   n_step = 1 + gsl_rng_uniform_int(rng, n_leapfrog);
+         d_vector x_new(n_x), grad_new(n_x);
+         double   U_new;
+         double   alpha  = trajectory(eps, n_step, x_new, grad_new, U_new);
+         if( gsl_rng_uniform(rng) < alpha )
+         {  x    = x_new;
+            grad = grad_new;
+            U    = U_new;
+         }
+         return alpha;
+      };
+      //
+      // find_step
+      // double or halve the step size until the acceptance probability
+      // for one leapfrog step crosses 0.5
+      auto find_step = [&](void)
+      {  double eps = 1.0;
+         if( n_free == 0 )
+            return eps;
+         d_vector x_new(n_x), grad_new(n_x);
+         double U_new;
+         double alpha     = trajectory(eps, 1, x_new, grad_new, U_new);
+         double direction = alpha > 0.5 ? 2.0 : 0.5;
+         for(size_t k = 0; k < 50; ++k)
+         {  if( direction > 1.0 && alpha <= 0.5 )
+               break;
+            if( direction < 1.0 && alpha >= 0.5 )
+               break;
+            eps   = eps * direction;
+            alpha = trajectory(eps, 1, x_new, grad_new, U_new);
+         }
+         return eps;
+      };
+      // ---------------------------------------------------------------
+      // warmup
+      double eps         = find_step();
+      double mu          = std::log(10.0 * eps);
+      double h_bar       = 0.0;
+      double log_eps_bar = 0.0;
+      size_t n_adapt     = 0;
+      //
+      // window for estimating the variance of x
+      size_t window_begin = (15 * n_warmup) / 100;
+      size_t window_end   = (90 * n_warmup) / 100;
+      size_t n_window     = 0;
+      d_vector x_mean(n_x), x_m2(n_x);
+      for(size_t j = 0; j < n_x; ++j)
+      {  x_mean[j] = 0.0;
+         x_m2[j]   = 0.0;
+      }
+      for(size_t iter = 0; iter < n_warmup; ++iter)
+      {  double alpha = transition(eps);
+         //
+         // dual averaging of the step size
+         ++n_adapt;
+         double m      = double(n_adapt);
+         h_bar         = (1.0 - 1.0 / (m + 10.0)) * h_bar
+                       + (0.8 - alpha) / (m + 10.0);
+         double log_eps = mu - std::sqrt(m) * h_bar / 0.05;
+         double weight  = std::pow(m, -0.75);
+         log_eps_bar    = weight * log_eps + (1.0 - weight) * log_eps_bar;
+         eps            = std::exp(log_eps);
+         //
+         // running mean and variance of x
+         if( window_begin <= iter && iter < window_end )
+         {  ++n_window;
+            for(size_t k = 0; k < n_free; ++k)
+            {  size_t j   = free[k];
+               double d1  = x[j] - x_mean[j];
+               x_mean[j] += d1 / double(n_window);
+               x_m2[j]   += d1 * (x[j] - x_mean[j]);
+            }
+         }
+         //
+         // set mass matrix and restart step size adaptation
+         if( iter + 1 == window_end && n_window >= 10 )
+         {  double n = double(n_window);
+            for(size_t k = 0; k < n_free; ++k)
+            {  size_t j   = free[k];
+               double var = x_m2[j] / (n - 1.0);
+               // shrink towards a small value (as in Stan)
+               inv_mass[j] = (n / (n + 5.0)) * var + 1e-3 * (5.0 / (n + 5.0));
+            }
+            eps         = find_step();
+            mu          = std::log(10.0 * eps);
+            h_bar       = 0.0;
+            log_eps_bar = 0.0;
+            n_adapt     = 0;
+         }
+      }
+      if( n_adapt > 0 )
+         eps = std::exp(log_eps_bar);
+      // ---------------------------------------------------------------
+      // draws
+      d_vector x_fixed(n_fixed_), x_mixed(n_mixed), fixed_vec(n_fixed_);
+      d_vector pack_vec(n_var);
+      double sum_alpha = 0.0;
+      for(size_t i = 0; i < n_draw; ++i)
+      {  sum_alpha += transition(eps);
+         //
+         // pack_vec
+         for(size_t j = 0; j < n_fixed_; ++j)
+            x_fixed[j] = x[j];
+         for(size_t k = 0; k < n_mixed; ++k)
+            x_mixed[k] = x[n_fixed_ + k];
+         unscale_fixed_effect(x_fixed, fixed_vec);
+         d_vector random_vec = restore_random(x_mixed);
+         pack_fixed(pack_object_, pack_vec, fixed_vec);
+         pack_random(pack_object_, pack_vec, random_vec);
+         //
+         // copy to output vector
+         size_t sample_index = c * n_draw + i;
+         for(size_t var_id = 0; var_id < n_var; ++var_id)
+            sample_out[ sample_index * n_var + var_id ] = pack_vec[var_id];
+      }
+      acceptance_out[c] = sum_alpha / double(n_draw);
+      step_size_out[c]  = eps;
+      gsl_rng_free(rng);
+   };
+   //
+   // n_thread
+   size_t n_thread = size_t( std::atoi(
+      get_str_map(option_map, "number_thread").c_str()
+   ) );
+   n_thread = std::max( size_t(1), std::min(n_thread, n_chain) );
+   //
+   // run the chains, chain c is run by thread c % n_thread
+   parallel_loop(n_thread, [&](size_t thread)
+   {  CppAD::ADFun<double> fun;
+      fun = joint_fun;
+      for(size_t c = thread; c < n_chain; c += n_thread)
+         run_chain(c, fun);
+   } );
+   return;
+}
+// ---------------------------------------------------------------------------
+// sample_fixed_lanczos
+// samples of the fixed effects, in cppad_mixed (scaled) space, using
+// lanczos_sample and the Hessian vector products hes_fixed_vec for all
+// the fixed effects; returns an error message (empty if no error).
+std::string fit_model::sample_fixed_lanczos(
+   size_t                                    n_step             ,
+   CppAD::vector<double>&                    sample_fix         ,
+   const std::function<void(
+      const CppAD::vector<double>&, CppAD::vector<double>&
+   )>&                                       hes_fixed_vec      ,
+   const CppAD::vector<double>&              fixed_opt          ,
+   const CppAD::vector<double>&              fixed_lower        ,
+   const CppAD::vector<double>&              fixed_upper        ,
+   const std::map<std::string, std::string>& option_map         )
+{  size_t n_sample = sample_fix.size() / n_fixed_;
+   assert( n_sample * n_fixed_ == sample_fix.size() );
+   //
+   // fixed2free, n_free
+   // constant fixed effects are not sampled
+   CppAD::vector<size_t> fixed2free(n_fixed_);
+   size_t n_free = 0;
+   for(size_t j = 0; j < n_fixed_; ++j)
+   {  if( fixed_lower[j] < fixed_upper[j] )
+         fixed2free[j] = n_free++;
+      else
+         fixed2free[j] = n_fixed_;
+   }
+   //
+   // hes_vec: y = H * x for the free fixed effects
+   CppAD::vector<double> x_fixed(n_fixed_), y_fixed(n_fixed_);
+   auto hes_vec = [&](const CppAD::vector<double>& x, CppAD::vector<double>& y)
+   {  for(size_t j = 0; j < n_fixed_; ++j)
+      {  x_fixed[j] = 0.0;
+         if( fixed2free[j] < n_fixed_ )
+            x_fixed[j] = x[ fixed2free[j] ];
+      }
+      hes_fixed_vec(x_fixed, y_fixed);
+      for(size_t j = 0; j < n_fixed_; ++j)
+      {  if( fixed2free[j] < n_fixed_ )
+            y[ fixed2free[j] ] = y_fixed[j];
+      }
+   };
+   //
+   // asymptotic_rcond_lower, print_level_fixed
+   std::string str   = get_str_map(option_map, "asymptotic_rcond_lower");
+   double      lower = std::stod( str );
+   str               = get_str_map(option_map, "print_level_fixed");
+   int         level = std::stoi( str );
+   //
+   // sample_fix
+   gsl_rng* rng = CppAD::mixed::get_gsl_rng();
+   CppAD::vector<double> z(n_free), sample(n_free), ritz;
+   for(size_t i_sample = 0; i_sample < n_sample; ++i_sample)
+   {  if( n_free > 0 )
+      {  for(size_t i = 0; i < n_free; ++i)
+            z[i] = gsl_ran_gaussian(rng, 1.0);
+         std::string msg = lanczos_sample(n_step, hes_vec, z, sample, ritz);
+         if( msg != "" )
+            return msg;
+         //
+         // check and report the retained spectrum for first sample
+         if( i_sample == 0 )
+         {  double rcond = ritz[0] / ritz[ ritz.size() - 1 ];
+            if( 0 < level )
+            {  std::cout << "sample_fixed_lanczos: ritz =";
+               for(size_t k = 0; k < ritz.size(); ++k)
+                  std::cout << " " << ritz[k];
+               std::cout << "\nsample_fixed_lanczos: rcond = " << rcond;
+               std::cout << "\n";
+            }
+            if( rcond < lower )
+            {  msg  = "sample_fixed_lanczos: rcond = ";
+               msg += CppAD::to_string(rcond);
+               msg += "\nis less than asymptotic_rcond_lower = ";
+               msg += CppAD::to_string(lower);
+               return msg;
+            }
+         }
+      }
+      for(size_t j = 0; j < n_fixed_; ++j)
+      {  double value = fixed_opt[j];
+         if( fixed2free[j] < n_fixed_ )
+            value += sample[ fixed2free[j] ];
+         sample_fix[ i_sample * n_fixed_ + j ] = value;
+      }
+   }
+   return "";
+}
+// ---------------------------------------------------------------------------
+// remove_random
+// convert from dismod_at random effects to cppad_mixed random effects
+template <class Float>
+CppAD::vector<Float> fit_model::remove_random(
+   const CppAD::vector<Float>& random_vec ) const
+{  CppAD::vector<Float> var_vec = random_const_.remove( random_vec );
+   CppAD::vector<Float> mixed_vec( mixed2var_.size() );
+   for(size_t i = 0; i < mixed2var_.size(); ++i)
+      mixed_vec[i] = var_vec[ mixed2var_[i] ];
+   return mixed_vec;
+}
+// ---------------------------------------------------------------------------
+// restore_random
+// convert from cppad_mixed random effects to dismod_at random effects
+template <class Float>
+CppAD::vector<Float> fit_model::restore_random(
+   const CppAD::vector<Float>& mixed_vec ) const
+{  assert( mixed_vec.size() == mixed2var_.size() );
+   CppAD::vector<Float> var_vec( var2mixed_.size() );
+   for(size_t i = 0; i < mixed2var_.size(); ++i)
+      var_vec[ mixed2var_[i] ] = mixed_vec[i];
+   //
+   // random effects eliminated using the sum-to-zero basis
+   for(size_t k = 0; k < zero_sum_last_.size(); ++k)
+   {  Float sum = Float(0.0);
+      for(size_t ell = zero_sum_start_[k]; ell < zero_sum_start_[k+1]; ++ell)
+         sum += var_vec[ zero_sum_other_[ell] ];
+      var_vec[ zero_sum_last_[k] ] = - sum;
+   }
+   return random_const_.restore( var_vec );
+}
+// ---------------------------------------------------------------------------
+// mixed_random2var_id
+// mapping from cppad_mixed random effect index to dismod_at variable index
+CppAD::vector<size_t> fit_model::mixed_random2var_id(void) const
+{  CppAD::vector<size_t> random2var   = random2var_id(pack_object_);
+   const CppAD::vector<size_t>& var2both = random_const_.var2both_index();
+   CppAD::vector<size_t> result( mixed2var_.size() );
+   for(size_t i = 0; i < mixed2var_.size(); ++i)
+      result[i] = random2var[ var2both[ mixed2var_[i] ] ];
+   return result;
+}
+// ---------------------------------------------------------------------------
+// gauss_newton_fixed
+// Improves the starting fixed effects (scaled) and random effects (cppad_mixed)
+// using at most max_iter damped Gauss-Newton steps for the joint negative
+// log-density of the fixed and random effects. This is a starting value
+// for optimize_fixed; the Laplace log-determinant term is not included.
+// The zero sum constraints on the random effects (when they are not
+// eliminated using the sum-to-zero basis) are satisfied by each step, and
+// the meas_noise covariate multipliers are held at their starting values
+// when there are random effects.
+// Returns false, and does not change its arguments,
+// if the data are not all in the Gaussian family or a prior is not smooth.
+bool fit_model::gauss_newton_fixed(
+   size_t                                    max_iter           ,
+   double                                    tolerance          ,
+   const CppAD::vector<double>&              fixed_lower        ,
+   const CppAD::vector<double>&              fixed_upper        ,
+   const CppAD::vector<double>&              random_lower       ,
+   const CppAD::vector<double>&              random_upper       ,
+   CppAD::vector<double>&                    fixed_in           ,
+   CppAD::vector<double>&                    random_in          )
+{  typedef CppAD::vector<size_t>                          s_vector;
+   typedef CppAD::vector<double>                          d_vector;
+   typedef CppAD::sparse_rc<s_vector>                     sparsity_pattern;
+   typedef CppAD::sparse_rcv<s_vector, d_vector>          sparse_matrix;
+   //
+   if( max_iter == 0 )
+      return false;
+   //
+   // n_mixed, n_x
+   // x = (fixed effects, cppad_mixed random effects)
+   size_t n_mixed = mixed2var_.size();
+   size_t n_x     = n_fixed_ + n_mixed;
+   assert( random_in.size() == n_mixed );
+   //
+   // x_lower, x_upper, x_cur
+   d_vector x_lower(n_x), x_upper(n_x), x_cur(n_x);
+   for(size_t j = 0; j < n_x; ++j)
+   {  if( j < n_fixed_ )
+      {  x_lower[j] = fixed_lower[j];
+         x_upper[j] = fixed_upper[j];
+         x_cur[j]   = fixed_in[j];
+      }
+      else
+      {  x_lower[j] = random_lower[j - n_fixed_];
+         x_upper[j] = random_upper[j - n_fixed_];
+         x_cur[j]   = random_in[j - n_fixed_];
+      }
+      x_cur[j] = std::max(x_lower[j], x_cur[j]);
+      x_cur[j] = std::min(x_upper[j], x_cur[j]);
+   }
+   //
+   // hold
+   // The joint negative log-density, without the Laplace term, is reduced by
+   // shrinking the data standard deviations while the random effects fit the
+   // data. Hence the meas_noise covariate multipliers are not changed when
+   // there are random effects.
+   CppAD::vector<bool> hold(n_x);
+   for(size_t j = 0; j < n_x; ++j)
+      hold[j] = false;
+   if( n_mixed > 0 )
+   {  size_t n_integrand = pack_object_.integrand_size();
+      for(size_t integrand_id = 0; integrand_id < n_integrand; ++integrand_id)
+      {  size_t n_cov = pack_object_.group_meas_noise_n_cov(integrand_id);
+         for(size_t j = 0; j < n_cov; ++j)
+         {  pack_info::subvec_info info =
+               pack_object_.group_meas_noise_info(integrand_id, j);
+            for(size_t k = 0; k < info.n_var; ++k)
+            {  size_t fixed_id = var_id2fixed_[ info.offset + k ];
+               if( fixed_id < n_fixed_ )
+                  hold[fixed_id] = true;
+            }
+         }
+      }
+   }
+   //
+   // project
+   // For each zero sum constraint, subtract the average of the components
+   // of v that are in the constraint and have is_free true from those
+   // components. If v[j] is zero when is_free[j] is false, the result is
+   // in the null space of the constraints.
+   auto project = [&](const CppAD::vector<bool>& is_free, d_vector& v)
+   {  size_t n_con = zero_sum_con_.nr();
+      if( n_con == 0 )
+         return;
+      d_vector sum(n_con);
+      s_vector count(n_con);
+      for(size_t i = 0; i < n_con; ++i)
+      {  sum[i]   = 0.0;
+         count[i] = 0;
+      }
+      for(size_t k = 0; k < zero_sum_con_.nnz(); ++k)
+      {  size_t i = zero_sum_con_.row()[k];
+         size_t j = n_fixed_ + zero_sum_con_.col()[k];
+         if( is_free[j] )
+         {  sum[i] += v[j];
+            ++count[i];
+         }
+      }
+      for(size_t k = 0; k < zero_sum_con_.nnz(); ++k)
+      {  size_t i = zero_sum_con_.row()[k];
+         size_t j = n_fixed_ + zero_sum_con_.col()[k];
+         if( is_free[j] )
+            v[j] -= sum[i] / double( count[i] );
+      }
+   };
+   //
+   // all_free
+   CppAD::vector<bool> all_free(n_x);
+   for(size_t j = 0; j < n_x; ++j)
+      all_free[j] = true;
+   //
+   // x_cur: satisfies the zero sum constraints
+   project(all_free, x_cur);
+   //
+   // obj_fun, prior_fun, n_wres
+   // obj_fun(x)   = [ objective , weighted data residuals , scoring terms ]
+   // prior_fun(x) = prior part of objective
+   // The scoring term for a data residual is sqrt(2) times the log of its
+   // standard deviation (plus a constant). Its Jacobian is the expected
+   // information for the standard deviation when it depends on the model
+   // variables; e.g., log_gaussian data with a meas_noise_effect.
+   CppAD::ADFun<double> obj_fun, prior_fun;
+   size_t n_wres = 0;
+   for(size_t i_fun = 0; i_fun < 2; ++i_fun)
+   {  a1_vector a1_x(n_x), a1_fixed(n_fixed_), a1_mixed(n_mixed);
+      a1_vector a1_pack_vec( pack_object_.size() );
+      for(size_t j = 0; j < n_x; ++j)
+         a1_x[j] = x_cur[j];
+      CppAD::Independent(a1_x);
+      for(size_t j = 0; j < n_fixed_; ++j)
+         a1_fixed[j] = a1_x[j];
+      for(size_t j = 0; j < n_mixed; ++j)
+         a1_mixed[j] = a1_x[n_fixed_ + j];
+      a1_vector fixed_tmp(n_fixed_);
+      unscale_fixed_effect(a1_fixed, fixed_tmp);
+      a1_vector random_vec = restore_random(a1_mixed);
+      pack_fixed(pack_object_, a1_pack_vec, fixed_tmp);
+      pack_random(pack_object_, a1_pack_vec, random_vec);
+      //
+      // prior_all
+      CppAD::vector< residual_struct<a1_double> > prior_all =
+         prior_object_.fixed(a1_pack_vec);
+      CppAD::vector< residual_struct<a1_double> > prior_ran =
+         prior_object_.random(a1_pack_vec);
+      for(size_t i = 0; i < prior_ran.size(); ++i)
+         prior_all.push_back( prior_ran[i] );
+      bool ok = true;
+      for(size_t i = 0; i < prior_all.size(); ++i)
+         ok &= ! nonsmooth_density( prior_all[i].density );
+      //
+      // data_all
+      CppAD::vector< residual_struct<a1_double> > data_all;
+      if( i_fun == 0 )
+      {  bool hold_out = true;
+         for(size_t i_depend = 0; i_depend < 2; ++i_depend)
+         {  bool random_depend = i_depend == 1;
+            CppAD::vector< residual_struct<a1_double> > data_tmp =
+               data_object_.like_all(hold_out, random_depend, a1_pack_vec);
+            for(size_t i = 0; i < data_tmp.size(); ++i)
+            {  density_enum density = data_tmp[i].density;
+               ok &= density == gaussian_enum || density == log_gaussian_enum;
+               data_all.push_back( data_tmp[i] );
+            }
+         }
+      }
+      if( ! ok )
+      {  CppAD::AD<double>::abort_recording();
+         std::ostream* os = DISMOD_AT_NULL_PTR;
+         if( warn_on_stderr_ )
+            os = &std::cerr;
+         std::string msg = "gauss_newton_fixed: not used because ";
+         msg += "a density is not gaussian or log_gaussian for the data, ";
+         msg += "or is not smooth for the priors";
+         log_message(db_, os, "warning", msg);
+         return false;
+      }
+      //
+      // a1_y
+      size_t n_data = data_all.size();
+      a1_vector a1_y( 1 + 2 * n_data );
+      a1_y[0] = 0.0;
+      for(size_t i = 0; i < prior_all.size(); ++i)
+         a1_y[0] -= prior_all[i].logden_smooth;
+      for(size_t i = 0; i < n_data; ++i)
+      {  a1_double wres = data_all[i].wres;
+         a1_y[0]             -= data_all[i].logden_smooth;
+         a1_y[1 + i]          = wres;
+         a1_y[1 + n_data + i] = - sqrt(2.0) *
+            ( data_all[i].logden_smooth + wres * wres / 2.0 );
+      }
+      if( i_fun == 0 )
+      {  obj_fun.Dependent(a1_x, a1_y);
+         n_wres = 2 * n_data;
+      }
+      else
+         prior_fun.Dependent(a1_x, a1_y);
+   }
+   //
+   // pattern_wres
+   // sparsity pattern for the Jacobian of the weighted residuals
+   // and scoring terms (the objective row is not included)
+   sparsity_pattern pattern_wres;
+   {  sparsity_pattern pattern_in(n_x, n_x, n_x);
+      for(size_t j = 0; j < n_x; ++j)
+         pattern_in.set(j, j, j);
+      bool transpose     = false;
+      bool dependency    = false;
+      bool internal_bool = false;
+      sparsity_pattern pattern_out;
+      obj_fun.for_jac_sparsity(
+         pattern_in, transpose, dependency, internal_bool, pattern_out
+      );
+      size_t nnz = 0;
+      for(size_t k = 0; k < pattern_out.nnz(); ++k)
+         if( pattern_out.row()[k] > 0 )
+            ++nnz;
+      pattern_wres.resize(1 + n_wres, n_x, nnz);
+      size_t ell = 0;
+      for(size_t k = 0; k < pattern_out.nnz(); ++k)
+      {  size_t r = pattern_out.row()[k];
+         if( r > 0 )
+            pattern_wres.set(ell++, r, pattern_out.col()[k]);
+      }
+   }
+   sparse_matrix          jac_wres(pattern_wres);
+   CppAD::sparse_jac_work jac_work;
+   //
+   // pattern_prior
+   // sparsity pattern for the Hessian of the prior part of the objective
+   sparsity_pattern pattern_prior;
+   {  CppAD::vector<bool> select_domain(n_x), select_range(1);
+      for(size_t j = 0; j < n_x; ++j)
+         select_domain[j] = true;
+      select_range[0]    = true;
+      bool internal_bool = false;
+      prior_fun.for_hes_sparsity(
+         select_domain, select_range, internal_bool, pattern_prior
+      );
+   }
+   sparse_matrix          hes_prior(pattern_prior);
+   CppAD::sparse_hes_work hes_work;
+   //
+   // obj_cur
+   double obj_cur = obj_fun.Forward(0, x_cur)[0];
+   //
+   // lambda: Levenberg-Marquardt damping
+   double lambda = 1e-3;
+   for(size_t iter = 0; iter < max_iter; ++iter)
+   {  // grad: only first order sweeps of obj_fun are used
+      d_vector w(1 + n_wres);
+      for(size_t i = 0; i <= n_wres; ++i)
+         w[i] = 0.0;
+      w[0] = 1.0;
+      obj_fun.Forward(0, x_cur);
+      d_vector grad = obj_fun.Reverse(1, w);
+      //
+      // is_free: components that are not held at a bound by the gradient
+      // or held at their starting value
+      CppAD::vector<bool> is_free(n_x);
+      for(size_t j = 0; j < n_x; ++j)
+      {  bool at_lower = x_cur[j] <= x_lower[j] && grad[j] > 0.0;
+         bool at_upper = x_cur[j] >= x_upper[j] && grad[j] < 0.0;
+         is_free[j]    = ! (at_lower || at_upper || hold[j]);
+      }
+      //
+      // grad: projected onto the free components and the zero sum constraints
+      for(size_t j = 0; j < n_x; ++j)
+      {  if( ! is_free[j] )
+            grad[j] = 0.0;
+      }
+      project(is_free, grad);
+      double max_grad = 0.0;
+      for(size_t j = 0; j < n_x; ++j)
+         max_grad = std::max(max_grad, std::fabs( grad[j] ) );
+      if( max_grad <= tolerance )
+         break;
+      //
+      // jac_wres, hes_prior
+      size_t      n_group  = n_x;
+      std::string coloring = "cppad";
+      obj_fun.sparse_jac_for(
+         n_group, x_cur, jac_wres, pattern_wres, coloring, jac_work
+      );
+      d_vector weight(1);
+      weight[0] = 1.0;
+      coloring  = "cppad.symmetric";
+      prior_fun.sparse_hes(
+         x_cur, weight, hes_prior, pattern_prior, coloring, hes_work
+      );
+      //
+      // diag: diagonal of J^T J + Hessian of prior part of objective
+      d_vector diag(n_x);
+      for(size_t j = 0; j < n_x; ++j)
+         diag[j] = 0.0;
+      for(size_t k = 0; k < jac_wres.nnz(); ++k)
+      {  double v = jac_wres.val()[k];
+         diag[ jac_wres.col()[k] ] += v * v;
+      }
+      for(size_t k = 0; k < hes_prior.nnz(); ++k)
+      {  if( hes_prior.row()[k] == hes_prior.col()[k] )
+            diag[ hes_prior.col()[k] ] += hes_prior.val()[k];
+      }
+      //
+      // mat_vec(v) = ( J^T J + Hessian of prior + lambda * damping ) * v
+      // restricted to the free components
+      d_vector jv(1 + n_wres);
+      auto mat_vec = [&](const d_vector& v, d_vector& result)
+      {  for(size_t i = 0; i <= n_wres; ++i)
+            jv[i] = 0.0;
+         for(size_t k = 0; k < jac_wres.nnz(); ++k)
+         {  size_t j = jac_wres.col()[k];
+            if( is_free[j] )
+               jv[ jac_wres.row()[k] ] += jac_wres.val()[k] * v[j];
+         }
+         for(size_t j = 0; j < n_x; ++j)
+         {  result[j] = 0.0;
+            if( is_free[j] )
+               result[j] = lambda * (1.0 + std::fabs(diag[j]) ) * v[j];
+         }
+         for(size_t k = 0; k < jac_wres.nnz(); ++k)
+         {  size_t j = jac_wres.col()[k];
+            if( is_free[j] )
+               result[j] += jac_wres.val()[k] * jv[ jac_wres.row()[k] ];
+         }
+         for(size_t k = 0; k < hes_prior.nnz(); ++k)
+         {  size_t r = hes_prior.row()[k];
+            size_t c = hes_prior.col()[k];
+            if( is_free[r] && is_free[c] )
+               result[r] += hes_prior.val()[k] * v[c];
+         }
+         project(is_free, result);
+      };
+      //
+      // step
+      // Jacobi preconditioned conjugate gradient for the damped system
+      // in the null space of the zero sum constraints;
+      // stops at a direction of non-positive curvature.
+      d_vector step(n_x), r(n_x), z(n_x), p(n_x), ap(n_x);
+      double   rz = 0.0, r0 = 0.0;
+      for(size_t j = 0; j < n_x; ++j)
+      {  step[j] = 0.0;
+         r[j]    = - grad[j];
+         z[j]    = r[j] / ( (1.0 + lambda) * (1.0 + std::fabs(diag[j]) ) );
+      }
+      project(is_free, z);
+      for(size_t j = 0; j < n_x; ++j)
+      {  p[j]    = z[j];
+         rz     += r[j] * z[j];
+         r0      = std::max(r0, std::fabs( r[j] ) );
+      }
+      for(size_t i_cg = 0; i_cg < n_x; ++i_cg)
+      {  mat_vec(p, ap);
+         double pap = 0.0;
+         for(size_t j = 0; j < n_x; ++j)
+            pap += p[j] * ap[j];
+         if( pap <= 0.0 )
+         {  if( i_cg == 0 )
+               step = p;
+            break;
+         }
+         double alpha = rz / pap;
+         double r_max = 0.0;
+         for(size_t j = 0; j < n_x; ++j)
+         {  step[j] += alpha * p[j];
+            r[j]    -= alpha * ap[j];
+            r_max    = std::max(r_max, std::fabs( r[j] ) );
+         }
+         if( r_max <= 1e-10 * r0 )
+            break;
+         double rz_new = 0.0;
+         for(size_t j = 0; j < n_x; ++j)
+            z[j] = r[j] / ( (1.0 + lambda) * (1.0 + std::fabs(diag[j]) ) );
+         project(is_free, z);
+         for(size_t j = 0; j < n_x; ++j)
+            rz_new += r[j] * z[j];
+         for(size_t j = 0; j < n_x; ++j)
+            p[j] = z[j] + (rz_new / rz) * p[j];
+         rz = rz_new;
+      }
+      //
+      // x_new, obj_new
+      // backtracking line search along the projected step;
+      // x_new must satisfy the bounds and the zero sum constraints
+      d_vector x_new(n_x);
+      double   obj_new  = obj_cur;
+      bool     accepted = false;
+      double   t        = 1.0;
+      for(size_t n_try = 0; n_try < 10 && ! accepted; ++n_try)
+      {  for(size_t j = 0; j < n_x; ++j)
+         {  x_new[j] = std::max(x_lower[j], x_cur[j] + t * step[j]);
+            x_new[j] = std::min(x_upper[j], x_new[j]);
+         }
+         project(all_free, x_new);
+         bool in_bounds = true;
+         for(size_t j = 0; j < n_x; ++j)
+         {  in_bounds &= x_lower[j] <= x_new[j];
+            in_bounds &= x_new[j] <= x_upper[j];
+         }
+         if( in_bounds )
+         {  obj_new  = obj_fun.Forward(0, x_new)[0];
+            accepted = obj_new < obj_cur;
+         }
+         if( ! accepted )
+            t = t / 2.0;
+      }
+      if( ! accepted )
+         break;
+      if( t == 1.0 )
+         lambda = std::max(lambda / 10.0, 1e-10);
+      else
+         lambda = lambda * 10.0;
+      x_cur   = x_new;
+      obj_cur = obj_new;
+   }
+   //
+   // fixed_in, random_in
+   for(size_t j = 0; j < n_fixed_; ++j)
+      fixed_in[j] = x_cur[j];
+   for(size_t j = 0; j < n_mixed; ++j)
+      random_in[j] = x_cur[n_fixed_ + j];
+   return true;
+}
 // ===========================================================================
 // private virtual functions
 // ===========================================================================
@@ -1254,7 +2692,7 @@ fit_model::a1_vector fit_model::ran_likelihood(
       return a1_vector(0);
    //
    // convert from cppad_mixed random effects to dismod_at random effects
-   a1_vector random_vec = random_const_.restore( cppad_mixed_random_vec );
+   a1_vector random_vec = restore_random( cppad_mixed_random_vec );
    //
    // packed vector
    a1_vector pack_vec( pack_object_.size() );
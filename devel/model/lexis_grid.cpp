@@ -0,0 +1,331 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# include <cmath>
+# include <limits>
+# include <algorithm>
+# include <dismod_at/lexis_grid.hpp>
+# include <dismod_at/a1_double.hpp>
+
+/*
+{xrst_begin lexis_grid dev}
+{xrst_spell
+  lexis
+}
+
+Solution of the ODE on a Lexis Grid Shared by Many Rectangles
+#############################################################
+
+Syntax
+******
+
+| ``lexis_grid<`` *Float* > *lexis_obj* ( *ode_step_size* , *age_grid* )
+| *lexis_obj* . ``clear`` ()
+| *lexis_obj* . ``set_generation`` ( *generation* )
+| *n_cohort* = *lexis_obj* . ``n_cohort`` ()
+| *value* = *lexis_obj* . ``value`` (
+| |tab| *adjint_obj* , *age* , *time* ,
+| |tab| *node_id* , *integrand_id* , *n_child* , *child* , *subgroup_id* ,
+| |tab| *x* , *pack_vec*
+| )
+
+Purpose
+*******
+The usual way to compute an average integrand that requires the ODE
+solves one cohort for each point in the extended age grid of each
+:ref:`rectangle<avg_integrand_rectangle-name>` .
+When there are many rectangles for the same node, child, subgroup,
+covariate values, and integrand, these cohorts are almost the same.
+This object solves the ODE once for a set of cohorts that is shared
+by all these rectangles and
+then approximates the integrand at other ages and times
+by bilinear interpolation.
+
+Lexis Grid
+**********
+The ages in the Lexis grid are the points in *age_grid* .
+The cohorts in the Lexis grid have initial time
+*k* * *ode_step_size* at the initial age *age_grid* [0]
+where *k* is an integer.
+Hence, along each age in the grid, the cohorts are spaced
+*ode_step_size* apart in time.
+Cohorts are solved the first time they are needed and
+then stored until the next call to ``clear`` .
+
+Float
+*****
+The type *Float* is ``double`` or :ref:`a1_double-name` .
+
+ode_step_size
+*************
+This is the value of
+:ref:`option_table@Age Average Grid@ode_step_size` in the option table.
+
+age_grid
+********
+This is the :ref:`age_avg_grid-name` .
+It is monotone increasing and a copy of it is stored in *lexis_obj* .
+
+clear
+*****
+This frees all the cohorts that have been stored in *lexis_obj* .
+
+set_generation
+**************
+The cohorts depend on *pack_vec* , but *lexis_obj* does not compare
+*pack_vec* between calls to *value* .
+Instead, the caller changes the ``size_t`` value *generation*
+each time *pack_vec* changes and,
+if *Float* is ``a1_double`` , before each new recording of a CppAD tape.
+If *generation* is not the same as in the previous call to
+``set_generation`` , the cohorts are cleared.
+This is only an integer comparison, so it can be done before each
+call to *value* .
+The constructor sets the generation to zero.
+
+n_cohort
+********
+The return value is the number of cohorts currently stored
+(summed over all the different surfaces).
+
+value
+*****
+The return value is the Lexis grid approximation for the
+adjusted integrand at the specified age and time.
+
+adjint_obj
+==========
+This is the :ref:`adj_integrand-name` object used to
+compute the integrand along each cohort.
+
+age
+===
+is the age at which we are approximating the integrand.
+It must be between the first and last points in *age_grid* .
+
+time
+====
+is the time at which we are approximating the integrand.
+
+node_id, integrand_id, n_child, child, subgroup_id, x, pack_vec
+===============================================================
+These arguments have the same meaning as in
+:ref:`adj_integrand-name` .
+All the cohorts that are stored for one value of
+( *integrand_id* , *node_id* , *child* , *subgroup_id* , *x* )
+are referred to as one surface.
+The surface used by the previous call is checked first,
+so consecutive calls for the same surface do not search
+(or copy *x* into) the map of surfaces.
+
+{xrst_end lexis_grid}
+*/
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// constructor
+template <class Float>
+lexis_grid<Float>::lexis_grid(
+   double ode_step_size, const CppAD::vector<double>& age_grid
+) :
+ode_step_size_( ode_step_size ) ,
+age_grid_( age_grid )           ,
+generation_( 0 )                ,
+last_surface_( nullptr )
+{  assert( ode_step_size > 0.0 );
+   assert( age_grid.size() > 0 );
+}
+
+// copy constructor
+template <class Float>
+lexis_grid<Float>::lexis_grid(const lexis_grid& other) :
+ode_step_size_( other.ode_step_size_ ) ,
+age_grid_( other.age_grid_ )           ,
+surface_map_( other.surface_map_ )     ,
+generation_( other.generation_ )       ,
+last_surface_( nullptr )
+{ }
+
+// clear
+template <class Float>
+void lexis_grid<Float>::clear(void)
+{  surface_map_.clear();
+   last_surface_ = nullptr;
+}
+
+// set_generation
+template <class Float>
+void lexis_grid<Float>::set_generation(size_t generation)
+{  if( generation != generation_ )
+   {  clear();
+      generation_ = generation;
+   }
+}
+
+// n_cohort
+template <class Float>
+size_t lexis_grid<Float>::n_cohort(void) const
+{  size_t result = 0;
+   typename std::map<key_type, surface_type>::const_iterator itr;
+   for(itr = surface_map_.begin(); itr != surface_map_.end(); ++itr)
+      result += itr->second.size();
+   return result;
+}
+
+// find_surface
+template <class Float>
+typename lexis_grid<Float>::surface_type& lexis_grid<Float>::find_surface(
+   size_t                          node_id      ,
+   size_t                          integrand_id ,
+   size_t                          child        ,
+   size_t                          subgroup_id  ,
+   const CppAD::vector<double>&    x            )
+{  // check for same surface as previous call
+   bool same = last_surface_ != nullptr;
+   same     &= last_integrand_id_ == integrand_id;
+   same     &= last_node_id_      == node_id;
+   same     &= last_child_        == child;
+   same     &= last_subgroup_id_  == subgroup_id;
+   same     &= last_x_.size()     == x.size();
+   for(size_t j = 0; same && j < x.size(); ++j)
+      same = last_x_[j] == x[j];
+   if( same )
+      return *last_surface_;
+   //
+   // last_surface_
+   std::vector<double> x_key( x.data(), x.data() + x.size() );
+   key_type key(integrand_id, node_id, child, subgroup_id, x_key);
+   last_surface_      = &surface_map_[key];
+   last_integrand_id_ = integrand_id;
+   last_node_id_      = node_id;
+   last_child_        = child;
+   last_subgroup_id_  = subgroup_id;
+   last_x_.resize( x.size() );
+   last_x_            = x;
+   return *last_surface_;
+}
+
+// cohort
+template <class Float>
+const CppAD::vector<Float>& lexis_grid<Float>::cohort(
+   adj_integrand&                  adjint_obj   ,
+   surface_type&                   surface      ,
+   int                             k            ,
+   size_t                          node_id      ,
+   size_t                          integrand_id ,
+   size_t                          n_child      ,
+   size_t                          child        ,
+   size_t                          subgroup_id  ,
+   const CppAD::vector<double>&    x            ,
+   const CppAD::vector<Float>&     pack_vec     )
+{  typename surface_type::iterator itr = surface.find(k);
+   if( itr != surface.end() )
+      return itr->second;
+   //
+   // line_time_
+   size_t n_age    = age_grid_.size();
+   double time_ini = double(k) * ode_step_size_;
+   line_time_.resize(n_age);
+   for(size_t i = 0; i < n_age; ++i)
+      line_time_[i] = time_ini + age_grid_[i] - age_grid_[0];
+   //
+   // surface[k]
+   CppAD::vector<Float>& line_adj = surface[k];
+   line_adj.resize(n_age);
+   line_adj = adjint_obj.line(
+      node_id,
+      age_grid_,
+      line_time_,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec
+   );
+   return line_adj;
+}
+
+// value
+template <class Float>
+Float lexis_grid<Float>::value(
+   adj_integrand&                  adjint_obj   ,
+   double                          age          ,
+   double                          time         ,
+   size_t                          node_id      ,
+   size_t                          integrand_id ,
+   size_t                          n_child      ,
+   size_t                          child        ,
+   size_t                          subgroup_id  ,
+   const CppAD::vector<double>&    x            ,
+   const CppAD::vector<Float>&     pack_vec     )
+{  // numerical precision
+   double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
+   //
+   // surface
+   surface_type& surface = find_surface(
+      node_id, integrand_id, child, subgroup_id, x
+   );
+   //
+   // age_index, age_weight
+   // age_grid_[age_index] <= age <= age_grid_[age_index+1]
+   size_t n_age      = age_grid_.size();
+   size_t age_index  = 0;
+   double age_weight = 0.0;
+   if( n_age > 1 )
+   {  while( age_index + 2 < n_age && age_grid_[age_index + 1] < age )
+         ++age_index;
+      double age_left  = age_grid_[age_index];
+      double age_right = age_grid_[age_index + 1];
+      age_weight = (age - age_left) / (age_right - age_left);
+      age_weight = std::max(0.0, std::min(1.0, age_weight) );
+      if( age_weight < eps99 )
+         age_weight = 0.0;
+      if( 1.0 - age_weight < eps99 )
+         age_weight = 1.0;
+   }
+   //
+   // result
+   Float result = Float(0.0);
+   for(size_t ell = 0; ell < 2; ++ell)
+   {  double weight = (ell == 0) ? 1.0 - age_weight : age_weight;
+      if( weight != 0.0 )
+      {  size_t i = age_index + ell;
+         //
+         // k, frac: cohorts k and k+1 go through age_grid_[i] at time
+         double time_ini = time - age_grid_[i] + age_grid_[0];
+         double s        = time_ini / ode_step_size_;
+         double s_round  = std::floor(s + 0.5);
+         double s_diff   = std::fabs(s - s_round);
+         bool   s_near   = s_diff <= eps99 * (1.0 + std::fabs(s));
+         int    k        = int( std::floor(s) );
+         double frac     = s - double(k);
+         if( s_near )
+         {  k    = int( s_round );
+            frac = 0.0;
+         }
+         //
+         // result
+         const CppAD::vector<Float>& left = cohort(
+            adjint_obj, surface, k,
+            node_id, integrand_id, n_child, child, subgroup_id, x, pack_vec
+         );
+         result += weight * (1.0 - frac) * left[i];
+         if( frac != 0.0 )
+         {  const CppAD::vector<Float>& right = cohort(
+               adjint_obj, surface, k + 1,
+               node_id, integrand_id, n_child, child, subgroup_id, x, pack_vec
+            );
+            result += weight * frac * right[i];
+         }
+      }
+   }
+   return result;
+}
+
+// instantiations
+template class lexis_grid<double>;
+template class lexis_grid<a1_double>;
+
+} // END_DISMOD_AT_NAMESPACE
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-24 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 /*
 {xrst_begin prior_model_ctor dev}
@@ -53,6 +53,15 @@ Only to following fields are used
 :ref:`prior_table@eta` ,
 :ref:`prior_table@nu` .
 
+Prior Terms
+***********
+The constructor (and :ref:`replace_mean-name` ) compile the priors into
+a list of terms for the fixed effects and a list for the random effects.
+Each term has its variable indices, density, mean, standard deviation,
+eta, nu and standard deviation multiplier already resolved,
+and terms with a uniform density are not included.
+Evaluating the priors is then a loop over these terms.
+
 {xrst_end prior_model_ctor}
 */
 
@@ -108,44 +117,133 @@ density_table_(density_table)
       else
          prior_mean_[var_id * 3 + 2] = prior_table[prior_id].mean;
    }
+   compile_terms();
    return;
 }
 
 // private
-template <class Float>
-residual_struct<Float> prior_model::log_prior(
-   const prior_struct&   prior      ,  // prior for this residual
-   const Float&          mulstd     ,  // multiplies prior std
-   const Float&          z          ,  // first random variable
-   const Float&          y          ,  // second random variable
-   size_t                index      ,  // the index for this residual
-   bool                  difference ) const // is this a difference residual
-{  assert ( 0 <= prior.density_id  );
-   assert ( size_t(prior.density_id) < density_table_.size()  );
+void prior_model::compile_terms(void)
+{  size_t null = DISMOD_AT_NULL_SIZE_T;
    //
-   // density
-   density_enum density = density_table_[prior.density_id];
+   // clear previous terms
+   fixed_term_  = term_list_struct();
+   random_term_ = term_list_struct();
    //
-   // delta_dbl
-   // transformed standard deviation
-   double delta_dbl = prior.std;
-   if( ! difference && log_density(density) ) delta_dbl =
-      log(prior.mean + prior.eta + prior.std) - log(prior.mean + prior.eta);
+   size_t n_var = var2prior_.size();
+   for(size_t var_id = 0; var_id < n_var; ++var_id)
+   {  // prior information
+      size_t smooth_id      = var2prior_.smooth_id(var_id);
+      bool   fixed_effect   = var2prior_.fixed_effect(var_id);
+      size_t prior_id[3];
+      prior_id[0] = var2prior_.value_prior_id(var_id);
+      prior_id[1] = var2prior_.dage_prior_id(var_id);
+      prior_id[2] = var2prior_.dtime_prior_id(var_id);
+# ifndef NDEBUG
+      double const_value = var2prior_.const_value(var_id);
+      if( ! std::isnan(const_value) )
+         assert( prior_id[0] == null );
+      else
+         assert( prior_id[0] != null );
+# endif
+      if( smooth_id == null )
+      {  // standard deviation multipliers are fixed effects and do not
+         // have a smoothing, hence the following
+         assert( fixed_effect );
+         assert( prior_id[0] != null );
+         assert( prior_id[1] == null );
+         assert( prior_id[2] == null );
+      }
+      //
+      // term: fixed_term_ or random_term_
+      term_list_struct& term = fixed_effect ? fixed_term_ : random_term_;
+      //
+      for(size_t k = 0; k < 3; ++k) if( prior_id[k] != null )
+      {  const prior_struct& prior = prior_table_[ prior_id[k] ];
+         assert ( 0 <= prior.density_id  );
+         assert ( size_t(prior.density_id) < density_table_.size()  );
+         density_enum density = density_table_[prior.density_id];
+         //
+         if( density != uniform_enum )
+         {  bool difference = k != 0;
+            //
+            // mean: the replacement means only apply to fixed effects
+            double mean = prior.mean;
+            if( fixed_effect )
+               mean = prior_mean_[var_id * 3 + k];
+            //
+            // delta: transformed standard deviation
+            double delta = prior.std;
+            if( ! difference && log_density(density) ) delta =
+               log(mean + prior.eta + prior.std) - log(mean + prior.eta);
+            //
+            // z_var_id
+            size_t z_var_id = null;
+            if( k == 1 )
+               z_var_id = var2prior_.dage_var_id(var_id);
+            if( k == 2 )
+               z_var_id = var2prior_.dtime_var_id(var_id);
+            //
+            // mulstd_offset
+            size_t offset = null;
+            if( smooth_id != null )
+               offset = pack_object_.mulstd_offset(smooth_id, k);
+            //
+            term.var_id.push_back( var_id );
+            term.z_var_id.push_back( z_var_id );
+            term.mulstd_offset.push_back( offset );
+            term.index.push_back( 3 * var_id + k );
+            term.density.push_back( density );
+            term.mean.push_back( mean );
+            term.delta.push_back( delta );
+            term.eta.push_back( prior.eta );
+            term.nu.push_back( prior.nu );
+         }
+      }
+   }
+   return;
+}
+
+// private
+template <class Float>
+CppAD::vector< residual_struct<Float> > prior_model::eval_terms(
+   const term_list_struct&     term     ,
+   const CppAD::vector<Float>& pack_vec ) const
+{  size_t null = DISMOD_AT_NULL_SIZE_T;
+   Float  nan  = Float( std::numeric_limits<double>::quiet_NaN() );
+   assert( pack_vec.size() == pack_object_.size() );
    //
-   // residual_density
-   Float        mu        = Float(prior.mean);
-   Float        delta     = mulstd * Float(delta_dbl);
-   Float        eta       = Float(prior.eta);
-   Float        nu        = Float(prior.nu);
-   Float        not_used  = Float( std::numeric_limits<double>::quiet_NaN() );
-   residual_enum residual_type;
-   if( difference )
-      residual_type = difference_prior_enum;
-   else
-      residual_type = value_prior_enum;
-   return residual_density(
-      residual_type, z, y, mu, delta, density, eta, nu, not_used, index
-   );
+   size_t n_term = term.var_id.size();
+   CppAD::vector< residual_struct<Float> > residual_vec(n_term);
+   for(size_t i = 0; i < n_term; ++i)
+   {  Float y = pack_vec[ term.var_id[i] ];
+      //
+      // z, residual_type
+      Float         z             = nan;
+      residual_enum residual_type = value_prior_enum;
+      if( term.z_var_id[i] != null )
+      {  z             = pack_vec[ term.z_var_id[i] ];
+         residual_type = difference_prior_enum;
+      }
+      //
+      // delta
+      Float delta = Float( term.delta[i] );
+      if( term.mulstd_offset[i] != null )
+         delta = pack_vec[ term.mulstd_offset[i] ] * delta;
+      //
+      residual_vec[i] = residual_density(
+         residual_type,
+         z,
+         y,
+         Float( term.mean[i] ),
+         delta,
+         term.density[i],
+         Float( term.eta[i] ),
+         Float( term.nu[i] ),
+         nan,
+         term.index[i]
+      );
+   }
+   return residual_vec;
 }
 /*
 {xrst_begin replace_mean dev}
@@ -195,6 +293,7 @@ replace the mean in the
 void prior_model::replace_mean(const CppAD::vector<double>& prior_mean)
 // END_REPLACE_MEAN_PROTOTYPE
 {  prior_mean_ = prior_mean;
+   compile_terms();
 }
 
 /*
@@ -269,120 +368,7 @@ of using this routine.
 template <class Float>
 CppAD::vector< residual_struct<Float> >
 prior_model::fixed(const CppAD::vector<Float>& pack_vec ) const
-{  Float nan = Float( std::numeric_limits<double>::quiet_NaN() );
-   //
-   // initialize the log of the fixed negative log-likelihood as zero
-   CppAD::vector< residual_struct<Float> > residual_vec;
-   assert( residual_vec.size() == 0 );
-   //
-   // for computing one residual
-   residual_struct<Float> residual;
-
-   // n_var
-   assert( pack_vec.size()   == pack_object_.size() );
-   assert( var2prior_.size() == pack_object_.size() );
-   size_t n_var = pack_vec.size();
-
-   for(size_t var_id = 0; var_id < n_var; ++var_id)
-   {  // This variable value
-      Float y = pack_vec[var_id];
-      //
-      // prior information
-      size_t smooth_id      = var2prior_.smooth_id(var_id);
-      size_t value_prior_id = var2prior_.value_prior_id(var_id);
-      size_t dage_prior_id  = var2prior_.dage_prior_id(var_id);
-      size_t dtime_prior_id = var2prior_.dtime_prior_id(var_id);
-      bool   fixed_effect   = var2prior_.fixed_effect(var_id);
-# ifndef NDEBUG
-      double const_value = var2prior_.const_value(var_id);
-      if( ! std::isnan(const_value) )
-         assert( value_prior_id == DISMOD_AT_NULL_SIZE_T );
-      else
-         assert( value_prior_id != DISMOD_AT_NULL_SIZE_T );
-# endif
-      //
-      if( smooth_id == DISMOD_AT_NULL_SIZE_T )
-      {  // standard deviation multipliers are fixed effects and do not
-         // have a smoothing, hence the following
-         assert( fixed_effect );
-         assert( value_prior_id != DISMOD_AT_NULL_SIZE_T );
-         assert( dage_prior_id  == DISMOD_AT_NULL_SIZE_T );
-         assert( dtime_prior_id == DISMOD_AT_NULL_SIZE_T );
-         //
-         // value prior
-         prior_struct prior = prior_table_[value_prior_id];
-         //
-         // replacement for prior mean
-         prior.mean = prior_mean_[var_id * 3 + 0];
-         //
-         // no standard deviation multiplier for this prior
-         Float mulstd = Float(1.0);
-         //
-         // this is not a difference prior
-         bool  difference  = false;
-         Float z           = nan;
-         //
-         // index used for value priors
-         size_t index              = 3 * var_id + 0;
-         //
-         // negative log-likelihood of value prior for this multiplier
-         residual  = log_prior(prior, mulstd, z, y, index, difference);
-         if( residual.density != uniform_enum )
-            residual_vec.push_back(residual);
-      }
-      else if( fixed_effect )
-      {  if( value_prior_id != DISMOD_AT_NULL_SIZE_T )
-         {  prior_struct prior = prior_table_[value_prior_id];
-            bool   difference = false;
-            Float  z          = nan;
-            size_t k          = 0;
-            size_t index      = 3 * var_id + k;
-            size_t offset     = pack_object_.mulstd_offset(smooth_id, k);
-            Float mulstd      = Float(1.0);
-            prior.mean        = prior_mean_[var_id * 3 + k];
-            if( offset != DISMOD_AT_NULL_SIZE_T )
-               mulstd        = pack_vec[offset];
-            //
-            residual = log_prior(prior, mulstd, z, y, index, difference);
-            if( residual.density != uniform_enum )
-               residual_vec.push_back(residual);
-         }
-         if( dage_prior_id != DISMOD_AT_NULL_SIZE_T )
-         {  prior_struct prior = prior_table_[dage_prior_id];
-            bool   difference = true;
-            Float  z          = pack_vec[var2prior_.dage_var_id(var_id)];
-            size_t k          = 1;
-            size_t index      = 3 * var_id + k;
-            size_t offset     = pack_object_.mulstd_offset(smooth_id, k);
-            Float mulstd      = Float(1.0);
-            prior.mean        = prior_mean_[var_id * 3 + k];
-            if( offset != DISMOD_AT_NULL_SIZE_T )
-               mulstd        = pack_vec[offset];
-            //
-            residual = log_prior(prior, mulstd, z, y, index, difference);
-            if( residual.density != uniform_enum )
-               residual_vec.push_back(residual);
-         }
-         if( dtime_prior_id != DISMOD_AT_NULL_SIZE_T )
-         {  prior_struct prior = prior_table_[dtime_prior_id];
-            bool   difference = true;
-            Float  z          = pack_vec[var2prior_.dtime_var_id(var_id)];
-            size_t k          = 2;
-            size_t index      = 3 * var_id + k;
-            size_t offset     = pack_object_.mulstd_offset(smooth_id, k);
-            Float mulstd      = Float(1.0);
-            prior.mean        = prior_mean_[var_id * 3 + k];
-            if( offset != DISMOD_AT_NULL_SIZE_T )
-               mulstd        = pack_vec[offset];
-            //
-            residual = log_prior(prior, mulstd, z, y, index, difference);
-            if( residual.density != uniform_enum )
-               residual_vec.push_back(residual);
-         }
-      }
-   }
-   return residual_vec;
-}
+{  return eval_terms(fixed_term_, pack_vec); }
 /*
 ------------------------------------------------------------------------------
 {xrst_begin prior_random_effect dev}
@@ -456,89 +442,7 @@ of using this routine.
 template <class Float>
 CppAD::vector< residual_struct<Float> >
 prior_model::random(const CppAD::vector<Float>& pack_vec ) const
-{  Float nan = Float( std::numeric_limits<double>::quiet_NaN() );
-   //
-   // initialize the log of the fixed negative log-likelihood as zero
-   CppAD::vector< residual_struct<Float> > residual_vec;
-   assert( residual_vec.size() == 0 );
-   //
-   // for computing one residual
-   residual_struct<Float> residual;
-
-   // n_var
-   assert( pack_vec.size()   == pack_object_.size() );
-   assert( var2prior_.size() == pack_object_.size() );
-   size_t n_var = pack_vec.size();
-
-   for(size_t var_id = 0; var_id < n_var; ++var_id)
-   {  // This variable value
-      Float y = pack_vec[var_id];
-      //
-      // prior information
-      size_t smooth_id      = var2prior_.smooth_id(var_id);
-      size_t value_prior_id = var2prior_.value_prior_id(var_id);
-      size_t dage_prior_id  = var2prior_.dage_prior_id(var_id);
-      size_t dtime_prior_id = var2prior_.dtime_prior_id(var_id);
-      bool   fixed_effect   = var2prior_.fixed_effect(var_id);
-      //
-      if( ! fixed_effect )
-      {  assert( smooth_id != DISMOD_AT_NULL_SIZE_T );
-         //
-         if( value_prior_id != DISMOD_AT_NULL_SIZE_T )
-         {
-# ifndef NDEBUG
-            double const_value    = var2prior_.const_value(var_id);
-            assert( std::isnan(const_value)  );
-# endif
-            const prior_struct& prior = prior_table_[value_prior_id];
-            bool   difference = false;
-            Float  z          = nan;
-            size_t k          = 0;
-            size_t index      = 3 * var_id + k;
-            size_t offset     = pack_object_.mulstd_offset(smooth_id, k);
-            Float mulstd      = Float(1.0);
-            if( offset != DISMOD_AT_NULL_SIZE_T )
-               mulstd        = pack_vec[offset];
-            //
-            residual = log_prior(prior, mulstd, z, y, index, difference);
-            if( residual.density != uniform_enum )
-               residual_vec.push_back(residual);
-         }
-         if( dage_prior_id != DISMOD_AT_NULL_SIZE_T )
-         {  const prior_struct& prior = prior_table_[dage_prior_id];
-            bool   difference = true;
-            Float  z          = pack_vec[var2prior_.dage_var_id(var_id)];
-
-            size_t k          = 1;
-            size_t index      = 3 * var_id + k;
-            size_t offset     = pack_object_.mulstd_offset(smooth_id, k);
-            Float mulstd      = Float(1.0);
-            if( offset != DISMOD_AT_NULL_SIZE_T )
-               mulstd        = pack_vec[offset];
-            //
-            residual = log_prior(prior, mulstd, z, y, index, difference);
-            if( residual.density != uniform_enum )
-               residual_vec.push_back(residual);
-         }
-         if( dtime_prior_id != DISMOD_AT_NULL_SIZE_T )
-         {  const prior_struct& prior = prior_table_[dtime_prior_id];
-            bool   difference = true;
-            Float  z          = pack_vec[var2prior_.dtime_var_id(var_id)];
-            size_t k          = 2;
-            size_t index      = 3 * var_id + k;
-            size_t offset     = pack_object_.mulstd_offset(smooth_id, k);
-            Float mulstd      = Float(1.0);
-            if( offset != DISMOD_AT_NULL_SIZE_T )
-               mulstd        = pack_vec[offset];
-            //
-            residual = log_prior(prior, mulstd, z, y, index, difference);
-            if( residual.density != uniform_enum )
-               residual_vec.push_back(residual);
-         }
-      }
-   }
-   return residual_vec;
-}
+{  return eval_terms(random_term_, pack_vec); }
 
 # define DISMOD_AT_INSTANTIATE_PRIOR_DENSITY(Float)                       \
    template                                                              \
@@ -0,0 +1,315 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin compact_table dev}
+{xrst_spell
+   sizeof
+}
+
+Writing and Reading Tables With an Optional Compact Storage Format
+##################################################################
+
+Syntax
+******
+
+| ``put_compact_table`` (
+| |tab| *db* , *storage_format* , *table_name* , *col_name* , *n_index* , *value*
+| )
+| *found* = ``get_compact_table`` (
+| |tab| *db* , *table_name* , *col_name* , *index* , *position* , *value*
+| )
+
+Purpose
+*******
+Some tables, for example the :ref:`sample_table-name` and
+:ref:`data_sim_table-name` , have one row for each
+( *index* , *position* ) pair and a single ``real`` value in each row.
+The compact storage format uses one row for each *index*
+and stores all the values for that *index* in a packed blob.
+This avoids most of the per row overhead in the database.
+
+Long Format
+***********
+In the long format, *table_name* has the following columns:
+*table_name* ``_id`` , *col_name* [0] , *col_name* [1] , *col_name* [2] .
+These columns have type
+``integer primary key`` , ``integer`` , ``integer`` , ``real`` respectively.
+
+Compact Format
+**************
+In the compact format, *table_name* does not exist and the table
+*table_name* ``_blob`` has the following columns:
+*table_name* ``_blob_id`` , *col_name* [0] , ``sizeof_value`` ,
+*col_name* [2] .
+These columns have type
+``integer primary key`` , ``integer`` , ``integer`` , ``blob`` respectively.
+The value of ``sizeof_value`` is 8 (4) if the blob contains
+a vector of native double (float) values.
+The *position* for a value is its index in the blob vector.
+
+db
+**
+is an open connection to the database.
+
+storage_format
+**************
+is the value of :ref:`option_table@storage_format` ; i.e.,
+``long`` , ``float64`` , or ``float32`` .
+If it is ``long`` , the long format is used.
+Otherwise, the compact format is used.
+
+table_name
+**********
+is the name of the table in the long format.
+Any previous version of *table_name* or *table_name* ``_blob``
+is dropped by ``put_compact_table`` .
+
+col_name
+********
+is a vector of length three containing the names of the
+index, position, and value columns in the long format.
+
+n_index
+*******
+is the number of different values for *index* .
+The index values are ``0`` , ... , *n_index* ``-1`` .
+
+value
+*****
+For ``put_compact_table`` , the size of *value* is a multiple of *n_index*
+and there are *n_position* = *value* . ``size`` () / *n_index*
+values for each index.
+The value corresponding to ( *index* , *position* ) is
+
+   *value* [ *index* * *n_position* + *position* ]
+
+For ``get_compact_table`` , the input size of *value* must be zero.
+Upon return, it contains the values in the compact table
+in the same order as the long format.
+
+index, position
+***************
+The input size of these vectors must be zero.
+Upon return, they have the same size as *value* and contain the
+index and position corresponding to each element of *value* .
+
+found
+*****
+is true if *table_name* ``_blob`` exists.
+If it is false, *index* , *position* , and *value* are not changed
+and the caller should read *table_name* using the long format.
+
+{xrst_toc_hidden
+   example/devel/table/compact_table_xam.cpp
+}
+Example
+*******
+The file :ref:`compact_table_xam.cpp-name` is an example use of
+the put and get operations above.
+
+{xrst_end compact_table}
+*/
+
+# include <cstring>
+# include <vector>
+# include <cppad/utility/to_string.hpp>
+# include <dismod_at/compact_table.hpp>
+# include <dismod_at/create_table.hpp>
+# include <dismod_at/does_table_exist.hpp>
+# include <dismod_at/exec_sql_cmd.hpp>
+# include <dismod_at/sqlite_profile.hpp>
+# include <dismod_at/error_exit.hpp>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+void put_compact_table(
+   sqlite3*                            db             ,
+   const std::string&                  storage_format ,
+   const std::string&                  table_name     ,
+   const CppAD::vector<std::string>&   col_name       ,
+   size_t                              n_index        ,
+   const CppAD::vector<double>&        value          )
+{  using CppAD::to_string;
+   assert( col_name.size() == 3 );
+   assert( n_index == 0 || value.size() % n_index == 0 );
+   size_t n_position = 0;
+   if( n_index > 0 )
+      n_position = value.size() / n_index;
+   //
+   // drop previous versions of this table
+   std::string blob_name = table_name + "_blob";
+   std::string cmd = "drop table if exists " + table_name;
+   exec_sql_cmd(db, cmd);
+   cmd = "drop table if exists " + blob_name;
+   exec_sql_cmd(db, cmd);
+   // ----------------------------------------------------------------------
+   if( storage_format == "long" )
+   {  size_t n_col = 3;
+      size_t n_row = value.size();
+      CppAD::vector<std::string> col_type(n_col), row_value(n_col * n_row);
+      CppAD::vector<bool>        col_unique(n_col);
+      col_type[0] = "integer";
+      col_type[1] = "integer";
+      col_type[2] = "real";
+      for(size_t j = 0; j < n_col; ++j)
+         col_unique[j] = false;
+      for(size_t i = 0; i < n_index; ++i)
+      {  std::string index_str = to_string(i);
+         for(size_t j = 0; j < n_position; ++j)
+         {  size_t row_id = i * n_position + j;
+            row_value[n_col * row_id + 0] = index_str;
+            row_value[n_col * row_id + 1] = to_string(j);
+            row_value[n_col * row_id + 2] = to_string( value[row_id] );
+         }
+      }
+      create_table(db, table_name, col_name, col_type, col_unique, row_value);
+      return;
+   }
+   // ----------------------------------------------------------------------
+   // sizeof_value
+   assert( storage_format == "float64" || storage_format == "float32" );
+   size_t sizeof_value = sizeof(double);
+   if( storage_format == "float32" )
+      sizeof_value = sizeof(float);
+   //
+   // create the table
+   cmd  = "create table " + blob_name;
+   cmd += " (" + blob_name + "_id integer primary key, ";
+   cmd += col_name[0] + " integer, sizeof_value integer, ";
+   cmd += col_name[2] + " blob);";
+   exec_sql_cmd(db, cmd);
+   //
+   // bulk
+   bool bulk = sqlite_bulk_begin(db, value.size() );
+   //
+   // prepare sqlite command
+   cmd  = "insert into " + blob_name + " values(?, ?, ?, ?)";
+   sqlite3_stmt* p_stmt;
+   int           n_byte  = -1;
+   const char**  pz_tail = nullptr;
+   int rc = sqlite3_prepare_v2(db, cmd.c_str(), n_byte, &p_stmt, pz_tail);
+   if( rc != SQLITE_OK )
+   {  std::string message = "put_compact_table: following command failed:\n";
+      message            += cmd;
+      error_exit(message);
+   }
+   //
+   // one transaction for all the rows unless we are already inside of one
+   bool transaction = sqlite3_get_autocommit(db) != 0;
+   if( transaction )
+      exec_sql_cmd(db, "begin transaction");
+   std::vector<char>  buffer(n_position * sizeof_value);
+   std::vector<float> value_float(n_position);
+   for(size_t i = 0; i < n_index; ++i)
+   {  const double* source = value.data() + i * n_position;
+      if( sizeof_value == sizeof(double) )
+         std::memcpy(buffer.data(), source, buffer.size());
+      else
+      {  for(size_t j = 0; j < n_position; ++j)
+            value_float[j] = float( source[j] );
+         std::memcpy(buffer.data(), value_float.data(), buffer.size());
+      }
+      n_byte = int( buffer.size() );
+      sqlite3_bind_int(p_stmt, 1, int(i) );
+      sqlite3_bind_int(p_stmt, 2, int(i) );
+      sqlite3_bind_int(p_stmt, 3, int(sizeof_value) );
+      sqlite3_bind_blob(p_stmt, 4, buffer.data(), n_byte, SQLITE_STATIC);
+      rc = sqlite3_step(p_stmt);
+      if( rc != SQLITE_DONE )
+      {  std::string message = "put_compact_table: inserting blob in ";
+         message            += blob_name + " failed\n";
+         error_exit(message);
+      }
+      sqlite3_reset(p_stmt);
+   }
+   if( transaction )
+      exec_sql_cmd(db, "commit");
+   //
+   // delete the statement
+   sqlite3_finalize(p_stmt);
+   if( bulk )
+      sqlite_bulk_end(db);
+}
+
+bool get_compact_table(
+   sqlite3*                            db             ,
+   const std::string&                  table_name     ,
+   const CppAD::vector<std::string>&   col_name       ,
+   CppAD::vector<int>&                 index          ,
+   CppAD::vector<int>&                 position       ,
+   CppAD::vector<double>&              value          )
+{  assert( col_name.size() == 3 );
+   assert( index.size() == 0 );
+   assert( position.size() == 0 );
+   assert( value.size() == 0 );
+   //
+   // check for compact format
+   std::string blob_name = table_name + "_blob";
+   if( ! does_table_exist(db, blob_name) )
+      return false;
+   //
+   // prepare sqlite command
+   std::string cmd = "select " + col_name[0] + ", sizeof_value, ";
+   cmd += col_name[2] + " from " + blob_name;
+   cmd += " order by " + blob_name + "_id";
+   sqlite3_stmt* p_stmt;
+   int           n_byte  = -1;
+   const char**  pz_tail = nullptr;
+   int rc = sqlite3_prepare_v2(db, cmd.c_str(), n_byte, &p_stmt, pz_tail);
+   if( rc != SQLITE_OK )
+   {  std::string message = "get_compact_table: following command failed:\n";
+      message            += cmd;
+      error_exit(message);
+   }
+   //
+   // index, position, value
+   std::vector<float> value_float;
+   size_t row_id = 0;
+   rc = sqlite3_step(p_stmt);
+   while( rc == SQLITE_ROW )
+   {  int    index_i      = sqlite3_column_int(p_stmt, 0);
+      size_t sizeof_value = size_t( sqlite3_column_int(p_stmt, 1) );
+      n_byte              = sqlite3_column_bytes(p_stmt, 2);
+      bool ok = sizeof_value == sizeof(double);
+      ok     |= sizeof_value == sizeof(float);
+      ok     &= size_t(n_byte) % sizeof_value == 0;
+      if( ! ok )
+      {  std::string message = "get_compact_table: sizeof_value = ";
+         message += CppAD::to_string(sizeof_value) + " not valid or ";
+         message += "does not divide the number of bytes in blob";
+         error_exit(message, blob_name, row_id);
+      }
+      size_t      n_position = size_t(n_byte) / sizeof_value;
+      size_t      offset     = value.size();
+      const void* source     = sqlite3_column_blob(p_stmt, 2);
+      value.resize(offset + n_position);
+      if( sizeof_value == sizeof(double) && n_position > 0 )
+         std::memcpy(value.data() + offset, source, size_t(n_byte) );
+      else if( n_position > 0 )
+      {  value_float.resize(n_position);
+         std::memcpy(value_float.data(), source, size_t(n_byte) );
+         for(size_t j = 0; j < n_position; ++j)
+            value[offset + j] = double( value_float[j] );
+      }
+      for(size_t j = 0; j < n_position; ++j)
+      {  index.push_back( index_i );
+         position.push_back( int(j) );
+      }
+      ++row_id;
+      rc = sqlite3_step(p_stmt);
+   }
+   if( rc != SQLITE_DONE )
+   {  std::string message = "get_compact_table: reading blob in ";
+      message            += blob_name + " failed\n";
+      error_exit(message);
+   }
+   //
+   // delete the statement
+   sqlite3_finalize(p_stmt);
+   //
+   return true;
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -120,6 +120,7 @@ The file :ref:`create_table_xam.cpp-name` is an example use of
 # include <dismod_at/create_table.hpp>
 # include <cppad/utility/to_string.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
+# include <dismod_at/sqlite_profile.hpp>
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
@@ -178,7 +179,10 @@ void create_table(
       else
          cmd += " )\n";
    }
+   bool bulk = sqlite_bulk_begin(db, n_row * n_col);
    dismod_at::exec_sql_cmd(db, cmd);
+   if( bulk )
+      sqlite_bulk_end(db);
 }
 
 } // END_DISMOD_AT_NAMESPACE
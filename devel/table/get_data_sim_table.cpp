@@ -15,6 +15,8 @@ Syntax
 Purpose
 *******
 To read the :ref:`data_sim_table-name` and return it as a C++ data structure.
+If the table was written using the :ref:`compact_table@Compact Format` ,
+it is converted to the long format.
 
 db
 **
@@ -75,6 +77,7 @@ and test of this function.
 # include <dismod_at/get_data_sim_table.hpp>
 # include <dismod_at/get_table_column.hpp>
 # include <dismod_at/check_table_id.hpp>
+# include <dismod_at/compact_table.hpp>
 
 namespace dismod_at { // BEGIN DISMOD_AT_NAMESPACE
 
@@ -82,6 +85,23 @@ CppAD::vector<data_sim_struct> get_data_sim_table(sqlite3* db)
 {  using std::string;
 
    string table_name  = "data_sim";
+   //
+   // compact storage format
+   CppAD::vector<string> col_name =
+      {"simulate_index", "data_subset_id", "data_sim_value"};
+   CppAD::vector<int>    index, position;
+   CppAD::vector<double> value;
+   if( get_compact_table(db, table_name, col_name, index, position, value) )
+   {  CppAD::vector<data_sim_struct> data_sim_table( value.size() );
+      for(size_t i = 0; i < value.size(); i++)
+      {  data_sim_table[i].simulate_index   = index[i];
+         data_sim_table[i].data_subset_id   = position[i];
+         data_sim_table[i].data_sim_value   = value[i];
+      }
+      return data_sim_table;
+   }
+   //
+   // long storage format
    size_t n_data_sim  = check_table_id(db, table_name);
 
    std::string column_name =  "simulate_index";
@@ -78,6 +78,7 @@ this function.
 
 
 
+# include <limits>
 # include <cppad/utility/to_string.hpp>
 # include <dismod_at/get_rate_table.hpp>
 # include <dismod_at/get_option_table.hpp>
@@ -131,6 +132,8 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
       { "accept_after_max_steps_fixed",     "5"                  },
       { "accept_after_max_steps_random",    "5"                  },
       { "age_avg_split",                    ""                   },
+      { "aggregate_data",                   "false"              },
+      { "asymptotic_lanczos_step",          "0"                  },
       { "asymptotic_rcond_lower",           "0.0"                },
       { "avgint_extra_columns",             ""                   },
       { "bound_frac_fixed",                 "1e-2"               },
@@ -139,12 +142,20 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
       { "data_extra_columns",               ""                   },
       { "derivative_test_fixed",            "none"               },
       { "derivative_test_random",           "none"               },
+      { "gauss_newton_fixed",               "0"                  },
       { "hold_out_integrand",               ""                   },
       { "limited_memory_max_history_fixed", "30"                 },
       { "max_num_iter_fixed",               "100"                },
       { "max_num_iter_random",              "100"                },
+      { "mcmc_number_chain",                "4"                  },
+      { "mcmc_number_leapfrog",             "10"                 },
+      { "mcmc_number_warmup",               "200"                },
       { "meas_noise_effect",                "add_std_scale_all"  },
+      { "memory_database",                  "false"              },
       { "method_random",                    "ipopt_random"       },
+      { "number_thread",                    "1"                  },
+      { "ode_lexis_grid",                   "false"              },
+      { "ode_step_schedule",                ""                   },
       { "ode_step_size",                    "10.0"               },
       { "other_database",                   ""                   },
       { "other_input_table",                ""                   },
@@ -156,10 +167,13 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
       { "random_seed",                      "0"                  },
       { "rate_case",                        "iota_pos_rho_zero"  },
       { "splitting_covariate",              ""                   },
+      { "sqlite_profile",                   "safe"               },
+      { "storage_format",                   "long"               },
       { "tolerance_fixed",                  "1e-8"               },
       { "tolerance_random",                 "1e-8"               },
       { "trace_init_fit_model",             "false"              },
       { "warn_on_stderr",                   "true"               },
+      { "zero_sum_basis",                   "false"              },
       { "zero_sum_child_rate",              ""                   },
       { "zero_sum_mulcov_group",            ""                   },
       // END_SORT_THIS_LINE_MINUS_1
@@ -191,6 +205,8 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
    bool    quasi_fixed                 = true;
    bool    other_database              = false;
    bool    other_input_table           = false;
+   double  ode_step_schedule_min       = 0.0;
+   size_t  ode_step_schedule_id        = n_in_table;
    for(size_t option_id = 0; option_id < n_in_table; option_id++)
    {  // option_value_split
       CppAD::vector<string> option_value_split = split_space(
@@ -276,6 +292,41 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
             error_exit(msg, table_name, option_id);
          }
       }
+      // memory_database
+      if( name_vec[match] == "memory_database" )
+      {  bool ok = false;
+         ok     |= option_value[option_id] == "true";
+         ok     |= option_value[option_id] == "false";
+         if( ! ok )
+         {  msg = "memory_database = '";
+            msg += option_value[option_id] + "'";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // sqlite_profile
+      if( name_vec[match] == "sqlite_profile" )
+      {  bool ok = false;
+         ok     |= option_value[option_id] == "safe";
+         ok     |= option_value[option_id] == "fast";
+         ok     |= option_value[option_id] == "bulk";
+         if( ! ok )
+         {  msg = "sqlite_profile = '";
+            msg += option_value[option_id] + "'";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // storage_format
+      if( name_vec[match] == "storage_format" )
+      {  bool ok = false;
+         ok     |= option_value[option_id] == "long";
+         ok     |= option_value[option_id] == "float64";
+         ok     |= option_value[option_id] == "float32";
+         if( ! ok )
+         {  msg = "storage_format = '";
+            msg += option_value[option_id] + "'";
+            error_exit(msg, table_name, option_id);
+         }
+      }
       // ode_step_size
       if( name_vec[match] == "ode_step_size" )
       {  bool ok = std::atof( option_value[option_id].c_str() ) > 0.0;
@@ -284,6 +335,83 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
             error_exit(msg, table_name, option_id);
          }
       }
+      // ode_step_schedule
+      if( name_vec[match] == "ode_step_schedule" )
+      {  double previous = std::numeric_limits<double>::infinity();
+         for(size_t i = 0; i < option_value_split.size(); ++i)
+         {  double step = std::atof( option_value_split[i].c_str() );
+            if( ! ( 0.0 < step && step < previous ) )
+            {  msg  = "ode_step_schedule is not a decreasing list ";
+               msg += "of positive step sizes";
+               error_exit(msg, table_name, option_id);
+            }
+            previous = step;
+         }
+         if( option_value_split.size() > 0 )
+         {  ode_step_schedule_min = previous;
+            ode_step_schedule_id  = option_id;
+         }
+      }
+      // ode_lexis_grid
+      if( name_vec[match] == "ode_lexis_grid" )
+      {  if(
+            option_value[option_id] != "true" &&
+            option_value[option_id] != "false" )
+         {  msg = "ode_lexis_grid is not true or false";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // aggregate_data
+      if( name_vec[match] == "aggregate_data" )
+      {  bool ok = false;
+         ok     |= option_value[option_id] == "true";
+         ok     |= option_value[option_id] == "false";
+         if( ! ok )
+         {  msg = "aggregate_data = '";
+            msg += option_value[option_id] + "'";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // asymptotic_lanczos_step
+      if( name_vec[match] == "asymptotic_lanczos_step" )
+      {  bool ok = std::atoi( option_value[option_id].c_str() ) >= 0;
+         if( ! ok )
+         {  msg = "asymptotic_lanczos_step is < 0";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // mcmc_number_chain
+      if( name_vec[match] == "mcmc_number_chain" )
+      {  bool ok = std::atoi( option_value[option_id].c_str() ) > 0;
+         if( ! ok )
+         {  msg = "mcmc_number_chain is <= 0";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // mcmc_number_leapfrog
+      if( name_vec[match] == "mcmc_number_leapfrog" )
+      {  bool ok = std::atoi( option_value[option_id].c_str() ) > 0;
+         if( ! ok )
+         {  msg = "mcmc_number_leapfrog is <= 0";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // mcmc_number_warmup
+      if( name_vec[match] == "mcmc_number_warmup" )
+      {  bool ok = std::atoi( option_value[option_id].c_str() ) >= 0;
+         if( ! ok )
+         {  msg = "mcmc_number_warmup is < 0";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // number_thread
+      if( name_vec[match] == "number_thread" )
+      {  bool ok = std::atoi( option_value[option_id].c_str() ) > 0;
+         if( ! ok )
+         {  msg = "number_thread is <= 0";
+            error_exit(msg, table_name, option_id);
+         }
+      }
       // random_seed
       if( name_vec[match] == "random_seed" )
       {  bool ok = std::atoi( option_value[option_id].c_str() ) >= 0;
@@ -312,6 +440,15 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
             error_exit(msg, table_name, option_id);
          }
       }
+      // zero_sum_basis
+      if( name_vec[match] == "zero_sum_basis" )
+      {  if(
+            option_value[option_id] != "true" &&
+            option_value[option_id] != "false" )
+         {  msg = "zero_sum_basis is not true or false";
+            error_exit(msg, table_name, option_id);
+         }
+      }
       // trace_init_fit_model
       if( name_vec[match] == "trace_init_fit_model" )
       {  if(
@@ -387,6 +524,14 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
             error_exit(msg, table_name, option_id);
          }
       }
+      // gauss_newton_fixed
+      if( name_vec[match] == "gauss_newton_fixed" )
+      {  int n_iter = std::atoi( option_value[option_id].c_str() );
+         if( n_iter < 0 )
+         {  msg = "gauss_newton_fixed is not a non-negative integer";
+            error_exit(msg, table_name, option_id);
+         }
+      }
       // derivative_test_fixed
       // derivative_test_random
       if(
@@ -503,6 +648,17 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
       msg += " is not specified";
       error_exit(msg, table_name);
    }
+   if( ode_step_schedule_id < n_in_table )
+   {  double ode_step_size = 0.0;
+      for(size_t i = 0; i < n_option; i++)
+         if( name_vec[i] == "ode_step_size" )
+            ode_step_size = std::atof( value_vec[i].c_str() );
+      if( ode_step_schedule_min <= ode_step_size )
+      {  msg  = "ode_step_schedule has an entry that is less than or equal to";
+         msg += " ode_step_size";
+         error_exit(msg, table_name, ode_step_schedule_id);
+      }
+   }
    //
    // return table
    CppAD::vector<option_struct> option_table(n_option);
@@ -15,6 +15,8 @@ Syntax
 Purpose
 *******
 To read the :ref:`sample_table-name` and return it as a C++ data structure.
+If the table was written using the :ref:`compact_table@Compact Format` ,
+it is converted to the long format.
 
 db
 **
@@ -75,6 +77,7 @@ and test of this function.
 # include <dismod_at/get_sample_table.hpp>
 # include <dismod_at/get_table_column.hpp>
 # include <dismod_at/check_table_id.hpp>
+# include <dismod_at/compact_table.hpp>
 
 namespace dismod_at { // BEGIN DISMOD_AT_NAMESPACE
 
@@ -82,6 +85,22 @@ CppAD::vector<sample_struct> get_sample_table(sqlite3* db)
 {  using std::string;
 
    string table_name  = "sample";
+   //
+   // compact storage format
+   CppAD::vector<string> col_name = {"sample_index", "var_id", "var_value"};
+   CppAD::vector<int>    index, position;
+   CppAD::vector<double> value;
+   if( get_compact_table(db, table_name, col_name, index, position, value) )
+   {  CppAD::vector<sample_struct> sample_table( value.size() );
+      for(size_t i = 0; i < value.size(); i++)
+      {  sample_table[i].sample_index   = index[i];
+         sample_table[i].var_id         = position[i];
+         sample_table[i].var_value      = value[i];
+      }
+      return sample_table;
+   }
+   //
+   // long storage format
    size_t n_sample = check_table_id(db, table_name);
 
    std::string column_name =  "sample_index";
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-24 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 /*
 {xrst_begin log_message dev}
@@ -19,6 +19,7 @@ Syntax
 | *unix_time* = ``log_message`` (
 | |tab| *db* , *os* , *message_type* , *message* , *table_name* , *row_id*
 | )
+| ``log_buffer`` ( *db* , *buffer* )
 
 db
 **
@@ -96,10 +97,56 @@ The return value has prototype
 It is the value written in the log table for
 :ref:`log_table@unix_time` .
 
+log_buffer
+**********
+If *buffer* is true,
+``warning`` and ``value`` messages for *db*
+are held in memory until one of the following happens:
+a ``command`` or ``error`` message is logged,
+1000 messages are being held,
+or 10 seconds have passed since they were last written.
+The messages being held are then written using one prepared
+insert command inside one transaction.
+If *buffer* is false, the messages being held are written
+and each message is written when it is logged.
+The default (before ``log_buffer`` is called) is false.
+
+Repeated Warnings
+=================
+If a ``warning`` message is identical to the previous message being held
+(including *table_name* and *row_id* ),
+it is not added to the log table.
+Instead, when the previous message is written, it is followed by
+a ``warning`` row with the same *table_name* and *row_id* and message
+``previous warning logged`` *count* ``times`` , where *count*
+is the total number of times it was logged.
+The original message text is not changed.
+It is still written to *os* each time.
+
+Errors While Writing
+====================
+If writing the log table fails, ``error_exit`` logs an error
+while the messages being held are written.
+This error (and any other message logged at that time)
+is held until the current write is done.
+An ``error`` message logged at that time is also written to
+standard error, if it is not being written to *os* .
+
+Thread Safety
+*************
+The messages being held are shared by all threads.
+They are protected by a mutex, so ``log_message`` and ``log_buffer``
+can be called by more than one thread.
+Note that an sqlite connection should not be used by two threads
+at the same time; e.g., see :ref:`parallel_loop-name` .
+
+{xrst_toc_hidden
+   example/devel/table/log_message_xam.cpp
+}
 Example
 *******
-Check the ``log`` table in the database after any
-:ref:`command-name` .
+The file :ref:`log_message_xam.cpp-name` is an example use of
+``log_message`` and ``log_buffer`` .
 
 {xrst_end log_message}
 -----------------------------------------------------------------------------
@@ -107,15 +154,155 @@ Check the ``log`` table in the database after any
 # include <cstdlib>
 # include <ctime>
 # include <cassert>
+# include <vector>
+# include <mutex>
+# include <iostream>
 # include <dismod_at/log_message.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
 # include <dismod_at/get_column_max.hpp>
+# include <dismod_at/error_exit.hpp>
 # include <cppad/utility/to_string.hpp>
 # include <dismod_at/null_int.hpp>
 # include <dismod_at/configure.hpp>
 
+namespace {
+   // a message that has not yet been written to the log table
+   struct log_row_struct {
+      std::string message_type;
+      std::string table_name;
+      size_t      row_id;
+      std::time_t unix_time;
+      std::string message;
+      size_t      count;
+   };
+   //
+   // buffer_db_: database that messages are being held for
+   // (null when log_buffer is false)
+   sqlite3* buffer_db_ = DISMOD_AT_NULL_PTR;
+   //
+   // row_buffer_: messages that have not yet been written
+   std::vector<log_row_struct> row_buffer_;
+   //
+   // nested_buffer_: messages logged while row_buffer_ is being written
+   std::vector<log_row_struct> nested_buffer_;
+   //
+   // flush_time_: last time row_buffer_ was written
+   std::time_t flush_time_ = 0;
+   //
+   // maximum number of messages and seconds to hold messages
+   const size_t      max_row_buffer = 1000;
+   const std::time_t max_hold_time  = 10;
+   //
+   // log_mutex_: protects buffer_db_, row_buffer_, nested_buffer_,
+   // flush_time_, recursive_
+   // (recursive because error_exit, called during log_flush,
+   // calls log_message)
+   std::recursive_mutex log_mutex_;
+   //
+   // recursive_: is log_message writing to the log table
+   bool recursive_ = false;
+   //
+   // log_flush
+   void log_flush(sqlite3* db)
+   {  using std::string;
+      using CppAD::to_string;
+      flush_time_ = std::time( DISMOD_AT_NULL_PTR );
+      if( row_buffer_.size() == 0 )
+         return;
+      //
+      string sql_cmd = "create table if not exists log("
+         " log_id              integer primary key,"
+         " message_type        text,"
+         " table_name          text,"
+         " row_id              integer,"
+         " unix_time           integer,"
+         " message             text"
+         ");";
+      dismod_at::exec_sql_cmd(db, sql_cmd);
+      //
+      // determine next primary key value
+      string select_cmd  = "select * from log";
+      string column_name = "log_id";
+      string max_str     = dismod_at::get_column_max(
+         db, select_cmd, column_name
+      );
+      sqlite3_int64 log_id = 0;
+      if( max_str != "" )
+         log_id = std::atoll( max_str.c_str() ) + 1;
+      //
+      // prepare the insert command
+      sql_cmd = "insert into log values ( ?, ?, ?, ?, ?, ? )";
+      sqlite3_stmt* p_stmt;
+      int           n_byte  = -1;
+      const char**  pz_tail = DISMOD_AT_NULL_PTR;
+      int rc = sqlite3_prepare_v2(db, sql_cmd.c_str(), n_byte, &p_stmt, pz_tail);
+      if( rc != SQLITE_OK )
+      {  string message = "log_message: following command failed:\n";
+         message       += sql_cmd;
+         dismod_at::error_exit(message);
+      }
+      //
+      // use one transaction unless we are already inside of one
+      bool transaction = sqlite3_get_autocommit(db) != 0;
+      if( transaction )
+         dismod_at::exec_sql_cmd(db, "begin transaction");
+      for(const log_row_struct& row : row_buffer_)
+      {  // one row for the message, and one more for its repeat count
+         size_t n_insert = row.count > 1 ? 2 : 1;
+         for(size_t i_insert = 0; i_insert < n_insert; ++i_insert)
+         {  string message = row.message;
+            if( i_insert == 1 ) message =
+               "previous warning logged " + to_string(row.count) + " times";
+            //
+            sqlite3_bind_int64(p_stmt, 1, log_id++);
+            sqlite3_bind_text(
+               p_stmt, 2, row.message_type.c_str(), -1, SQLITE_TRANSIENT
+            );
+            if( row.table_name == "" )
+               sqlite3_bind_null(p_stmt, 3);
+            else sqlite3_bind_text(
+               p_stmt, 3, row.table_name.c_str(), -1, SQLITE_TRANSIENT
+            );
+            if( row.row_id == DISMOD_AT_NULL_SIZE_T )
+               sqlite3_bind_null(p_stmt, 4);
+            else
+               sqlite3_bind_int64(p_stmt, 4, sqlite3_int64( row.row_id ) );
+            sqlite3_bind_int64(p_stmt, 5, sqlite3_int64( row.unix_time ) );
+            sqlite3_bind_text(
+               p_stmt, 6, message.c_str(), -1, SQLITE_TRANSIENT
+            );
+            rc = sqlite3_step(p_stmt);
+            if( rc != SQLITE_DONE )
+            {  string msg = "log_message: insert into log table failed";
+               dismod_at::error_exit(msg);
+            }
+            sqlite3_reset(p_stmt);
+         }
+      }
+      if( transaction )
+         dismod_at::exec_sql_cmd(db, "commit");
+      sqlite3_finalize(p_stmt);
+      row_buffer_.clear();
+   }
+}
+
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
+void log_buffer(sqlite3* db, bool buffer)
+{  std::lock_guard<std::recursive_mutex> lock(log_mutex_);
+   if( buffer_db_ != DISMOD_AT_NULL_PTR && ! recursive_ )
+   {  recursive_ = true;
+      log_flush(buffer_db_);
+      recursive_ = false;
+      for(const log_row_struct& nested : nested_buffer_)
+         row_buffer_.push_back(nested);
+      nested_buffer_.clear();
+   }
+   buffer_db_ = DISMOD_AT_NULL_PTR;
+   if( buffer )
+      buffer_db_ = db;
+}
+
 std::time_t log_message(
    sqlite3*           db           ,
    std::ostream*      os           ,
@@ -123,11 +310,7 @@ std::time_t log_message(
    const std::string& message      ,
    const std::string& table_name   ,
    const size_t&      row_id       )
-{  static bool recursive = false;
-   using std::string;
-   using CppAD::to_string;
-
-   // check assumption one table_name and row_id columns of log
+{  // check assumption one table_name and row_id columns of log
    assert( table_name != "" || row_id == DISMOD_AT_NULL_SIZE_T );
 
    // check message type
@@ -140,6 +323,9 @@ std::time_t log_message(
    // get time
    std::time_t unix_time = std::time( DISMOD_AT_NULL_PTR );
    //
+   // the rest of this routine uses the shared state
+   std::lock_guard<std::recursive_mutex> lock(log_mutex_);
+   //
    // write errors and warnings to standard error
    bool write2os = os != DISMOD_AT_NULL_PTR;
    write2os &= (message_type == "error" || message_type == "warning" );
@@ -153,57 +339,54 @@ std::time_t log_message(
       }
    }
    //
-   if( ! recursive )
-   {  recursive = true;
+   // row
+   log_row_struct row =
+      { message_type, table_name, row_id, unix_time, message, 1 };
+   //
+   if( recursive_ )
+   {  // called by log_flush (through error_exit) while it is writing
+      // row_buffer_; hold this message until that write is done
+      nested_buffer_.push_back(row);
       //
-      string sql_cmd = "create table if not exists log("
-         " log_id              integer primary key,"
-         " message_type        text,"
-         " table_name          text,"
-         " row_id              integer,"
-         " unix_time           integer,"
-         " message             text"
-         ");";
-      dismod_at::exec_sql_cmd(db, sql_cmd);
-
-      // message with single quotes escaped
-      string escaped_message = "";
-      for(size_t i = 0; i < message.size(); i++)
-      {  if( message[i] == '\'' )
-            escaped_message += "''";
-         else
-            escaped_message += message[i];
+      // error_exit does not return, so make sure the error is seen
+      if( message_type == "error" && ! write2os )
+         std::cerr << "dismod_at error: " << message << std::endl;
+   }
+   else
+   {  recursive_ = true;
+      //
+      // messages held for a different database
+      if( buffer_db_ != DISMOD_AT_NULL_PTR && buffer_db_ != db )
+         log_flush(buffer_db_);
+      //
+      // add this message to row_buffer_
+      bool repeat = message_type == "warning" && row_buffer_.size() > 0;
+      if( repeat )
+      {  const log_row_struct& last = row_buffer_.back();
+         repeat &= last.message_type == message_type;
+         repeat &= last.table_name   == table_name;
+         repeat &= last.row_id       == row_id;
+         repeat &= last.message      == message;
       }
-
-      // determine next primary key value
-      string select_cmd  = "select * from log";
-      string column_name = "log_id";
-      string max_str     = get_column_max(db, select_cmd, column_name);
-      size_t log_id      = 0;
-      if( max_str != "" )
-         log_id = std::atoi( max_str.c_str() ) + 1;
-
-      // add this message to the log file
-      sql_cmd  = "insert into log values ( ";
-      sql_cmd += to_string( log_id );
-      sql_cmd += " , '";
-      sql_cmd += message_type;
-      if( table_name  == "" )
-         sql_cmd += "' , null,";
-      else
-         sql_cmd += "' , '" + table_name + "', ";
-      if( row_id == DISMOD_AT_NULL_SIZE_T )
-         sql_cmd += "null";
+      if( repeat )
+         ++row_buffer_.back().count;
       else
-         sql_cmd += to_string( row_id );
-      sql_cmd += " , ";
-      sql_cmd += to_string( unix_time );
-      sql_cmd += " , '";
-      sql_cmd += escaped_message;
-      sql_cmd += "' );";
-      dismod_at::exec_sql_cmd(db, sql_cmd);
+         row_buffer_.push_back(row);
+      //
+      // write row_buffer_ to the log table
+      bool flush = buffer_db_ != db;
+      flush     |= message_type == "command" || message_type == "error";
+      flush     |= row_buffer_.size() >= max_row_buffer;
+      flush     |= unix_time - flush_time_ >= max_hold_time;
+      if( flush )
+         log_flush(db);
+      recursive_ = false;
+      //
+      // messages logged during the flush are written by the next flush
+      for(const log_row_struct& nested : nested_buffer_)
+         row_buffer_.push_back(nested);
+      nested_buffer_.clear();
    }
-   recursive = false;
    //
    return unix_time;
 }
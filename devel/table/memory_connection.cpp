@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin memory_connection dev}
+
+Working Copy of a Database in Memory
+####################################
+
+Syntax
+******
+
+| *db* = ``open_memory_connection`` ( *disk_db* )
+| ``close_connection`` ( *db* )
+
+Purpose
+*******
+Copy a database into memory, run a command using the copy,
+and then write the result back to the original file using one
+sequential read and one sequential write.
+
+disk_db
+*******
+This is a connection to a database that is stored in a file;
+e.g., the return value of :ref:`open_connection-name` .
+This connection is closed by ``open_memory_connection`` .
+
+db
+**
+The return value of ``open_memory_connection`` is a connection to an
+in memory copy of the database corresponding to *disk_db* .
+The name of the original file is stored in the temporary table
+``temp.memory_file`` for this connection
+(temporary tables are not part of the copy that is written back).
+Hence there is no global state and more than one
+such connection can be open at the same time.
+
+close_connection
+****************
+If *db* is the return value of ``open_memory_connection`` ,
+the in memory database is written to a new temporary file in the same
+directory as the original file, and then the temporary file is renamed
+to be the original file.
+The temporary file has a unique name, with the original file name as
+its prefix, so no other file is changed.
+Hence either all or none of the changes made using *db* appear
+in the original file.
+If this fails, the temporary file is removed, an error message is
+written to standard error, and the program exits.
+If *db* is any other connection, ``close_connection`` is the same as
+``sqlite3_close`` ( *db* ) .
+
+{xrst_toc_hidden
+   example/devel/table/memory_connection_xam.cpp
+}
+Example
+*******
+The file :ref:`memory_connection_xam.cpp-name` is an example use of
+``open_memory_connection`` and ``close_connection`` .
+
+{xrst_end memory_connection}
+-----------------------------------------------------------------------------
+*/
+# include <cstdio>
+# include <cstdlib>
+# include <cassert>
+# include <iostream>
+# include <dismod_at/memory_connection.hpp>
+# include <dismod_at/exec_sql_cmd.hpp>
+# include <dismod_at/error_exit.hpp>
+# include <dismod_at/configure.hpp>
+
+# ifdef _WIN32
+# include <io.h>
+# include <fcntl.h>
+# else
+# include <unistd.h>
+# include <sys/stat.h>
+# endif
+
+namespace {
+   // memory_file: file that db was copied from (empty if not in memory)
+   std::string memory_file(sqlite3* db)
+   {  std::string   result = "";
+      sqlite3_stmt* stmt   = DISMOD_AT_NULL_PTR;
+      const char*   sql    = "select file_name from temp.memory_file";
+      int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, DISMOD_AT_NULL_PTR);
+      if( rc == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW )
+      {  const unsigned char* text = sqlite3_column_text(stmt, 0);
+         if( text != DISMOD_AT_NULL_PTR )
+            result = reinterpret_cast<const char*>(text);
+      }
+      sqlite3_finalize(stmt);
+      return result;
+   }
+   //
+   // backup: copy all of the main database in src to dest
+   bool backup(sqlite3* dest, sqlite3* src)
+   {  sqlite3_backup* p_backup = sqlite3_backup_init(dest, "main", src, "main");
+      if( p_backup == DISMOD_AT_NULL_PTR )
+         return false;
+      sqlite3_backup_step(p_backup, -1);
+      int rc = sqlite3_backup_finish(p_backup);
+      return rc == SQLITE_OK;
+   }
+   //
+   // new_temp_file: create a new file with a unique name that begins with
+   // prefix, and the same permissions as the file prefix, and return its name
+   // (empty if this fails).
+   std::string new_temp_file(const std::string& prefix)
+   {  std::string temp_file = prefix + ".XXXXXX";
+# ifdef _WIN32
+      if( _mktemp_s( &temp_file[0], temp_file.size() + 1 ) != 0 )
+         return "";
+      int fd = _open(
+         temp_file.c_str(), _O_CREAT | _O_EXCL | _O_RDWR, _S_IREAD | _S_IWRITE
+      );
+      if( fd < 0 )
+         return "";
+      _close(fd);
+# else
+      int fd = ::mkstemp( &temp_file[0] );
+      if( fd < 0 )
+         return "";
+      struct stat file_stat;
+      if( ::stat( prefix.c_str(), &file_stat ) == 0 )
+         ::fchmod( fd, file_stat.st_mode & 07777 );
+      ::close(fd);
+# endif
+      return temp_file;
+   }
+}
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+sqlite3* open_memory_connection(sqlite3* disk_db)
+{  //
+   // file_name
+   const char* file_name = sqlite3_db_filename(disk_db, "main");
+   if( file_name == DISMOD_AT_NULL_PTR || file_name[0] == '\0' )
+   {  std::string msg = "open_memory_connection: disk_db is not a file";
+      error_exit(msg);
+   }
+   //
+   // db
+   sqlite3* db;
+   int rc  = sqlite3_open(":memory:", &db);
+   bool ok = rc == SQLITE_OK;
+   if( ok )
+      ok = backup(db, disk_db);
+   if( ! ok )
+   {  sqlite3_close(db);
+      std::string msg = "open_memory_connection: could not copy ";
+      msg += std::string(file_name) + " into memory";
+      error_exit(msg);
+   }
+   //
+   // temp.memory_file
+   std::string file_str = file_name;
+   std::string quoted   = "";
+   for(char c : file_str)
+   {  quoted += c;
+      if( c == '\'' )
+         quoted += c;
+   }
+   exec_sql_cmd(db, "create temp table memory_file(file_name text)");
+   exec_sql_cmd(db,
+      "insert into temp.memory_file values('" + quoted + "')"
+   );
+   sqlite3_close(disk_db);
+   return db;
+}
+
+void close_connection(sqlite3* db)
+{  //
+   // file_name
+   std::string file_name = memory_file(db);
+   if( file_name == "" )
+   {  sqlite3_close(db);
+      return;
+   }
+   //
+   // temp_file
+   std::string temp_file = new_temp_file(file_name);
+   bool ok = temp_file != "";
+   //
+   // write to the temporary file
+   if( ok )
+   {  sqlite3* temp_db = DISMOD_AT_NULL_PTR;
+      ok = sqlite3_open(temp_file.c_str(), &temp_db) == SQLITE_OK;
+      if( ok )
+         ok = backup(temp_db, db);
+      if( temp_db != DISMOD_AT_NULL_PTR )
+         ok &= sqlite3_close(temp_db) == SQLITE_OK;
+   }
+   sqlite3_close(db);
+   //
+   // replace the original file
+   if( ok )
+      ok = std::rename( temp_file.c_str(), file_name.c_str() ) == 0;
+   if( ! ok )
+   {  if( temp_file != "" )
+         std::remove( temp_file.c_str() );
+      // cannot use error_exit because it calls close_connection
+      std::cerr << "close_connection: could not write the in memory copy to "
+         << file_name << std::endl;
+      std::exit(1);
+   }
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin sqlite_profile dev}
+{xrst_spell
+   mmap
+}
+
+Set SQLite Performance Settings for a Database Connection
+#########################################################
+
+Syntax
+******
+
+| *message* = ``sqlite_profile`` ( *db* , *profile* )
+| *bulk* = ``sqlite_bulk_begin`` ( *db* , *n_value* )
+| ``sqlite_bulk_end`` ( *db* )
+
+db
+**
+is an open connection to the database.
+
+profile
+*******
+is the value of :ref:`option_table@sqlite_profile` ; i.e.,
+``safe`` , ``fast`` , or ``bulk`` .
+The following pragmas are set for each profile:
+
+.. csv-table::
+   :widths: auto
+   :header-rows: 1
+
+   pragma, safe, fast, bulk
+   page_size, , 65536, 65536
+   journal_mode, , truncate, memory
+   synchronous, , normal, off
+   cache_size, , -65536, -262144
+   mmap_size, , 268435456, 1073741824
+   temp_store, , memory, memory
+
+An empty entry means the SQLite default is not changed.
+The page size only changes for a database that does not yet
+contain any tables.
+
+message
+*******
+is a message, suitable for the :ref:`log_table-name` ,
+that contains the profile and the value of each of the pragmas above
+after the profile has been applied.
+
+sqlite_bulk_begin
+*****************
+If *n_value* is greater than or equal one million,
+and the ``fast`` profile settings are in effect for *db*
+(the journal mode is ``truncate`` and synchronous is ``normal`` ),
+the ``bulk`` setting for the pragmas
+``journal_mode`` , ``synchronous`` , and ``cache_size``
+are used until the next call to ``sqlite_bulk_end`` .
+The profile is determined from the connection, not stored by
+``sqlite_profile`` , so these routines do not have any global state.
+This must be called outside of a transaction.
+
+n_value
+=======
+is the number of values that are about to be written to a table.
+
+bulk
+====
+is true if the ``bulk`` settings were applied.
+In this case, ``sqlite_bulk_end`` must be called
+directly after the table is written.
+
+sqlite_bulk_end
+***************
+This restores the ``fast`` settings.
+This must be called outside of a transaction.
+
+{xrst_end sqlite_profile}
+*/
+
+# include <cassert>
+# include <dismod_at/sqlite_profile.hpp>
+# include <dismod_at/exec_sql_cmd.hpp>
+
+namespace {
+   // pragma_value
+   std::string pragma_value(sqlite3* db, const std::string& name)
+   {  char sep = ',';
+      std::string sql_cmd = "pragma " + name;
+      std::string result  = dismod_at::exec_sql_cmd(db, sql_cmd, sep);
+      while( result.size() > 0 && result.back() == '\n' )
+         result.pop_back();
+      return result;
+   }
+   //
+   // set_pragma
+   void set_pragma(
+      sqlite3* db, const std::string& name, const std::string& value
+   )
+   {  std::string sql_cmd = "pragma " + name + " = " + value;
+      dismod_at::exec_sql_cmd(db, sql_cmd);
+   }
+}
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+std::string sqlite_profile(sqlite3* db, const std::string& profile)
+{  assert( profile == "safe" || profile == "fast" || profile == "bulk" );
+   //
+   if( profile == "fast" )
+   {  set_pragma(db, "page_size",    "65536");
+      set_pragma(db, "journal_mode", "truncate");
+      set_pragma(db, "synchronous",  "normal");
+      set_pragma(db, "cache_size",   "-65536");
+      set_pragma(db, "mmap_size",    "268435456");
+      set_pragma(db, "temp_store",   "memory");
+   }
+   if( profile == "bulk" )
+   {  set_pragma(db, "page_size",    "65536");
+      set_pragma(db, "journal_mode", "memory");
+      set_pragma(db, "synchronous",  "off");
+      set_pragma(db, "cache_size",   "-262144");
+      set_pragma(db, "mmap_size",    "1073741824");
+      set_pragma(db, "temp_store",   "memory");
+   }
+   //
+   // message
+   const char* name_list[] = {
+      "page_size",
+      "journal_mode",
+      "synchronous",
+      "cache_size",
+      "mmap_size",
+      "temp_store"
+   };
+   std::string message = "sqlite_profile = " + profile;
+   for(const char* name : name_list)
+   {  message += ", ";
+      message += name;
+      message += " = " + pragma_value(db, name);
+   }
+   return message;
+}
+
+bool sqlite_bulk_begin(sqlite3* db, size_t n_value)
+{  if( n_value < 1000000 )
+      return false;
+   // check for the fast profile (synchronous = normal is 1)
+   if( pragma_value(db, "journal_mode") != "truncate" )
+      return false;
+   if( pragma_value(db, "synchronous") != "1" )
+      return false;
+   set_pragma(db, "journal_mode", "memory");
+   set_pragma(db, "synchronous",  "off");
+   set_pragma(db, "cache_size",   "-262144");
+   return true;
+}
+
+void sqlite_bulk_end(sqlite3* db)
+{  set_pragma(db, "journal_mode", "truncate");
+   set_pragma(db, "synchronous",  "normal");
+   set_pragma(db, "cache_size",   "-65536");
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# include <cmath>
+# include <cassert>
+# include <utility>
+# include <algorithm>
+# include <dismod_at/block_cholesky.hpp>
+
+/*
+{xrst_begin block_cholesky dev}
+{xrst_spell
+  cholesky
+}
+
+Cholesky Factor of a Block Diagonal Sparse Symmetric Matrix
+###########################################################
+
+Syntax
+******
+
+| ``block_cholesky`` *chol* ( *n* , *row* , *col* , *val* )
+| *ok* = *chol* . ``ok`` ()
+| *n_block* = *chol* . ``n_block`` ()
+| *quad* = *chol* . ``inv_quad`` ( *g* )
+
+Purpose
+*******
+Given a sparse symmetric matrix :math:`H`, this routine partitions
+its indices into blocks that are not connected by any non-zero
+element of :math:`H` and computes a dense Cholesky factor for each block.
+This is efficient when :math:`H` is block diagonal
+with small blocks; e.g., the Hessian of the fixed effects objective,
+or the Hessian of the random effects objective
+(which has one block for each child when the random effects
+for different children are independent).
+
+n
+*
+is the dimension of the matrix :math:`H` .
+
+row, col, val
+*************
+These vectors have the same size and
+for each *k* ,
+
+   *H* [ *row* [ *k* ], *col* [ *k* ] ] = *val* [ *k* ]
+
+The matrix is symmetric and only one of each off diagonal pair needs
+to be specified; e.g., the lower triangle.
+Pairs of indices that do not appear are zero.
+If an index does not appear in *row* or *col* ,
+the corresponding row and column of :math:`H`
+are not part of any block
+(and do not contribute to *quad* below).
+
+ok
+**
+is true (false) if the matrix restricted to the indices that appear
+is (is not) positive definite.
+
+n_block
+*******
+is the number of blocks in the partition.
+
+inv_quad
+********
+If *ok* is true, this returns the value
+
+.. math::
+
+   g^\R{T} H^{-1} g
+
+where :math:`g` is the vector *g* restricted to the indices that appear
+and :math:`H` is the matrix restricted to these indices.
+The vector *g* has size *n* .
+Blocks for which *g* is zero are skipped.
+
+{xrst_toc_hidden
+   example/devel/utility/block_cholesky_xam.cpp
+}
+Example
+*******
+The file :ref:`block_cholesky_xam.cpp-name`
+contains an example and test of this class.
+
+{xrst_end block_cholesky}
+*/
+
+namespace { // BEGIN_EMPTY_NAMESPACE
+   // root of the union-find tree that contains i
+   size_t find_root(CppAD::vector<size_t>& parent, size_t i)
+   {  while( parent[i] != i )
+      {  parent[i] = parent[ parent[i] ];
+         i         = parent[i];
+      }
+      return i;
+   }
+} // END_EMPTY_NAMESPACE
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// constructor
+block_cholesky::block_cholesky(
+   size_t                        n   ,
+   const CppAD::vector<size_t>&  row ,
+   const CppAD::vector<size_t>&  col ,
+   const CppAD::vector<double>&  val )
+: n_(n)
+, block_(n)
+, local_(n)
+, n_block_(0)
+, ok_(true)
+, temp_(0)
+{  size_t nnz = row.size();
+   assert( col.size() == nnz );
+   assert( val.size() == nnz );
+   //
+   // present, parent
+   CppAD::vector<bool>   present(n);
+   CppAD::vector<size_t> parent(n);
+   for(size_t i = 0; i < n; ++i)
+   {  present[i] = false;
+      parent[i]  = i;
+   }
+   for(size_t k = 0; k < nnz; ++k)
+   {  size_t r = row[k];
+      size_t c = col[k];
+      assert( r < n && c < n );
+      present[r] = true;
+      present[c] = true;
+      size_t root_r = find_root(parent, r);
+      size_t root_c = find_root(parent, c);
+      if( root_r != root_c )
+         parent[root_r] = root_c;
+   }
+   //
+   // n_block_, block_, local_, index_
+   CppAD::vector<size_t> root2block(n);
+   for(size_t i = 0; i < n; ++i)
+      root2block[i] = n;
+   for(size_t i = 0; i < n; ++i) if( present[i] )
+   {  size_t root = find_root(parent, i);
+      if( root2block[root] == n )
+         root2block[root] = n_block_++;
+   }
+   index_.resize(n_block_);
+   for(size_t i = 0; i < n; ++i)
+   {  if( ! present[i] )
+      {  block_[i] = n_block_;
+         local_[i] = 0;
+      }
+      else
+      {  size_t b = root2block[ find_root(parent, i) ];
+         block_[i] = b;
+         local_[i] = index_[b].size();
+         index_[b].push_back(i);
+      }
+   }
+   //
+   // factor_: matrix values for each block (lower triangle)
+   factor_.resize(n_block_);
+   size_t max_size = 0;
+   for(size_t b = 0; b < n_block_; ++b)
+   {  size_t m = index_[b].size();
+      max_size  = std::max(max_size, m);
+      factor_[b].resize(m * m);
+      for(size_t ell = 0; ell < m * m; ++ell)
+         factor_[b][ell] = 0.0;
+   }
+   temp_.resize(max_size);
+   for(size_t k = 0; k < nnz; ++k)
+   {  size_t b = block_[ row[k] ];
+      size_t i = local_[ row[k] ];
+      size_t j = local_[ col[k] ];
+      if( i < j )
+         std::swap(i, j);
+      factor_[b][ i * index_[b].size() + j ] = val[k];
+   }
+   //
+   // factor_: Cholesky factor for each block
+   for(size_t b = 0; b < n_block_; ++b)
+   {  size_t m = index_[b].size();
+      CppAD::vector<double>& L = factor_[b];
+      for(size_t j = 0; j < m; ++j)
+      {  double sum = L[j * m + j];
+         for(size_t k = 0; k < j; ++k)
+            sum -= L[j * m + k] * L[j * m + k];
+         if( ! (sum > 0.0) )
+         {  ok_ = false;
+            return;
+         }
+         double diag   = std::sqrt(sum);
+         L[j * m + j]  = diag;
+         for(size_t i = j + 1; i < m; ++i)
+         {  sum = L[i * m + j];
+            for(size_t k = 0; k < j; ++k)
+               sum -= L[i * m + k] * L[j * m + k];
+            L[i * m + j] = sum / diag;
+         }
+      }
+   }
+}
+
+// ok
+bool block_cholesky::ok(void) const
+{  return ok_; }
+
+// n_block
+size_t block_cholesky::n_block(void) const
+{  return n_block_; }
+
+// inv_quad
+double block_cholesky::inv_quad(const CppAD::vector<double>& g) const
+{  assert( ok_ );
+   assert( g.size() == n_ );
+   double result = 0.0;
+   for(size_t b = 0; b < n_block_; ++b)
+   {  const CppAD::vector<size_t>& index = index_[b];
+      const CppAD::vector<double>& L     = factor_[b];
+      size_t m = index.size();
+      //
+      // skip this block if g is zero for this block
+      bool zero = true;
+      for(size_t i = 0; i < m; ++i)
+         zero &= g[ index[i] ] == 0.0;
+      if( ! zero )
+      {  // solve L * y = g and add y^T * y to result
+         for(size_t i = 0; i < m; ++i)
+         {  double sum = g[ index[i] ];
+            for(size_t k = 0; k < i; ++k)
+               sum -= L[i * m + k] * temp_[k];
+            temp_[i] = sum / L[i * m + i];
+            result  += temp_[i] * temp_[i];
+         }
+      }
+   }
+   return result;
+}
+
+} // END_DISMOD_AT_NAMESPACE
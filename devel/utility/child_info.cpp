@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-22 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 /*
 {xrst_begin child_info dev}
@@ -160,37 +160,53 @@ child_info::child_info(
          child_id2node_id_.push_back(node_id);
    }
 
+   // node_id2child
+   // The child index for each node is computed once, the first time a
+   // table row for the node, or one of its descendants, is mapped.
+   // The value unknown means not yet computed and visiting means the node
+   // is on the path currently being walked (used to detect cycles).
+   size_t n_node   = node_table.size();
+   size_t n_child  = child_id2node_id_.size();
+   size_t unknown  = n_child + 2;
+   size_t visiting = n_child + 3;
+   CppAD::vector<size_t> node_id2child(n_node);
+   for(size_t node_id = 0; node_id < n_node; ++node_id)
+      node_id2child[node_id] = unknown;
+   if( parent_node_id < n_node )
+      node_id2child[parent_node_id] = n_child;
+   for(size_t child_id = 0; child_id < n_child; ++child_id)
+      node_id2child[ child_id2node_id_[child_id] ] = child_id;
+
    // table_id2child_id
+   CppAD::vector<size_t> path;
    size_t n_table = table.size();
    table_id2child_.resize(n_table);
    for(size_t table_id = 0; table_id < n_table; table_id++)
    {  size_t node_id = size_t( table[table_id].node_id );
-      // check if this is the parent node
-      bool   found   = parent_node_id == node_id;
-      // special child index for the parent node
-      size_t child   = child_id2node_id_.size();
-      // loop to check child nodes
-      bool   more    = ! found;
-      while(more)
-      {  for(size_t i = 0; i < child_id2node_id_.size(); i++)
-         {  if( child_id2node_id_[i] == node_id )
-            {  child = i;
-               found = true;
-            }
+      // special child index for not the parent or one of its descendants
+      size_t child   = n_child + 1;
+      // walk up the tree until a node with a known child index is found
+      path.resize(0);
+      while( node_id != DISMOD_AT_NULL_SIZE_T )
+      {  size_t label = node_id2child[node_id];
+         if( label == visiting )
+         {  // infinite loop checking if parent_node_id is an ancestor
+            std::string msg = "This node is a descendant of itself";
+            error_exit(msg, "node", node_id);
+         }
+         if( label != unknown )
+         {  child   = label;
+            node_id = DISMOD_AT_NULL_SIZE_T;
          }
-         more = (! found) && (node_id != DISMOD_AT_NULL_SIZE_T);
-         if( more )
-         {  size_t parent = size_t ( node_table[node_id].parent );
-            if( parent == node_id )
-            {  // infinite loop checking if parent_node_id is an ancestor
-               std::string msg = "This node is a descendant of itself";
-               error_exit(msg, "node", node_id);
-            }
-            node_id = parent;
+         else
+         {  node_id2child[node_id] = visiting;
+            path.push_back(node_id);
+            node_id = size_t( node_table[node_id].parent );
          }
       }
-      if( ! found )
-         child = child_id2node_id_.size() + 1;
+      // every node on the path has the same child index
+      for(size_t k = 0; k < path.size(); ++k)
+         node_id2child[ path[k] ] = child;
       table_id2child_[table_id] = child;
    }
 }
@@ -85,6 +85,12 @@ for :math:`C(a, t)` at the corresponding age and time.
 {xrst_toc_hidden
    example/devel/utility/cohort_ode_xam.cpp
 }
+Checkpoint
+**********
+If *Float* is ``a1_double`` , each step of the ODE is computed
+using :ref:`ode2_checkpoint-name` ; i.e., it is one atomic operation
+in the corresponding CppAD tape.
+
 Example
 *******
 The file :ref:`cohort_ode_xam.cpp-name` contains
@@ -97,6 +103,28 @@ It returns true for success and false for failure.
 # include <dismod_at/eigen_ode2.hpp>
 # include <dismod_at/trap_ode2.hpp>
 # include <dismod_at/a1_double.hpp>
+# include <dismod_at/ode2_checkpoint.hpp>
+
+namespace { // BEGIN_EMPTY_NAMESPACE
+   // double version of one step in solving the ODE
+   CppAD::vector<double> ode2_step(
+      size_t                           case_number ,
+      const CppAD::vector<double>&     b           ,
+      const CppAD::vector<double>&     yi          ,
+      const double&                    tf          )
+   {  if( case_number == 0 )
+         return dismod_at::trap_ode2(b, yi, tf);
+      return dismod_at::eigen_ode2(case_number, b, yi, tf);
+   }
+   // a1_double version of one step (one atomic operation in a tape)
+   CppAD::vector<dismod_at::a1_double> ode2_step(
+      size_t                                       case_number ,
+      const CppAD::vector<dismod_at::a1_double>&   b           ,
+      const CppAD::vector<dismod_at::a1_double>&   yi          ,
+      const dismod_at::a1_double&                  tf          )
+   {  return dismod_at::ode2_checkpoint(case_number, b, yi, tf);
+   }
+} // END_EMPTY_NAMESPACE
 
 namespace dismod_at { // BEGIN DISMOD_AT_NAMESPACE
 
@@ -174,10 +202,7 @@ void cohort_ode(
       tf    = age[k] - age[k-1];
       //
       // one step in solving ODE for this cohort
-      if( case_number == 0 )
-         yf = trap_ode2(b, yi, tf);
-      else
-         yf = eigen_ode2(case_number, b, yi, tf);
+      yf = ode2_step(case_number, b, yi, tf);
       //
       // copy result to output vector
       s_out[k] = yf[0];
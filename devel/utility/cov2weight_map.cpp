@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 /*
 {xrst_begin cov2weight_map dev}
@@ -73,22 +73,58 @@ that corresponds to this covariate name.
 split_value_vec\_
 -----------------
 This vector contains all the :ref:`split values<rate_eff_cov_table@split_value>`
-that appear in rate_eff_cov table.
+that appear in rate_eff_cov table in increasing order.
 In the special case where the splitting covariate is empty,
 or the rate_eff_cov table is empty, this contains the single value zero.
 
+cov_offset\_
+------------
+This vector has size *n_covariate* .
+If *covariate_id* is **not** in the rate_eff_cov table,
+cov_offset_[covariate_id] is ``DISMOD_AT_NULL_SIZE_T`` .
+Otherwise, it is the offset in weight_id_vec\_ where the weightings
+for this covariate start.
+
 weight_id_vec\_
 ---------------
-For *covariate_id* equal zero to *n_covariate* - 1,
+Only covariates that appear in the rate_eff_cov table have entries
+in this vector.
+For such a *covariate_id* ,
 *node_id* equal to zero to *n_node* - 1,
 and *split_id* equal to zero to split_value_vec\_.size() - 1, let::
 
-   index = (n_node * covariate_id + node_id) * n_split + split_id
+   index = cov_offset_[covariate_id] + node_id * n_split + split_id
+
+weight_id_vec_[index] is the corresponding *weight_id* in rate_eff_cov table
+(or *n_weight* if there is no such entry).
+
+split_id
+********
 
-#. if *covariate_id* is in the rate_eff_cov table,
-   weight_id_vec_[index] is the corresponding *weight_id* in rate_eff_cov table.
-#. if *covariate_id* is **not** in the rate_eff_cov table,
-   weight_id_vec_[index] is *n_weight*.
+Syntax
+======
+{xrst_literal
+   // BEGIN_SPLIT_ID
+   // END_SPLIT_ID
+}
+
+x
+=
+This vector has length *n_covariate* and contains the covariate
+value, minus its reference, for covariates that are not in the rate_eff_cov table.
+In particular::
+
+   x[split_value_id_] + split_value_reference_
+
+is the value of the splitting covariate.
+
+split_id
+========
+is the index in split_value_vec\_ corresponding to the
+splitting covariate value in *x* .
+If the splitting covariate is empty, *split_id* is zero.
+This can be computed once for each data or avgint row and then
+used for all the covariates for that row.
 
 weight_id
 *********
@@ -108,15 +144,11 @@ node_id
 =======
 This specifies the node we are retrieving the weighting for.
 
-x
-=
-This vector has length *n_covariate* and contains the covariate
-value, minus its reference, for covariates that are not in the rate_eff_cov table.
-In particular::
-
-   x[split_value_id_] + split_value_reference_
-
-is the value of the splitting covariate.
+split_id
+========
+is the return value of ``split_id`` ( *x* ) .
+There is also a version of ``weight_id`` where *split_id* is replaced by
+*x* ; it is the same as using ``split_id`` ( *x* ) for *split_id* .
 
 weight_id
 =========
@@ -136,7 +168,9 @@ n_weight
 */
 # include <set>
 # include <string>
+# include <algorithm>
 # include <dismod_at/cov2weight_map.hpp>
+# include <dismod_at/null_int.hpp>
 // ---------------------------------------------------------------------------
 // BEGIN_CTOR_INPUTS
 dismod_at::cov2weight_map::cov2weight_map(
@@ -181,68 +215,88 @@ n_weight_( n_weight )
          split_value_vec_.push_back( *itr );
    }
    //
-   // weight_id_vec_
+   // cov_offset_
    size_t n_split = split_value_vec_.size();
-   size_t n_weight_id   = n_covariate_ * n_node_ * n_split;
+   cov_offset_.resize( n_covariate_ );
+   for(size_t covariate_id = 0; covariate_id < n_covariate_; ++covariate_id)
+      cov_offset_[covariate_id] = DISMOD_AT_NULL_SIZE_T;
+   size_t n_weight_id = 0;
+   for(size_t rec_id = 0; rec_id < n_rate_eff_cov; ++rec_id)
+   {  size_t covariate_id = size_t( rate_eff_cov_table[rec_id].covariate_id );
+      assert( covariate_id < n_covariate_ );
+      if( cov_offset_[covariate_id] == DISMOD_AT_NULL_SIZE_T )
+      {  cov_offset_[covariate_id] = n_weight_id;
+         n_weight_id += n_node_ * n_split;
+      }
+   }
+   //
+   // weight_id_vec_
    weight_id_vec_.resize( n_weight_id );
    for(size_t index = 0; index < n_weight_id; ++index )
       weight_id_vec_[index] = n_weight_;
    for(size_t rec_id = 0; rec_id < n_rate_eff_cov; ++rec_id)
-   {  int covariate_id    = rate_eff_cov_table[rec_id].covariate_id;
-      int node_id         = rate_eff_cov_table[rec_id].node_id;
-      int weight_id       = rate_eff_cov_table[rec_id].weight_id;
-      assert( size_t( covariate_id ) < n_covariate_ );
-      assert( size_t( node_id )      < n_node_ );
-      assert( size_t( weight_id )    < n_weight_ );
+   {  size_t covariate_id = size_t( rate_eff_cov_table[rec_id].covariate_id );
+      size_t node_id      = size_t( rate_eff_cov_table[rec_id].node_id );
+      size_t weight_id    = size_t( rate_eff_cov_table[rec_id].weight_id );
+      assert( node_id      < n_node_ );
+      assert( weight_id    < n_weight_ );
       //
-      double split_value  = rate_eff_cov_table[rec_id].split_value;
-      size_t split_id = n_split;
-      for(size_t i = 0; i < n_split; ++i)
-      {  if( split_value_vec_[i] == split_value )
-         {  assert( split_id == n_split );
-            split_id = i;
-         }
+      // split_id
+      size_t split_id = 0;
+      if( split_covariate_id_ != n_covariate_ )
+      {  double split_value  = rate_eff_cov_table[rec_id].split_value;
+         split_id = size_t( std::lower_bound(
+            split_value_vec_.begin(), split_value_vec_.end(), split_value
+         ) - split_value_vec_.begin() );
+         assert( split_value_vec_[split_id] == split_value );
       }
-      assert( split_id != n_split );
-      size_t index = (n_node * covariate_id + node_id) * n_split + split_id;
+      size_t index = cov_offset_[covariate_id] + node_id * n_split + split_id;
       weight_id_vec_[index] = weight_id;
    }
 }
 // ---------------------------------------------------------------------------
+// BEGIN_SPLIT_ID
+size_t dismod_at::cov2weight_map::split_id(
+   const CppAD::vector<double>& x ) const
+// END_SPLIT_ID
+{  if( split_covariate_id_ == n_covariate_ )
+      return 0;
+   //
+   // binary search for this split value
+   double split_value = x[split_covariate_id_] + split_covariate_reference_;
+   size_t n_split     = split_value_vec_.size();
+   size_t split_id    = size_t( std::lower_bound(
+      split_value_vec_.begin(), split_value_vec_.end(), split_value
+   ) - split_value_vec_.begin() );
+   assert( split_id < n_split );
+   assert( split_value_vec_[split_id] == split_value );
+   if( split_id == n_split )
+      split_id = 0;
+   return split_id;
+}
+// ---------------------------------------------------------------------------
 // BEGIN_WEIGHT_ID
 size_t dismod_at::cov2weight_map::weight_id(
    size_t                       covariate_id ,
    size_t                       node_id      ,
-   const CppAD::vector<double>& x            ) const
+   size_t                       split_id     ) const
 // END_WEIGHT_ID
-{  //
-   // check if rate_eff_cov table is empty
-
-
-   // n_split
-   size_t n_split = split_value_vec_.size();
-   //
-   // split_id
-   size_t split_id = n_split;
-   if( split_covariate_id_ != n_covariate_ )
-   {  double split_value = x[split_covariate_id_] + split_covariate_reference_;
-      for(size_t i = 0; i < n_split; ++i)
-      {  if( split_value_vec_[i] == split_value )
-         {  assert( split_id == n_split );
-            split_id = i;
-         }
-      }
-      assert( split_id != n_split );
-   }
-   if( split_id == n_split )
-      split_id = 0;
-   //
-   assert( covariate_id < n_covariate_ );
+{  assert( covariate_id < n_covariate_ );
    assert( node_id < n_node_ );
-   assert( split_id < n_split );
-   size_t index = (n_node_ * covariate_id + node_id) * n_split + split_id;
+   assert( split_id < split_value_vec_.size() );
+   //
+   size_t offset = cov_offset_[covariate_id];
+   if( offset == DISMOD_AT_NULL_SIZE_T )
+      return n_weight_;
+   size_t n_split = split_value_vec_.size();
+   size_t index   = offset + node_id * n_split + split_id;
    return weight_id_vec_[index];
 }
+size_t dismod_at::cov2weight_map::weight_id(
+   size_t                       covariate_id ,
+   size_t                       node_id      ,
+   const CppAD::vector<double>& x            ) const
+{  return weight_id(covariate_id, node_id, split_id(x) ); }
 // ---------------------------------------------------------------------------
 // BEGIN_N_WEIGHT
 size_t dismod_at::cov2weight_map::n_weight(void) const
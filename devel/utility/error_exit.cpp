@@ -81,6 +81,7 @@ An assertion is generated before exiting, incase we are running in debug mode.
 # include <iostream>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/log_message.hpp>
+# include <dismod_at/memory_connection.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
 # include <dismod_at/get_column_max.hpp>
 # include <cppad/utility/to_string.hpp>
@@ -112,8 +113,8 @@ void error_exit(
    std::string message_type = "error";
    log_message(db, &std::cerr, message_type, message, table_name, row_id);
    //
-   // close the database
-   sqlite3_close(db);
+   // close the database (writes back an in memory copy)
+   close_connection(db);
    //
    // if running in debugger, stop here
    assert(false);
@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# include <cmath>
+# include <cassert>
+# include <limits>
+# include <algorithm>
+# include <cppad/utility/to_string.hpp>
+# include <dismod_at/lanczos_sample.hpp>
+
+/*
+{xrst_begin lanczos_sample dev}
+{xrst_spell
+  lanczos
+  krylov
+  ritz
+  tridiagonal
+  orthogonalization
+}
+
+Matrix Free Sample From a Normal Using the Lanczos Method
+#########################################################
+
+Syntax
+******
+| *msg* = ``lanczos_sample`` ( *n_step* , *hes_vec* , *z* , *sample* , *ritz* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_PROTOTYPE
+   // END_PROTOTYPE
+}
+
+Purpose
+*******
+Given a positive definite matrix :math:`H` ,
+and a vector :math:`z` ,
+this routine approximates :math:`H^{-1/2} z` using
+only matrix vector products :math:`H x` .
+If :math:`z` is a sample from a standard normal,
+:math:`H^{-1/2} z` is a sample from a normal with mean zero
+and covariance :math:`H^{-1}` .
+The matrix :math:`H` is never formed or factored.
+
+Method
+******
+The Krylov space spanned by
+:math:`z, H z, \ldots , H^{m-1} z` , where :math:`m` is *n_step* ,
+is computed using the Lanczos method with full re-orthogonalization.
+This yields an orthonormal basis :math:`V_m` and a symmetric tridiagonal
+matrix :math:`T_m = V_m^\R{T} H V_m` .
+The approximation is
+
+.. math::
+
+   H^{-1/2} z \approx \| z \| V_m T_m^{-1/2} e_1
+
+where :math:`e_1` is the first column of the identity matrix.
+The iteration stops early if the Krylov space becomes invariant under
+:math:`H` , in which case the result is exact (up to roundoff).
+
+n_step
+******
+is the maximum dimension of the Krylov space :math:`m` .
+
+hes_vec
+*******
+Calling *hes_vec* ( *x* , *y* ) sets *y* to the product :math:`H x` .
+The vector *y* has the same size as *x* when it is called.
+
+z
+*
+is the vector :math:`z` . It must have a non-zero element.
+
+sample
+******
+The input size of this vector does not matter.
+Upon return it has the same size as *z* and contains the approximation
+for :math:`H^{-1/2} z` .
+
+ritz
+****
+The input size of this vector does not matter.
+Upon return it contains the eigenvalues of :math:`T_m`
+(the Ritz values) in increasing order.
+These approximate the spectrum of :math:`H` that is retained by the
+approximation. The extreme values converge first to the extreme
+eigenvalues of :math:`H` .
+
+msg
+***
+If *msg* is empty, no error was detected.
+Otherwise, it is an error message; e.g.,
+:math:`T_m` is not positive definite.
+
+{xrst_toc_hidden
+   example/devel/utility/lanczos_sample_xam.cpp
+}
+Example
+*******
+The file :ref:`lanczos_sample_xam.cpp-name`
+contains an example and test that uses this routine.
+
+{xrst_end lanczos_sample}
+*/
+namespace { // BEGIN_EMPTY_NAMESPACE
+   // eigen decomposition of symmetric m by m matrix a (row major) using
+   // the cyclic Jacobi method; a = q * diag(eval) * q^T
+   void symmetric_eigen(
+      size_t                   m    ,
+      CppAD::vector<double>&   a    ,
+      CppAD::vector<double>&   eval ,
+      CppAD::vector<double>&   q    )
+   {  double eps = std::numeric_limits<double>::epsilon();
+      q.resize(m * m);
+      for(size_t i = 0; i < m; ++i)
+         for(size_t j = 0; j < m; ++j)
+            q[i * m + j] = (i == j) ? 1.0 : 0.0;
+      for(size_t sweep = 0; sweep < 100; ++sweep)
+      {  double off = 0.0, total = 0.0;
+         for(size_t i = 0; i < m; ++i)
+         {  for(size_t j = 0; j < m; ++j)
+            {  total += a[i * m + j] * a[i * m + j];
+               if( i != j )
+                  off += a[i * m + j] * a[i * m + j];
+            }
+         }
+         if( off <= eps * eps * total )
+            break;
+         for(size_t p = 0; p < m; ++p)
+         {  for(size_t r = p + 1; r < m; ++r)
+            {  double apr = a[p * m + r];
+               if( apr == 0.0 )
+                  continue;
+               double theta = (a[r * m + r] - a[p * m + p]) / (2.0 * apr);
+               double t     = 1.0 / (
+                  std::fabs(theta) + std::sqrt(theta * theta + 1.0)
+               );
+               if( theta < 0.0 )
+                  t = - t;
+               double c = 1.0 / std::sqrt(t * t + 1.0);
+               double s = t * c;
+               for(size_t k = 0; k < m; ++k)
+               {  double akp = a[k * m + p];
+                  double akr = a[k * m + r];
+                  a[k * m + p] = c * akp - s * akr;
+                  a[k * m + r] = s * akp + c * akr;
+               }
+               for(size_t k = 0; k < m; ++k)
+               {  double apk = a[p * m + k];
+                  double ark = a[r * m + k];
+                  a[p * m + k] = c * apk - s * ark;
+                  a[r * m + k] = s * apk + c * ark;
+               }
+               for(size_t k = 0; k < m; ++k)
+               {  double qkp = q[k * m + p];
+                  double qkr = q[k * m + r];
+                  q[k * m + p] = c * qkp - s * qkr;
+                  q[k * m + r] = s * qkp + c * qkr;
+               }
+            }
+         }
+      }
+      eval.resize(m);
+      for(size_t i = 0; i < m; ++i)
+         eval[i] = a[i * m + i];
+   }
+} // END_EMPTY_NAMESPACE
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// BEGIN_PROTOTYPE
+std::string lanczos_sample(
+   size_t                                            n_step  ,
+   const std::function<void(
+      const CppAD::vector<double>& x, CppAD::vector<double>& y
+   )>&                                               hes_vec ,
+   const CppAD::vector<double>&                      z       ,
+   CppAD::vector<double>&                            sample  ,
+   CppAD::vector<double>&                            ritz    )
+// END_PROTOTYPE
+{  using CppAD::vector;
+   double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
+   size_t n     = z.size();
+   assert( n_step > 0 );
+   //
+   // norm_z
+   double norm_z = 0.0;
+   for(size_t i = 0; i < n; ++i)
+      norm_z += z[i] * z[i];
+   norm_z = std::sqrt(norm_z);
+   assert( norm_z > 0.0 );
+   //
+   // basis, alpha, beta
+   size_t m_max = std::min(n_step, n);
+   vector<double> basis(m_max * n), alpha(m_max), beta(m_max);
+   vector<double> v(n), w(n);
+   for(size_t i = 0; i < n; ++i)
+      basis[i] = z[i] / norm_z;
+   size_t m = 0;
+   while( m < m_max )
+   {  // w = H v_m
+      for(size_t i = 0; i < n; ++i)
+         v[i] = basis[m * n + i];
+      hes_vec(v, w);
+      //
+      // alpha_m
+      double a = 0.0;
+      for(size_t i = 0; i < n; ++i)
+         a += v[i] * w[i];
+      alpha[m] = a;
+      //
+      // w = w - sum_k (v_k^T w) v_k  (full re-orthogonalization, twice)
+      for(size_t pass = 0; pass < 2; ++pass)
+      {  for(size_t k = 0; k <= m; ++k)
+         {  double dot = 0.0;
+            for(size_t i = 0; i < n; ++i)
+               dot += basis[k * n + i] * w[i];
+            for(size_t i = 0; i < n; ++i)
+               w[i] -= dot * basis[k * n + i];
+         }
+      }
+      //
+      // beta_m
+      double b = 0.0;
+      for(size_t i = 0; i < n; ++i)
+         b += w[i] * w[i];
+      b       = std::sqrt(b);
+      beta[m] = b;
+      ++m;
+      //
+      // check for invariant Krylov space
+      if( b <= eps99 * std::fabs(a) || b == 0.0 )
+         break;
+      if( m < m_max )
+      {  for(size_t i = 0; i < n; ++i)
+            basis[m * n + i] = w[i] / b;
+      }
+   }
+   //
+   // t = T_m
+   vector<double> t(m * m);
+   for(size_t i = 0; i < m * m; ++i)
+      t[i] = 0.0;
+   for(size_t i = 0; i < m; ++i)
+   {  t[i * m + i] = alpha[i];
+      if( i + 1 < m )
+      {  t[i * m + i + 1] = beta[i];
+         t[(i + 1) * m + i] = beta[i];
+      }
+   }
+   //
+   // eval, q: T_m = q * diag(eval) * q^T
+   vector<double> eval, q;
+   symmetric_eigen(m, t, eval, q);
+   //
+   // ritz
+   ritz = eval;
+   std::sort( ritz.data(), ritz.data() + m );
+   if( ritz[0] <= 0.0 )
+   {  std::string msg = "lanczos_sample: Hessian is not positive definite: ";
+      msg += "smallest Ritz value = " + CppAD::to_string( ritz[0] );
+      sample.resize(0);
+      return msg;
+   }
+   //
+   // c = || z || * T_m^{-1/2} e_1
+   vector<double> c(m);
+   for(size_t i = 0; i < m; ++i)
+   {  double sum = 0.0;
+      for(size_t k = 0; k < m; ++k)
+         sum += q[i * m + k] * q[0 * m + k] / std::sqrt( eval[k] );
+      c[i] = norm_z * sum;
+   }
+   //
+   // sample = V_m * c
+   sample.resize(n);
+   for(size_t i = 0; i < n; ++i)
+   {  double sum = 0.0;
+      for(size_t k = 0; k < m; ++k)
+         sum += basis[k * n + i] * c[k];
+      sample[i] = sum;
+   }
+   return "";
+}
+
+} // END_DISMOD_AT_NAMESPACE
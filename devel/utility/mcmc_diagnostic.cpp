@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# include <cmath>
+# include <cassert>
+# include <limits>
+# include <algorithm>
+# include <dismod_at/mcmc_diagnostic.hpp>
+
+/*
+{xrst_begin mcmc_diagnostic dev}
+{xrst_spell
+  geyer
+  autocorrelations
+}
+
+Convergence Diagnostics for Markov Chain Monte Carlo
+####################################################
+
+Syntax
+******
+``mcmc_diagnostic`` ( *n_chain* , *draw* , *r_hat* , *ess* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_PROTOTYPE
+   // END_PROTOTYPE
+}
+
+n_chain
+*******
+is the number of chains (must be greater than zero).
+
+draw
+****
+This vector has size *n_chain* times *n_draw* where
+*n_draw* is the number of draws in each chain.
+For *c* = 0 , ... , *n_chain* ``-1`` and *i* = 0 , ... , *n_draw* ``-1`` ,
+*draw* [ *c* * *n_draw* + *i* ] is the *i*-th draw of one scalar
+quantity in the *c*-th chain.
+
+Split Chains
+************
+Each chain is split into its first and second half
+(the middle draw is dropped when *n_draw* is odd).
+This results in :math:`m = 2 \times` *n_chain* chains each with
+:math:`n =` *n_draw* / 2 draws.
+Using the split chains also detects a chain that has not
+reached its stationary distribution.
+
+r_hat
+*****
+The input value of this argument does not matter.
+Upon return it is the potential scale reduction factor
+
+.. math::
+
+   \hat{R} = \sqrt{ \frac{ \hat{V} }{ W } }
+   \W{,}
+   \hat{V} = \frac{n-1}{n} W + \frac{B}{n}
+
+where :math:`W` is the average of the within chain variances and
+:math:`B / n` is the variance of the chain means.
+Values close to one indicate that the chains have mixed.
+
+ess
+***
+The input value of this argument does not matter.
+Upon return it is the effective sample size
+:math:`m n / \hat{\tau}` where the integrated autocorrelation time
+
+.. math::
+
+   \hat{\tau} = - 1 + 2 \sum_{k=0}^{K} ( \hat{\rho}_{2k} + \hat{\rho}_{2k+1} )
+
+uses the autocorrelations :math:`\hat{\rho}_t`
+computed with the variogram of all the split chains and :math:`\hat{V}` .
+The sum is truncated using Geyer's initial positive sequence
+and the pair sums are made monotone non-increasing.
+
+Degenerate Case
+***************
+If *n_draw* is less than four, or :math:`W` is zero,
+*r_hat* and *ess* are ``nan`` upon return.
+
+{xrst_toc_hidden
+   example/devel/utility/mcmc_diagnostic_xam.cpp
+}
+Example
+*******
+The file :ref:`mcmc_diagnostic_xam.cpp-name`
+contains an example and test that uses this routine.
+
+{xrst_end mcmc_diagnostic}
+*/
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// BEGIN_PROTOTYPE
+void mcmc_diagnostic(
+   size_t                         n_chain ,
+   const CppAD::vector<double>&   draw    ,
+   double&                        r_hat   ,
+   double&                        ess     )
+// END_PROTOTYPE
+{  assert( n_chain > 0 );
+   assert( draw.size() % n_chain == 0 );
+   double nan = std::numeric_limits<double>::quiet_NaN();
+   r_hat      = nan;
+   ess        = nan;
+   //
+   // n_draw
+   size_t n_draw = draw.size() / n_chain;
+   if( n_draw < 4 )
+      return;
+   //
+   // m, n, start
+   // split chain k starts at index start[k] in draw and has n elements
+   size_t m = 2 * n_chain;
+   size_t n = n_draw / 2;
+   CppAD::vector<size_t> start(m);
+   for(size_t c = 0; c < n_chain; ++c)
+   {  start[2 * c]     = c * n_draw;
+      start[2 * c + 1] = c * n_draw + n_draw - n;
+   }
+   //
+   // mean, W
+   CppAD::vector<double> mean(m);
+   double mean_all = 0.0;
+   double W        = 0.0;
+   for(size_t k = 0; k < m; ++k)
+   {  double sum = 0.0;
+      for(size_t i = 0; i < n; ++i)
+         sum += draw[ start[k] + i ];
+      mean[k]   = sum / double(n);
+      mean_all += mean[k] / double(m);
+      double sumsq = 0.0;
+      for(size_t i = 0; i < n; ++i)
+      {  double diff = draw[ start[k] + i ] - mean[k];
+         sumsq += diff * diff;
+      }
+      W += sumsq / ( double(n - 1) * double(m) );
+   }
+   if( W <= 0.0 )
+      return;
+   //
+   // B_over_n: variance of the split chain means
+   double B_over_n = 0.0;
+   for(size_t k = 0; k < m; ++k)
+   {  double diff = mean[k] - mean_all;
+      B_over_n   += diff * diff / double(m - 1);
+   }
+   //
+   // var_plus, r_hat
+   double var_plus = double(n - 1) / double(n) * W + B_over_n;
+   r_hat           = std::sqrt( var_plus / W );
+   //
+   // rho(t): autocorrelation at lag t using the variogram
+   auto rho = [&](size_t t)
+   {  double variogram = 0.0;
+      for(size_t k = 0; k < m; ++k)
+      {  for(size_t i = t; i < n; ++i)
+         {  double diff = draw[ start[k] + i ] - draw[ start[k] + i - t ];
+            variogram  += diff * diff;
+         }
+      }
+      variogram /= double(m) * double(n - t);
+      return 1.0 - variogram / (2.0 * var_plus);
+   };
+   //
+   // tau: Geyer's initial positive and monotone sequence estimator
+   double tau      = -1.0;
+   double pair_max = std::numeric_limits<double>::infinity();
+   for(size_t t = 0; t + 1 < n; t += 2)
+   {  double pair = (t == 0 ? 1.0 : rho(t)) + rho(t + 1);
+      if( pair <= 0.0 )
+         break;
+      pair      = std::min(pair, pair_max);
+      pair_max  = pair;
+      tau      += 2.0 * pair;
+   }
+   // an estimate of tau less than 1/log10(m n) is not reliable
+   double tau_min = 1.0 / std::log10( double(m * n) );
+   tau            = std::max(tau, tau_min);
+   ess            = double(m * n) / tau;
+   return;
+}
+
+} // END_DISMOD_AT_NAMESPACE
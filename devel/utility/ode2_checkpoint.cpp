@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin ode2_checkpoint dev}
+
+Checkpoint Function for One Step of the ODE
+###########################################
+
+Syntax
+******
+| ``ode2_checkpoint_setup`` ()
+| *yf* = ``ode2_checkpoint`` ( *case_number* , *b* , *yi* , *tf* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_PROTOTYPE
+   // END_PROTOTYPE
+}
+
+Purpose
+*******
+When :ref:`cohort_ode-name` is used with :ref:`a1_double-name` values,
+it is usually being recorded in a CppAD tape; e.g.,
+during the :ref:`fit_model constructor<fit_model_ctor-name>` .
+Each step of the ODE is the same function of *b* , *yi* and *tf* .
+This routine records that function once, as a CppAD ``chkpoint_two``
+function, so that each step in a tape is one atomic operation
+instead of all the elementary operations in
+:ref:`eigen_ode2-name` or :ref:`trap_ode2-name` .
+This greatly reduces the size of the tapes, and the time for
+forward and reverse mode sweeps, when there are many data points.
+
+ode2_checkpoint_setup
+*********************
+This records a checkpoint function for each value of *case_number* .
+It must be called before any CppAD tape that uses ``ode2_checkpoint``
+is started because a new recording cannot be done while another tape
+is being recorded.
+It is called by the :ref:`adj_integrand-name` constructor
+and only does any work the first time it is called.
+The checkpoint functions are freed when the program exits.
+
+case_number
+***********
+If *case_number* is zero,
+the function is the same as :ref:`trap_ode2-name` .
+Otherwise, it is between one and four and the function is
+the same as :ref:`eigen_ode2-name` for this *case_number* .
+
+b
+*
+This vector has size four and is the ODE coefficient matrix
+in row major order.
+
+yi
+**
+This vector has size two and is the initial value of the ODE.
+
+tf
+**
+This is the final time (the initial time is zero).
+
+yf
+**
+This vector has size two and is the solution of the ODE at *tf* .
+
+{xrst_toc_hidden
+   example/devel/utility/ode2_checkpoint_xam.cpp
+}
+Example
+*******
+The file :ref:`ode2_checkpoint_xam.cpp-name` contains an example and test
+of this routine.
+
+{xrst_end ode2_checkpoint}
+*/
+# include <memory>
+# include <cstdlib>
+# include <cppad/cppad.hpp>
+# include <dismod_at/ode2_checkpoint.hpp>
+# include <dismod_at/eigen_ode2.hpp>
+# include <dismod_at/trap_ode2.hpp>
+
+namespace { // BEGIN_EMPTY_NAMESPACE
+   // number of case_number values
+   const size_t n_case_number_ = 5;
+   //
+   // one checkpoint function for each case_number
+   std::unique_ptr< CppAD::chkpoint_two<double> > checkpoint_[n_case_number_];
+   //
+   // free_checkpoint
+   // The CppAD list of atomic functions is a static object that is created
+   // when the first checkpoint function is constructed. Freeing the
+   // checkpoint functions using atexit, after they are constructed,
+   // ensures that this is done before that list is destroyed.
+   void free_checkpoint(void)
+   {  for(size_t case_number = 0; case_number < n_case_number_; ++case_number)
+         checkpoint_[case_number].reset();
+   }
+} // END_EMPTY_NAMESPACE
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+void ode2_checkpoint_setup(void)
+{  typedef CppAD::vector<a1_double> a1_vector;
+   //
+   // first_call
+   bool first_call = checkpoint_[0] == nullptr;
+   //
+   for(size_t case_number = 0; case_number < n_case_number_; ++case_number)
+   if( checkpoint_[case_number] == nullptr )
+   {  // ax = (b, yi, tf)
+      // The values used during the recording do not matter because
+      // eigen_ode2 and trap_ode2 use conditional expressions.
+      a1_vector ax(7);
+      ax[0] = -0.2;
+      ax[1] = +0.1;
+      ax[2] = +0.1;
+      ax[3] = -0.3;
+      ax[4] = 0.9;
+      ax[5] = 0.1;
+      ax[6] = 1.0;
+      CppAD::Independent(ax);
+      //
+      a1_vector b(4), yi(2), yf(2);
+      for(size_t i = 0; i < 4; ++i)
+         b[i] = ax[i];
+      yi[0] = ax[4];
+      yi[1] = ax[5];
+      a1_double tf = ax[6];
+      if( case_number == 0 )
+         yf = trap_ode2(b, yi, tf);
+      else
+         yf = eigen_ode2(case_number, b, yi, tf);
+      //
+      CppAD::ADFun<double> fun(ax, yf);
+      fun.optimize();
+      //
+      std::string name = "ode2_checkpoint_" + CppAD::to_string(case_number);
+      bool internal_bool    = false;
+      bool use_hes_sparsity = true;
+      bool use_base2ad      = true;
+      bool use_in_parallel  = false;
+      checkpoint_[case_number].reset( new CppAD::chkpoint_two<double>(
+         fun,
+         name,
+         internal_bool,
+         use_hes_sparsity,
+         use_base2ad,
+         use_in_parallel
+      ) );
+   }
+   if( first_call )
+      std::atexit(free_checkpoint);
+   return;
+}
+
+// BEGIN_PROTOTYPE
+CppAD::vector<a1_double> ode2_checkpoint(
+   size_t                           case_number ,
+   const CppAD::vector<a1_double>&  b           ,
+   const CppAD::vector<a1_double>&  yi          ,
+   const a1_double&                 tf          )
+// END_PROTOTYPE
+{  assert( case_number < n_case_number_ );
+   assert( b.size() == 4 );
+   assert( yi.size() == 2 );
+   //
+   if( checkpoint_[case_number] == nullptr )
+      ode2_checkpoint_setup();
+   //
+   CppAD::vector<a1_double> ax(7), ay(2);
+   for(size_t i = 0; i < 4; ++i)
+      ax[i] = b[i];
+   ax[4] = yi[0];
+   ax[5] = yi[1];
+   ax[6] = tf;
+   (*checkpoint_[case_number])(ax, ay);
+   return ay;
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-22 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 /*
 {xrst_begin pack_warm_start dev}
@@ -10,8 +10,8 @@ Packing and Unpacking Warm Start Information in a Vector
 Syntax
 ******
 
-| *vec* = ``pack_warm_start`` ( *warm_start* )
-| *warm_start* = ``unpack_warm_start`` ( *vec* )
+| *vec* = ``pack_warm_start`` ( *warm_start* , *random_opt* )
+| *warm_start* = ``unpack_warm_start`` ( *vec* , *random_opt* )
 
 Prototype
 *********
@@ -34,6 +34,29 @@ warm_start
 This is a structure, holding the warm start information
 in the form expected by ``cppad_mixed`` .
 
+random_opt
+**********
+This is the optimal value for the random effects
+(in the order used by :ref:`unpack_random<random_effect-name>` )
+corresponding to *warm_start* .
+It is an input to ``pack_warm_start`` and an output of
+``unpack_warm_start`` .
+If *vec* was created before the random effects were included,
+*random_opt* is set to the empty vector by ``unpack_warm_start`` .
+
+Limited Memory Quasi-Newton
+***************************
+The limited memory quasi-Newton approximation for the fixed effects
+objective is internal to Ipopt and is not included in *vec* .
+
+{xrst_toc_hidden
+   example/devel/utility/pack_warm_start_xam.cpp
+}
+Example
+*******
+The file :ref:`pack_warm_start_xam.cpp-name` contains an example and test
+of this routine.
+
 {xrst_end pack_warm_start}
 */
 # include <dismod_at/pack_warm_start.hpp>
@@ -62,11 +85,13 @@ namespace dismod_at {
 
 // BEGIN_PACK
 CppAD::vector<double> pack_warm_start(
-   const CppAD::mixed::warm_start_struct& warm_start )
+   const CppAD::mixed::warm_start_struct& warm_start ,
+   const CppAD::vector<double>&           random_opt )
 // END_PACK
 {  size_t n    = warm_start.x_info.size();
    size_t m    = warm_start.g_info.size();
-   size_t size = 4 + 4 * n + 2 * m;
+   size_t r    = random_opt.size();
+   size_t size = 4 + 4 * n + 2 * m + 1 + r;
    CppAD::vector<double> vec(size);
    size_t index = 0;
    vec[index++]   = double(n);
@@ -83,16 +108,21 @@ CppAD::vector<double> pack_warm_start(
    {  vec[index++] = warm_start.g_info[i].lambda;
       vec[index++] = warm_start.g_info[i].scale_g;
    }
+   vec[index++] = double(r);
+   for(size_t k = 0; k < r; ++k)
+      vec[index++] = random_opt[k];
    assert( index == vec.size() );
    //
    // check conversion from size_t to double
    assert( size_t(vec[0]) == n );
    assert( size_t(vec[1]) == m );
+   assert( size_t(vec[4 + 4 * n + 2 * m]) == r );
    return vec;
 }
 // BEGIN_UNPACK
 CppAD::mixed::warm_start_struct unpack_warm_start(
-   const CppAD::vector<double>& vec )
+   const CppAD::vector<double>& vec        ,
+   CppAD::vector<double>&       random_opt )
 // END_UNPACK
 {  CppAD::mixed::warm_start_struct warm_start;
    size_t index = 0;
@@ -117,6 +147,15 @@ CppAD::mixed::warm_start_struct unpack_warm_start(
    {  warm_start.g_info[i].lambda  = vec[index++];
       warm_start.g_info[i].scale_g = vec[index++];
    }
+   //
+   // random_opt: empty if vec was packed without the random effects
+   random_opt.resize(0);
+   if( index < vec.size() )
+   {  size_t r = size_t( vec[index++] );
+      random_opt.resize(r);
+      for(size_t k = 0; k < r; ++k)
+         random_opt[k] = vec[index++];
+   }
    assert( index == vec.size() );
    return warm_start;
 }
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin parallel_loop dev}
+
+Run a Loop Using Multiple Threads
+#################################
+
+Syntax
+******
+``parallel_loop`` ( *n_thread* , *work* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_PROTOTYPE
+   // END_PROTOTYPE
+}
+
+n_thread
+********
+is the number of threads to use (must be greater than zero).
+If *n_thread* is one, *work* is called once by the current thread
+and no other threads are created.
+
+work
+****
+This function is called once for each *thread* = 0 , ... , *n_thread* ``-1``
+and these calls run at the same time.
+The call with *thread* equal to zero is done by the current thread.
+The argument *thread* is usually used to determine which part of a
+loop the call will compute; e.g., the indices *i* with
+*i* % *n_thread* == *thread* .
+
+Memory
+======
+Each call to *work* must free all the ``CppAD::vector`` and
+``CppAD::thread_alloc`` memory that it allocates before it returns;
+i.e., objects that allocate memory should be local to *work*.
+The calls to *work* must not change the size of any ``CppAD::vector``
+that was created before ``parallel_loop`` was called,
+but they can set the elements of such a vector.
+For this reason, each call to *work* should have its own copy of
+objects that use temporary vectors; e.g., :ref:`avg_integrand-name` .
+
+CppAD
+=====
+The CppAD ``thread_alloc`` memory allocator is set up for
+*n_thread* threads during this call and set back to one thread
+before it returns.
+If *n_thread* is greater than one,
+``CppAD::parallel_ad<double>`` is called before the other threads start.
+Hence the calls to *work* can create, copy, and destroy
+``AD<double>`` objects; e.g., a copy of an :ref:`avg_integrand-name` object.
+They must not record ``AD`` operations or evaluate a ``CppAD::ADFun`` object
+that is shared with another thread.
+They can assign a shared ``ADFun`` object to a local ``ADFun`` object
+and evaluate the local copy (which is destroyed before *work* returns).
+
+Thread Safety
+*************
+This routine is not thread safe; i.e., *work* must not
+call ``parallel_loop`` .
+In addition, *work* must not use the database or call
+:ref:`log_message-name` or :ref:`error_exit-name` .
+Errors should be detected, and reported, by the current thread
+before or after the call to ``parallel_loop`` .
+
+{xrst_toc_hidden
+   example/devel/utility/parallel_loop_xam.cpp
+}
+Example
+*******
+The file :ref:`parallel_loop_xam.cpp-name`
+contains an example and test that uses this routine.
+
+{xrst_end parallel_loop}
+*/
+# include <thread>
+# include <vector>
+# include <cassert>
+# include <cppad/cppad.hpp>
+# include <dismod_at/parallel_loop.hpp>
+
+namespace { // BEGIN_EMPTY_NAMESPACE
+   // is there more than one thread currently running
+   bool in_parallel_ = false;
+   //
+   // thread number for the current thread
+   thread_local size_t thread_num_ = 0;
+   //
+   bool in_parallel(void)
+   {  return in_parallel_; }
+   size_t thread_num(void)
+   {  return thread_num_; }
+} // END_EMPTY_NAMESPACE
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// BEGIN_PROTOTYPE
+void parallel_loop(
+   size_t                                 n_thread ,
+   const std::function<void(size_t)>&     work     )
+// END_PROTOTYPE
+{  assert( n_thread > 0 );
+   assert( ! in_parallel_ );
+   using CppAD::thread_alloc;
+   //
+   if( n_thread == 1 )
+   {  work(0);
+      return;
+   }
+   //
+   // set up thread_alloc for n_thread threads
+   thread_alloc::parallel_setup(n_thread, in_parallel, thread_num);
+   thread_alloc::hold_memory(true);
+   //
+   // set up static AD<double> information for use by multiple threads
+   CppAD::parallel_ad<double>();
+   //
+   // run work(thread) for thread = 1, ..., n_thread-1 in other threads
+   in_parallel_ = true;
+   std::vector<std::thread> other(n_thread - 1);
+   for(size_t thread = 1; thread < n_thread; ++thread)
+   {  other[thread - 1] = std::thread( [thread, &work](void)
+      {  thread_num_ = thread;
+         work(thread);
+      } );
+   }
+   //
+   // run work(0) in this thread
+   work(0);
+   //
+   // wait for the other threads to finish
+   for(size_t thread = 1; thread < n_thread; ++thread)
+      other[thread - 1].join();
+   in_parallel_ = false;
+   //
+   // free memory held for the other threads
+   for(size_t thread = 1; thread < n_thread; ++thread)
+   {  assert( thread_alloc::inuse(thread) == 0 );
+      thread_alloc::free_available(thread);
+   }
+   //
+   // set thread_alloc back to one thread
+   thread_alloc::hold_memory(false);
+   thread_alloc::parallel_setup(1, nullptr, nullptr);
+   return;
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin process_loop dev}
+
+Run a Loop Using Multiple Processes
+###################################
+
+Syntax
+******
+*msg* = ``process_loop`` ( *n_process* , *n_task* , *work* , *result* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_PROTOTYPE
+   // END_PROTOTYPE
+}
+
+n_process
+*********
+is the maximum number of child processes that run at the same time
+(must be greater than zero).
+If *n_process* is one, or the system does not have ``fork`` ,
+no child processes are created and each call to *work*
+is done by the current process.
+
+n_task
+******
+is the number of tasks; i.e., the number of times *work* is called.
+
+work
+****
+The call *work* ( *task* , *child* ) is made once for each
+*task* = 0 , ... , *n_task* ``-1`` .
+If *child* is true, the call is done in a separate child process,
+created using ``fork`` ,
+and the return value is sent back to this process using a pipe.
+Otherwise, the call is done by this process
+(this happens if ``fork`` is not available or fails).
+The return value is a sequence of bytes; i.e., it is not necessarily text.
+Changes that *work* makes to the memory of its process
+are not seen by this process or by the other calls to *work* .
+
+Database
+========
+If *child* is true, *work* must not use a database connection that was opened
+by this process (sqlite connections must not be carried across a ``fork``).
+This includes calling :ref:`log_message-name` or :ref:`error_exit-name`
+with such a connection.
+If *work* calls ``error_exit`` , it should first call
+``error_exit`` ( *db* ) with a connection that it opened;
+the child process then exits with a non-zero status.
+
+Output
+======
+Standard output and standard error are flushed before each ``fork`` ,
+so output that was buffered by this process is not repeated by a child.
+The output of the different child processes may be interleaved.
+
+result
+******
+The call *result* ( *task* , *bytes* ) is made by this process
+for each *task* that completes,
+where *bytes* is the return value for *work* ( *task* , *child* ) .
+These calls are made in order of increasing *task*
+(a task that finishes early is held until the previous tasks are done).
+
+msg
+***
+If all the tasks complete, the return value *msg* is empty.
+Otherwise it is an error message identifying the first task that
+did not complete; e.g., its child process exited with a non-zero status.
+In this case *result* is not called for that task, or the tasks after it,
+and the child processes that are still running are terminated.
+
+{xrst_toc_hidden
+   example/devel/utility/process_loop_xam.cpp
+}
+Example
+*******
+The file :ref:`process_loop_xam.cpp-name`
+contains an example and test that uses this routine.
+
+{xrst_end process_loop}
+*/
+# include <cstdio>
+# include <cassert>
+# include <iostream>
+# include <vector>
+# include <dismod_at/process_loop.hpp>
+# include <cppad/utility/to_string.hpp>
+
+# ifndef _WIN32
+# include <unistd.h>
+# include <poll.h>
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <signal.h>
+# endif
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// BEGIN_PROTOTYPE
+std::string process_loop(
+   size_t                                                 n_process ,
+   size_t                                                 n_task    ,
+   const std::function<std::string(size_t, bool)>&        work      ,
+   const std::function<void(size_t, const std::string&)>& result    )
+// END_PROTOTYPE
+{  assert( n_process > 0 );
+   using CppAD::to_string;
+   //
+# ifndef _WIN32
+   if( n_process > 1 && n_task > 1 )
+   {  //
+      // pid, fd, output, done
+      // for each task: its process id, the read end of its pipe,
+      // the bytes read so far, and whether it is done
+      std::vector<pid_t>       pid(n_task);
+      std::vector<int>         fd(n_task);
+      std::vector<std::string> output(n_task);
+      std::vector<bool>        done(n_task);
+      std::vector<bool>        failed(n_task);
+      //
+      // n_start, n_running, n_result
+      size_t n_start   = 0;
+      size_t n_running = 0;
+      size_t n_result  = 0;
+      //
+      // buffer
+      std::vector<char> buffer(65536);
+      //
+      while( n_result < n_task )
+      {  //
+         // start tasks until n_process are running
+         while( n_start < n_task && n_running < n_process )
+         {  size_t task = n_start++;
+            done[task]   = false;
+            failed[task] = false;
+            int pipe_fd[2];
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(stdout);
+            std::fflush(stderr);
+            bool ok = ::pipe(pipe_fd) == 0;
+            if( ok )
+            {  pid[task] = ::fork();
+               ok        = pid[task] >= 0;
+               if( ! ok )
+               {  ::close( pipe_fd[0] );
+                  ::close( pipe_fd[1] );
+               }
+            }
+            if( ! ok )
+            {  // run this task in this process
+               pid[task]    = 0;
+               fd[task]     = -1;
+               output[task] = work(task, false);
+               done[task]   = true;
+               continue;
+            }
+            if( pid[task] == 0 )
+            {  // child process: close the pipes for the other tasks
+               ::close( pipe_fd[0] );
+               for(size_t other = n_result; other < task; ++other)
+               {  if( ! done[other] )
+                     ::close( fd[other] );
+               }
+               std::string bytes = work(task, true);
+               size_t n_write    = 0;
+               while( n_write < bytes.size() )
+               {  ssize_t n = ::write(
+                     pipe_fd[1], bytes.data() + n_write, bytes.size() - n_write
+                  );
+                  if( n <= 0 )
+                     ::_exit(1);
+                  n_write += size_t(n);
+               }
+               ::close( pipe_fd[1] );
+               std::cout.flush();
+               std::cerr.flush();
+               std::fflush(stdout);
+               std::fflush(stderr);
+               ::_exit(0);
+            }
+            // parent process
+            ::close( pipe_fd[1] );
+            fd[task] = pipe_fd[0];
+            ++n_running;
+         }
+         //
+         // poll_fd, poll_task: running tasks
+         std::vector<struct pollfd> poll_fd;
+         std::vector<size_t>        poll_task;
+         for(size_t task = n_result; task < n_start; ++task)
+         {  if( ! done[task] )
+            {  struct pollfd entry;
+               entry.fd      = fd[task];
+               entry.events  = POLLIN;
+               entry.revents = 0;
+               poll_fd.push_back(entry);
+               poll_task.push_back(task);
+            }
+         }
+         //
+         // read from the pipes that have data or are closed
+         if( poll_fd.size() > 0 )
+         {  int n_ready = ::poll( poll_fd.data(), poll_fd.size(), -1 );
+            if( n_ready < 0 )
+               continue;
+            for(size_t i = 0; i < poll_fd.size(); ++i)
+            if( poll_fd[i].revents != 0 )
+            {  size_t  task = poll_task[i];
+               ssize_t n    = ::read( fd[task], buffer.data(), buffer.size() );
+               if( n > 0 )
+                  output[task].append( buffer.data(), size_t(n) );
+               else
+               {  // end of file or error: this task is done
+                  ::close( fd[task] );
+                  int status = 0;
+                  ::waitpid( pid[task], &status, 0 );
+                  failed[task] = n < 0 || ! WIFEXITED(status);
+                  if( ! failed[task] )
+                     failed[task] = WEXITSTATUS(status) != 0;
+                  done[task] = true;
+                  --n_running;
+               }
+            }
+         }
+         //
+         // report the tasks that are done, in order
+         while( n_result < n_start && done[n_result] )
+         {  size_t task = n_result;
+            if( failed[task] )
+            {  // stop the other running tasks
+               for(size_t other = task + 1; other < n_start; ++other)
+               {  if( ! done[other] )
+                  {  ::kill( pid[other], SIGTERM );
+                     ::close( fd[other] );
+                     int status = 0;
+                     ::waitpid( pid[other], &status, 0 );
+                  }
+               }
+               std::string msg = "process_loop: the process for task ";
+               msg += to_string(task) + " did not complete";
+               return msg;
+            }
+            result(task, output[task]);
+            output[task].clear();
+            ++n_result;
+         }
+      }
+      return "";
+   }
+# endif
+   // run all the tasks in this process
+   for(size_t task = 0; task < n_task; ++task)
+      result(task, work(task, false) );
+   return "";
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-24 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 /*
 {xrst_begin residual_density dev}
@@ -484,5 +484,284 @@ residual_struct<Float> residual_density(
 // instantiations
 DISMOD_AT_INSTANTIATE_RESIDUAL_DENSITY( double )
 DISMOD_AT_INSTANTIATE_RESIDUAL_DENSITY( a1_double )
+/*
+------------------------------------------------------------------------------
+{xrst_begin residual_density_batch dev}
+{xrst_spell
+  wres
+}
+
+Weighted Residuals and Log-Densities for a Batch of Data
+########################################################
+
+Syntax
+******
+| ``residual_batch_const`` ( *batch* )
+| ``residual_density_batch`` ( *batch* , *mu_vec* , *delta_vec* , *residual_vec* )
+
+Purpose
+*******
+This computes the same values as :ref:`residual_density-name` with
+*Float* equal to ``double`` for a batch of data residuals that have
+the same density.
+Terms that do not depend on the model variables are computed once by
+``residual_batch_const`` .
+The loops for each density do not contain any branches on the density,
+so the compiler can vectorize them.
+
+batch
+*****
+{xrst_literal
+   include/dismod_at/residual_density.hpp
+   // BEGIN_RESIDUAL_BATCH_STRUCT
+   // END_RESIDUAL_BATCH_STRUCT
+}
+The vectors *index* , *obs* , *eta* , *nu* , and *sample_size*
+have the same size and must be set before calling ``residual_batch_const``.
+For real data, *obs* is the *y* argument to ``residual_density``
+and for simulated data it is the *z* argument.
+
+residual_batch_const
+====================
+This sets the vectors *log_obs* and *log_n_choose_k* .
+If the density is a log density, *log_obs* [ *i* ] is
+log( *obs* [ *i* ] + *eta* [ *i* ] ) .
+If the density is binomial, *log_n_choose_k* [ *i* ] is the
+log of the binomial coefficient for the corresponding
+*sample_size* and observed count.
+
+mu_vec
+******
+For each *i* ,
+*mu_vec* [ *batch* . ``index`` [ *i* ] ] is the mean for the *i*-th
+element of the batch.
+
+delta_vec
+*********
+For each *i* ,
+*delta_vec* [ *batch* . ``index`` [ *i* ] ] is the standard deviation
+for the *i*-th element of the batch.
+
+residual_vec
+************
+For each *i* ,
+*residual_vec* [ *batch* . ``index`` [ *i* ] ] is set to the residual
+for the *i*-th element of the batch.
+Other elements of *residual_vec* are not changed.
+
+{xrst_end residual_density_batch}
+*/
+void residual_batch_const(residual_batch_struct& batch)
+{  size_t       n_batch = batch.index.size();
+   density_enum d_enum  = batch.density;
+   assert( batch.obs.size() == n_batch );
+   assert( batch.eta.size() == n_batch );
+   assert( batch.nu.size() == n_batch );
+   assert( batch.sample_size.size() == n_batch );
+   double nan = std::numeric_limits<double>::quiet_NaN();
+   //
+   // log_obs
+   batch.log_obs.resize(n_batch);
+   for(size_t i = 0; i < n_batch; ++i)
+      batch.log_obs[i] = nan;
+   if( log_density(d_enum) )
+   {  for(size_t i = 0; i < n_batch; ++i)
+         batch.log_obs[i] = log( batch.obs[i] + batch.eta[i] );
+   }
+   //
+   // log_n_choose_k
+   batch.log_n_choose_k.resize(n_batch);
+   for(size_t i = 0; i < n_batch; ++i)
+      batch.log_n_choose_k[i] = nan;
+   if( d_enum == binomial_enum )
+   {  for(size_t i = 0; i < n_batch; ++i)
+      {  // residual_density uses y (nan for simulated data) for the count
+         double y = nan;
+         if( batch.residual_type == real_data_enum )
+            y = batch.obs[i];
+         double n = batch.sample_size[i];
+         double k = n * y;
+         batch.log_n_choose_k[i] = apx_log_factorial(n)
+            - apx_log_factorial(k) - apx_log_factorial(n - k);
+      }
+   }
+}
+void residual_density_batch(
+   const residual_batch_struct&               batch        ,
+   const CppAD::vector<double>&               mu_vec       ,
+   const CppAD::vector<double>&               delta_vec    ,
+   CppAD::vector< residual_struct<double> >&  residual_vec )
+{  size_t        n_batch       = batch.index.size();
+   density_enum  d_enum        = batch.density;
+   residual_enum residual_type = batch.residual_type;
+   assert(
+      residual_type == real_data_enum || residual_type == simulated_data_enum
+   );
+   assert( batch.log_obs.size() == n_batch );
+   assert( batch.log_n_choose_k.size() == n_batch );
+   //
+   // nan, r2, pi2, log_2
+   double nan   = std::numeric_limits<double>::quiet_NaN();
+   double r2    = std::sqrt(2.0);
+   double pi2   = 8.0 * std::atan(1.0);
+   double log_2 = std::log(2.0);
+   //
+   // mu, delta
+   // gather the values for this batch into contiguous vectors
+   CppAD::vector<double> mu(n_batch), delta(n_batch);
+   for(size_t i = 0; i < n_batch; ++i)
+   {  mu[i]    = mu_vec[ batch.index[i] ];
+      delta[i] = delta_vec[ batch.index[i] ];
+   }
+   if( d_enum != uniform_enum )
+   {  for(size_t i = 0; i < n_batch; ++i) if( delta[i] <= 0.0 )
+      {  std::string msg = "residual_density: delta = ";
+         msg += CppAD::to_string(delta[i]);
+         msg += " is not greater than 0";
+         error_exit(msg);
+      }
+   }
+   //
+   // wres
+   CppAD::vector<double> wres(n_batch);
+   const double* obs     = batch.obs.data();
+   const double* log_obs = batch.log_obs.data();
+   const double* eta     = batch.eta.data();
+   if( d_enum == uniform_enum )
+   {  for(size_t i = 0; i < n_batch; ++i)
+         wres[i] = 0.0;
+   }
+   else if( log_density(d_enum) )
+   {  for(size_t i = 0; i < n_batch; ++i)
+         wres[i] = ( log_obs[i] - log( mu[i] + eta[i] ) ) / delta[i];
+   }
+   else
+   {  for(size_t i = 0; i < n_batch; ++i)
+         wres[i] = ( obs[i] - mu[i] ) / delta[i];
+   }
+   //
+   // logden_smooth, logden_sub_abs
+   CppAD::vector<double> smooth(n_batch), sub_abs(n_batch);
+   for(size_t i = 0; i < n_batch; ++i)
+   {  smooth[i]  = nan;
+      sub_abs[i] = 0.0;
+   }
+   switch( d_enum )
+   {
+      default:
+      assert(false);
+      break;
+
+      case uniform_enum:
+      for(size_t i = 0; i < n_batch; ++i)
+         smooth[i] = 0.0;
+      break;
+
+      case binomial_enum:
+      {  const double* log_n_choose_k = batch.log_n_choose_k.data();
+         const double* n_vec          = batch.sample_size.data();
+         for(size_t i = 0; i < n_batch; ++i)
+         {  double y = nan;
+            if( residual_type == real_data_enum )
+               y = obs[i];
+            double n   = n_vec[i];
+            double k   = n * y;
+            double p   = mu[i];
+            smooth[i]  = log_n_choose_k[i]
+               + apx_log(p) * k + apx_log(1.0 - p) * (n - k);
+         }
+      }
+      break;
+
+      case gaussian_enum:
+      case log_gaussian_enum:
+      for(size_t i = 0; i < n_batch; ++i)
+         smooth[i] = - log( delta[i] * sqrt( pi2 ) ) - wres[i] * wres[i] / 2.0;
+      break;
+
+      case laplace_enum:
+      case log_laplace_enum:
+      for(size_t i = 0; i < n_batch; ++i)
+      {  smooth[i]  = - log( delta[i] * r2 );
+         sub_abs[i] = r2 * wres[i];
+      }
+      break;
+
+      case students_enum:
+      case log_students_enum:
+      {  const double* nu = batch.nu.data();
+         for(size_t i = 0; i < n_batch; ++i)
+         {  double r = 1.0 + wres[i] * wres[i] / ( nu[i] - 2.0 );
+            smooth[i] = - log( r ) * (nu[i] + 1.0) / 2.0;
+         }
+      }
+      break;
+
+      case cen_gaussian_enum:
+      for(size_t i = 0; i < n_batch; ++i)
+      {  if( obs[i] <= 0 )
+         {  double c = 0.0;
+            double erfc_value = std::erfc( (mu[i] - c) / ( delta[i] * r2 ) );
+            smooth[i] = log(erfc_value / 2.0 );
+         }
+         else
+            smooth[i] = - log( delta[i] * sqrt( pi2 ) )
+               - wres[i] * wres[i] / 2.0;
+      }
+      break;
+
+      case cen_log_gaussian_enum:
+      for(size_t i = 0; i < n_batch; ++i)
+      {  if( obs[i] <= 0 )
+         {  double c = 0.0;
+            double erfc_value = std::erfc(
+               (log(mu[i] + eta[i]) - log(c + eta[i])) / ( delta[i] * r2 )
+            );
+            smooth[i] = log(erfc_value / 2.0 );
+         }
+         else
+            smooth[i] = - log( delta[i] * sqrt( pi2 ) )
+               - wres[i] * wres[i] / 2.0;
+      }
+      break;
+
+      case cen_laplace_enum:
+      for(size_t i = 0; i < n_batch; ++i)
+      {  if( obs[i] <= 0 )
+         {  double c = 0.0;
+            smooth[i] = - (mu[i] - c) * r2 / delta[i] - log_2;
+         }
+         else
+         {  smooth[i]  = - log( delta[i] * r2 );
+            sub_abs[i] = r2 * wres[i];
+         }
+      }
+      break;
+
+      case cen_log_laplace_enum:
+      for(size_t i = 0; i < n_batch; ++i)
+      {  if( obs[i] <= 0 )
+         {  double c = 0.0;
+            smooth[i] = - (log(mu[i] + eta[i]) - log(c + eta[i])) * r2
+               / delta[i] - log_2;
+         }
+         else
+         {  smooth[i]  = - log( delta[i] * r2 );
+            sub_abs[i] = r2 * wres[i];
+         }
+      }
+      break;
+   }
+   //
+   // residual_vec
+   for(size_t i = 0; i < n_batch; ++i)
+   {  residual_struct<double>& residual = residual_vec[ batch.index[i] ];
+      residual.wres           = wres[i];
+      residual.logden_smooth  = smooth[i];
+      residual.logden_sub_abs = sub_abs[i];
+      residual.density        = d_enum;
+      residual.index          = batch.index[i];
+   }
+}
 
 } // END DISMOD_AT_NAMESPACE
@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# include <cmath>
+# include <cassert>
+# include <dismod_at/stream_summary.hpp>
+
+/*
+{xrst_begin stream_summary dev}
+{xrst_spell
+  jain
+  chlamtac
+  welford
+}
+
+Streaming Mean, Standard Deviation, and Quantiles of a Sequence of Values
+#########################################################################
+
+Syntax
+******
+
+| ``stream_summary`` *summary* ( *prob* )
+| *summary* . ``add`` ( *value* )
+| *n_value* = *summary* . ``n_value`` ()
+| *mean* = *summary* . ``mean`` ()
+| *std_dev* = *summary* . ``std_dev`` ()
+| *q* = *summary* . ``quantile`` ( *k* )
+
+Purpose
+*******
+Computes summary statistics for a sequence of values
+without storing the sequence;
+i.e., the memory used by *summary* does not depend on the
+number of values in the sequence.
+
+prob
+****
+This vector specifies the probabilities for the quantiles that are
+computed. Each element of *prob* must be between zero and one.
+
+add
+***
+Adds the ``double`` *value* to the sequence of values.
+
+n_value
+*******
+is the number of values that have been added to the sequence.
+
+mean
+****
+is the mean of the sequence of values
+(it is not a number if *n_value* is zero).
+The mean and standard deviation are computed using
+Welford's method.
+
+std_dev
+*******
+is the sample standard deviation of the sequence of values; i.e.,
+the square root of the sum of the squared deviations from the mean
+divided by *n_value* ``-1`` .
+If *n_value* is less than two, *std_dev* is zero.
+
+quantile
+********
+The argument *k* is an index less than the size of *prob* .
+The return value *q* is an approximation for the
+*prob* [ *k* ] quantile of the sequence of values.
+If *n_value* is less than or equal five, *q* is computed exactly
+by linear interpolation of the sorted values.
+Otherwise it is computed using the P-squared algorithm of
+Jain and Chlamtac (1985), which uses five markers for each quantile.
+It is not a number if *n_value* is zero.
+
+{xrst_toc_hidden
+   example/devel/utility/stream_summary_xam.cpp
+}
+Example
+*******
+The file :ref:`stream_summary_xam.cpp-name`
+contains an example and test of this class.
+
+{xrst_end stream_summary}
+*/
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// constructor
+stream_summary::stream_summary(const CppAD::vector<double>& prob)
+: prob_( prob )
+, n_value_(0)
+, mean_(0.0)
+, sum_sq_(0.0)
+, height_( 5 * prob.size() )
+, position_( 5 * prob.size() )
+, desired_( 5 * prob.size() )
+{  for(size_t k = 0; k < prob.size(); ++k)
+   {  assert( 0.0 <= prob[k] && prob[k] <= 1.0 );
+      for(size_t i = 0; i < 5; ++i)
+         position_[5 * k + i] = double(i);
+      desired_[5 * k + 0] = 0.0;
+      desired_[5 * k + 1] = 2.0 * prob[k];
+      desired_[5 * k + 2] = 4.0 * prob[k];
+      desired_[5 * k + 3] = 2.0 + 2.0 * prob[k];
+      desired_[5 * k + 4] = 4.0;
+   }
+}
+
+// add
+void stream_summary::add(double value)
+{  size_t n_prob = prob_.size();
+   //
+   // mean_, sum_sq_, n_value_
+   ++n_value_;
+   double diff = value - mean_;
+   mean_      += diff / double(n_value_);
+   sum_sq_    += diff * (value - mean_);
+   //
+   if( n_prob == 0 )
+      return;
+   //
+   // first five values: insertion sort into height_[0], ..., height_[4]
+   if( n_value_ <= 5 )
+   {  size_t i = n_value_ - 1;
+      while( 0 < i && value < height_[i - 1] )
+      {  height_[i] = height_[i - 1];
+         --i;
+      }
+      height_[i] = value;
+      if( n_value_ == 5 )
+      {  for(size_t k = 1; k < n_prob; ++k)
+            for(size_t i = 0; i < 5; ++i)
+               height_[5 * k + i] = height_[i];
+      }
+      return;
+   }
+   //
+   // P-squared update for each quantile
+   for(size_t k = 0; k < n_prob; ++k)
+   {  double* q  = height_.data()   + 5 * k;
+      double* n  = position_.data() + 5 * k;
+      double* np = desired_.data()  + 5 * k;
+      double  p  = prob_[k];
+      //
+      // j: index of the cell that contains value
+      size_t j;
+      if( value < q[0] )
+      {  q[0] = value;
+         j    = 0;
+      }
+      else if( q[4] <= value )
+      {  q[4] = value;
+         j    = 3;
+      }
+      else
+      {  j = 0;
+         while( q[j + 1] <= value )
+            ++j;
+      }
+      //
+      // n, np
+      for(size_t i = j + 1; i < 5; ++i)
+         n[i] += 1.0;
+      np[1] += p / 2.0;
+      np[2] += p;
+      np[3] += (1.0 + p) / 2.0;
+      np[4] += 1.0;
+      //
+      // adjust the heights of the middle markers
+      for(size_t i = 1; i < 4; ++i)
+      {  double d = np[i] - n[i];
+         bool move_right = d >= 1.0 && n[i+1] - n[i] > 1.0;
+         bool move_left  = d <= -1.0 && n[i-1] - n[i] < -1.0;
+         if( move_right || move_left )
+         {  double s = move_right ? 1.0 : -1.0;
+            //
+            // parabolic prediction
+            double qp = q[i] + s / (n[i+1] - n[i-1]) * (
+               (n[i] - n[i-1] + s) * (q[i+1] - q[i]) / (n[i+1] - n[i]) +
+               (n[i+1] - n[i] - s) * (q[i] - q[i-1]) / (n[i] - n[i-1])
+            );
+            if( q[i-1] < qp && qp < q[i+1] )
+               q[i] = qp;
+            else
+            {  // linear prediction
+               size_t ell = move_right ? i + 1 : i - 1;
+               q[i] += s * (q[ell] - q[i]) / (n[ell] - n[i]);
+            }
+            n[i] += s;
+         }
+      }
+   }
+   return;
+}
+
+// n_value
+size_t stream_summary::n_value(void) const
+{  return n_value_; }
+
+// mean
+double stream_summary::mean(void) const
+{  if( n_value_ == 0 )
+      return std::nan("");
+   return mean_;
+}
+
+// std_dev
+double stream_summary::std_dev(void) const
+{  if( n_value_ < 2 )
+      return 0.0;
+   return std::sqrt( sum_sq_ / double(n_value_ - 1) );
+}
+
+// quantile
+double stream_summary::quantile(size_t k) const
+{  assert( k < prob_.size() );
+   if( n_value_ == 0 )
+      return std::nan("");
+   //
+   // exact quantile using the sorted values
+   if( n_value_ <= 5 )
+   {  double index = prob_[k] * double(n_value_ - 1);
+      size_t lower = size_t( std::floor(index) );
+      if( lower + 1 >= n_value_ )
+         return height_[n_value_ - 1];
+      double frac  = index - double(lower);
+      return (1.0 - frac) * height_[lower] + frac * height_[lower + 1];
+   }
+   //
+   // P-squared approximation
+   const double* q = height_.data() + 5 * k;
+   if( prob_[k] == 0.0 )
+      return q[0];
+   if( prob_[k] == 1.0 )
+      return q[4];
+   return q[2];
+}
+
+} // END_DISMOD_AT_NAMESPACE
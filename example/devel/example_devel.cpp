@@ -52,6 +52,7 @@ extern bool prior_random_xam(void);
 extern bool avgint_subset_xam(void);
 extern bool balance_pair_xam(void);
 extern bool bilinear_interp_xam(void);
+extern bool block_cholesky_xam(void);
 extern bool child_info_xam(void);
 extern bool child_data_in_fit_xam(void);
 extern bool cohort_ode_xam(void);
@@ -63,18 +64,26 @@ extern bool manage_gsl_rng_xam(void);
 extern bool age_avg_grid_xam(void);
 extern bool pack_info_xam(void);
 extern bool pack_prior_xam(void);
+extern bool pack_warm_start_xam(void);
+extern bool parallel_loop_xam(void);
+extern bool process_loop_xam(void);
 extern bool random_effect_xam(void);
 extern bool n_random_const_xam(void);
+extern bool ode2_checkpoint_xam(void);
 extern bool residual_density_xam(void);
 extern bool sim_random_xam(void);
 extern bool grid2line_xam(void);
+extern bool lanczos_sample_xam(void);
+extern bool mcmc_diagnostic_xam(void);
 extern bool split_space_xam(void);
+extern bool stream_summary_xam(void);
 extern bool time_line_vec_xam(void);
 
 // table subdirectory
 extern bool get_bnd_mulcov_table_xam(void);
 extern bool blob_table_xam(void);
 extern bool check_pini_n_age_xam(void);
+extern bool compact_table_xam(void);
 extern bool create_table_xam(void);
 extern bool get_age_table_xam(void);
 extern bool get_nslist_table_xam(void);
@@ -98,9 +107,12 @@ extern bool get_smooth_grid_xam(void);
 extern bool get_table_column_xam(void);
 extern bool get_time_table_xam(void);
 extern bool get_weight_grid_xam(void);
+extern bool log_message_xam(void);
+extern bool memory_connection_xam(void);
 extern bool get_subgroup_table_xam(void);
 extern bool put_table_row_xam(void);
 extern bool smooth_info_xam(void);
+extern bool sqlite_profile_xam(void);
 extern bool weight_info_xam(void);
 
 // anonymous namespace
@@ -151,6 +163,7 @@ int main(void)
    RUN(avgint_subset_xam);
    RUN(balance_pair_xam);
    RUN(bilinear_interp_xam);
+   RUN(block_cholesky_xam);
    RUN(child_info_xam);
    RUN(child_data_in_fit_xam);
    RUN(cohort_ode_xam);
@@ -162,18 +175,26 @@ int main(void)
    RUN(age_avg_grid_xam);
    RUN(pack_info_xam);
    RUN(pack_prior_xam);
+   RUN(pack_warm_start_xam);
+   RUN(parallel_loop_xam);
+   RUN(process_loop_xam);
    RUN(residual_density_xam);
    RUN(random_effect_xam);
    RUN(n_random_const_xam);
+   RUN(ode2_checkpoint_xam);
    RUN(sim_random_xam);
    RUN(grid2line_xam);
+   RUN(lanczos_sample_xam);
+   RUN(mcmc_diagnostic_xam);
    RUN(split_space_xam);
+   RUN(stream_summary_xam);
    RUN(time_line_vec_xam);
 
    // table subdirectory
    RUN(get_bnd_mulcov_table_xam);
    RUN(blob_table_xam);
    RUN(check_pini_n_age_xam);
+   RUN(compact_table_xam);
    RUN(create_table_xam);
    RUN(get_age_table_xam);
    RUN(get_nslist_table_xam);
@@ -198,8 +219,11 @@ int main(void)
    RUN(get_time_table_xam);
    RUN(get_weight_grid_xam);
    RUN(get_subgroup_table_xam);
+   RUN(log_message_xam);
+   RUN(memory_connection_xam);
    RUN(put_table_row_xam);
    RUN(smooth_info_xam);
+   RUN(sqlite_profile_xam);
    RUN(weight_info_xam);
 
    // summary report
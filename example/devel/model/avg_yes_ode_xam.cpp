@@ -166,8 +166,9 @@ bool avg_yes_ode_xam(void)
       int(n_integrand) - int(dismod_at::susceptible_enum) - 1;
    data_table[data_id].node_id      = 1; // child node
    data_table[data_id].weight_id    = 0;
+   // (age limits are on the age_avg_grid, see Lexis grid below)
    data_table[data_id].age_lower    = 0.0;
-   data_table[data_id].age_upper    = 100.0;
+   data_table[data_id].age_upper    = 99.0;
    data_table[data_id].time_lower   = 1990.0;
    data_table[data_id].time_upper   = 2000.0;
    data_table[data_id].meas_value   = 0.0;
@@ -177,7 +178,7 @@ bool avg_yes_ode_xam(void)
    //
    data_id = 1;
    data_table[data_id]              = data_table[0];
-   data_table[data_id].age_lower    = 10.;
+   data_table[data_id].age_lower    = 9.;
    data_table[data_id].age_upper    = 90.0;
    data_table[data_id].time_lower   = 1990.0;
    data_table[data_id].integrand_id =
@@ -328,12 +329,16 @@ bool avg_yes_ode_xam(void)
    using CppAD::exp;
    ok            &= data_table.size() == subset_data_obj.size();
    //
+   // avg_ode: averages using the ODE solution for each rectangle
+   vector<Float> avg_ode( data_table.size() );
+   //
    data_id = 0;
    Float avg      = data_object.average(data_id, pack_vec);
    double b       = data_table[data_id].age_lower;
    double c       = data_table[data_id].age_upper;
    double avg_S   = - ( exp(-beta * c) - exp(-beta * b) ) / (beta * (c - b));
    ok             &= fabs( 1.0 - avg / avg_S ) <= 1e-3;
+   avg_ode[data_id] = avg;
    //
    data_id = 1;
    avg            = data_object.average(data_id, pack_vec);
@@ -342,6 +347,7 @@ bool avg_yes_ode_xam(void)
    avg_S          = - ( exp(-beta * c) - exp(-beta * b) ) / (beta * (c - b));
    double avg_C   = 1.0 - avg_S;
    ok             &= fabs( 1.0 - avg / avg_C ) <= 1e-3;
+   avg_ode[data_id] = avg;
    //
    data_id = 2;
    avg            = data_object.average(data_id, pack_vec);
@@ -350,6 +356,36 @@ bool avg_yes_ode_xam(void)
    avg_S          = - ( exp(-beta * c) - exp(-beta * b) ) / (beta * (c - b));
    double avg_P   = 1.0 - avg_S;
    ok             &= fabs( 1.0 - avg / avg_P ) <= 1e-3;
+   avg_ode[data_id] = avg;
+   /*
+   Same averages using the ODE solution on a Lexis grid.
+   The rates are constant in time, so all the cohorts in the Lexis grid
+   have the same solution and interpolation in time is exact.
+   The age limits for the data are on the age_avg_grid,
+   so interpolation in age is not needed. Hence the Lexis grid averages
+   are equal to the averages above, up to rounding error, and the
+   ODE discretization error (1e-3 above) does not hide an error in
+   the Lexis grid.
+   */
+   data_object.set_ode_lexis_grid(true);
+   data_object.new_pack_vec();
+   for(data_id = 0; data_id < data_table.size(); ++data_id)
+   {  avg  = data_object.average(data_id, pack_vec);
+      ok  &= fabs( 1.0 - avg / avg_ode[data_id] ) <= 1e-10;
+   }
+   //
+   // a new value for pack_vec must not use the previous Lexis grid
+   double scale = 2.0;
+   for(size_t var_id = 0; var_id < pack_vec.size(); ++var_id)
+      pack_vec[var_id] *= scale;
+   beta *= scale;
+   data_object.new_pack_vec();
+   data_id = 0;
+   avg     = data_object.average(data_id, pack_vec);
+   b       = data_table[data_id].age_lower;
+   c       = data_table[data_id].age_upper;
+   avg_S   = - ( exp(-beta * c) - exp(-beta * b) ) / (beta * (c - b));
+   ok     &= fabs( 1.0 - avg / avg_S ) <= 1e-3;
    return ok;
 }
 // END C++
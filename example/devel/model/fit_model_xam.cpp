@@ -427,6 +427,7 @@ bool fit_model_xam(void)
    }
    // ----------------------- run the fit -------------------------------
    bool quasi_fixed = false;
+   bool zero_sum_basis = false;
    //
    // zero_sum_child_rate
    vector<bool> zero_sum_child_rate( dismod_at::number_rate_enum );
@@ -458,6 +459,7 @@ bool fit_model_xam(void)
       quasi_fixed,
       zero_sum_child_rate,
       zero_sum_mulcov_group,
+      zero_sum_basis,
       data_object
    );
    bool random_only = false;
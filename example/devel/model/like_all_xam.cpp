@@ -312,8 +312,10 @@ bool like_all_xam(void)
    bool random_depend = false;
    CppAD::vector< dismod_at::residual_struct<Float> > residual_vec =
       data_object.like_all(hold_out, random_depend, pack_vec);
+   vector<Float> avg_vec( data_table.size() );
    for(size_t data_id = 0; data_id < data_table.size(); data_id++)
    {  Float avg         = data_object.average(data_id, pack_vec);
+      avg_vec[data_id]  = avg;
       Float  wres       = residual_vec[data_id].wres;
       Float  loglike    = residual_vec[data_id].logden_smooth;
       loglike          -= fabs( residual_vec[data_id].logden_sub_abs );
@@ -383,6 +385,18 @@ bool like_all_xam(void)
       cout << std::endl;
       */
    }
+   //
+   // Both data points have the same averaging structure, so the constructor
+   // recorded a checkpoint function for their group. Check that the
+   // checkpoint averages (used above) agree with the double averages.
+   vector<double> double_pack_vec( pack_object.size() );
+   for(size_t i = 0; i < pack_object.size(); ++i)
+      double_pack_vec[i] = Value( pack_vec[i] );
+   for(size_t data_id = 0; data_id < data_table.size(); data_id++)
+   {  double avg = data_object.average(data_id, double_pack_vec);
+      ok        &= fabs( 1.0 - avg / Value( avg_vec[data_id] ) ) <= 100.0 *
+         std::numeric_limits<double>::epsilon();
+   }
 
    return ok;
 }
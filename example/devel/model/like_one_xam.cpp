@@ -380,6 +380,24 @@ bool like_one_xam(void)
       cout << std::endl;
       */
    }
+   //
+   // check average_all using two threads
+   vector<double> pack_double( pack_vec.size() );
+   for(size_t i = 0; i < pack_vec.size(); ++i)
+      pack_double[i] = Value( pack_vec[i] );
+   vector<double> avg_vec, delta_vec;
+   vector< dismod_at::residual_struct<double> > residual_vec;
+   data_object.set_number_thread(2);
+   data_object.average_all(pack_double, avg_vec, delta_vec, residual_vec);
+   for(size_t data_id = 0; data_id < data_table.size(); data_id++)
+   {  double avg   = data_object.average(data_id, pack_double);
+      double delta_out;
+      dismod_at::residual_struct<double> residual
+                  = data_object.like_one(data_id, pack_double, avg, delta_out);
+      ok &= avg_vec[data_id]           == avg;
+      ok &= delta_vec[data_id]         == delta_out;
+      ok &= residual_vec[data_id].wres == residual.wres;
+   }
 
    return ok;
 }
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin compact_table_xam.cpp dev}
+
+Compact Table Storage: Example and Test
+#######################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end compact_table_xam.cpp}
+*/
+// BEGIN C++
+# include <cmath>
+# include <limits>
+# include <dismod_at/compact_table.hpp>
+# include <dismod_at/get_table_column.hpp>
+# include <dismod_at/does_table_exist.hpp>
+# include <dismod_at/open_connection.hpp>
+
+bool compact_table_xam(void)
+{  bool   ok = true;
+   using CppAD::vector;
+   //
+   // db
+   std::string  file_name = "example.db";
+   bool         new_file  = true;
+   sqlite3*     db        = dismod_at::open_connection(file_name, new_file);
+   //
+   // table_name, col_name
+   std::string table_name = "sample";
+   vector<std::string> col_name = {"sample_index", "var_id", "var_value"};
+   //
+   // value
+   size_t n_index    = 3;
+   size_t n_position = 4;
+   vector<double> value(n_index * n_position);
+   for(size_t i = 0; i < value.size(); ++i)
+      value[i] = 1.0 / double(i + 1);
+   //
+   // format
+   for(std::string format : {"long", "float64", "float32"} )
+   {  dismod_at::put_compact_table(
+         db, format, table_name, col_name, n_index, value
+      );
+      //
+      // check which table exists
+      bool long_exist = dismod_at::does_table_exist(db, table_name);
+      bool blob_exist = dismod_at::does_table_exist(db, table_name + "_blob");
+      ok &= long_exist == (format == "long");
+      ok &= blob_exist == (format != "long");
+      //
+      // index, position, check
+      vector<int> index, position;
+      vector<double> check;
+      bool found = dismod_at::get_compact_table(
+         db, table_name, col_name, index, position, check
+      );
+      ok &= found == blob_exist;
+      if( ! found )
+      {  std::string column_name = "var_value";
+         dismod_at::get_table_column(db, table_name, column_name, check);
+      }
+      //
+      // check values
+      double eps = 100. * std::numeric_limits<double>::epsilon();
+      if( format == "float32" )
+         eps = 100. * std::numeric_limits<float>::epsilon();
+      ok &= check.size() == value.size();
+      for(size_t i = 0; i < value.size(); ++i)
+      {  ok &= std::fabs( 1.0 - check[i] / value[i] ) < eps;
+         if( found )
+         {  ok &= size_t( index[i] ) == i / n_position;
+            ok &= size_t( position[i] ) == i % n_position;
+         }
+      }
+   }
+   //
+   // db
+   sqlite3_close(db);
+   return ok;
+}
+// END C++
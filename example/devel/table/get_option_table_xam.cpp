@@ -44,6 +44,8 @@ bool get_option_table_xam(void)
       { "accept_after_max_steps_fixed",     "6" },
       { "accept_after_max_steps_random",    "6" },
       { "age_avg_split",                    "1.0 2.0" },
+      { "aggregate_data",                   "true" },
+      { "asymptotic_lanczos_step",          "0" },
       { "asymptotic_rcond_lower",           "0.0" },
       { "avgint_extra_columns",             "" },
       { "bound_frac_fixed",                 "1e-3" },
@@ -52,11 +54,19 @@ bool get_option_table_xam(void)
       { "data_extra_columns",               "" },
       { "derivative_test_fixed",            "second-order" },
       { "derivative_test_random",           "first-order" },
+      { "gauss_newton_fixed",               "5" },
       { "hold_out_integrand",               "" },
       { "limited_memory_max_history_fixed", "15" },
       { "max_num_iter_random",              "50" },
+      { "mcmc_number_chain",                "4" },
+      { "mcmc_number_leapfrog",             "10" },
+      { "mcmc_number_warmup",               "200" },
       { "meas_noise_effect",                "add_std_scale_all" },
+      { "memory_database",                  "true" },
       { "method_random",                    "ipopt_random" },
+      { "number_thread",                    "1" },
+      { "ode_lexis_grid",                   "true" },
+      { "ode_step_schedule",                "80.0 40.0" },
       { "ode_step_size",                    "20.0" },
       { "other_database",                   "" },
       { "other_input_table",                "" },
@@ -68,10 +78,13 @@ bool get_option_table_xam(void)
       { "random_seed",                      "123" },
       { "rate_case",                        "iota_zero_rho_zero" },
       { "splitting_covariate",              "" },
+      { "sqlite_profile",                   "fast" },
+      { "storage_format",                   "long" },
       { "tolerance_fixed",                  "1e-7" },
       { "tolerance_random",                 "1e-7" },
       { "trace_init_fit_model",             "false" },
       { "warn_on_stderr",                   "true" },
+      { "zero_sum_basis",                   "true" },
       { "zero_sum_child_rate",              "iota  omega" },
       { "zero_sum_mulcov_group",            "world" }
    };
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin log_message_xam.cpp dev}
+
+Put a Message in the Log Table: Example and Test
+################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end log_message_xam.cpp}
+*/
+// BEGIN C++
+# include <dismod_at/log_message.hpp>
+# include <dismod_at/open_connection.hpp>
+# include <dismod_at/exec_sql_cmd.hpp>
+# include <dismod_at/null_int.hpp>
+# include <dismod_at/configure.hpp>
+
+bool log_message_xam(void)
+{  bool   ok = true;
+   using dismod_at::log_message;
+   using dismod_at::exec_sql_cmd;
+   //
+   // db
+   std::string  file_name = "example.db";
+   bool         new_file  = true;
+   sqlite3*     db        = dismod_at::open_connection(file_name, new_file);
+   //
+   // os, sep, sql_cmd
+   std::ostream* os      = DISMOD_AT_NULL_PTR;
+   char          sep     = ',';
+   std::string   sql_cmd =
+      "select log_id, message_type, table_name, row_id, message from log";
+   //
+   // without buffering, each message is written when it is logged
+   log_message(db, os, "command", "begin example");
+   log_message(db, os, "value", "x = 1");
+   std::string result = exec_sql_cmd(db, sql_cmd, sep);
+   ok &= result == "0,command,,,begin example\n1,value,,,x = 1\n";
+   //
+   // hold warning and value messages
+   dismod_at::log_buffer(db, true);
+   log_message(db, os, "warning", "it's small");
+   log_message(db, os, "warning", "it's small");
+   log_message(db, os, "warning", "it's small");
+   log_message(db, os, "warning", "bad value", "data", 2);
+   std::string check = exec_sql_cmd(db, sql_cmd, sep);
+   ok &= check == result;
+   //
+   // a command message writes the messages being held
+   log_message(db, os, "command", "end example");
+   result = exec_sql_cmd(db, sql_cmd, sep);
+   check  = "0,command,,,begin example\n";
+   check += "1,value,,,x = 1\n";
+   check += "2,warning,,,it's small\n";
+   check += "3,warning,,,previous warning logged 3 times\n";
+   check += "4,warning,data,2,bad value\n";
+   check += "5,command,,,end example\n";
+   ok &= result == check;
+   //
+   // stop holding messages
+   log_message(db, os, "warning", "last");
+   dismod_at::log_buffer(db, false);
+   sql_cmd = "select message from log where log_id = 6";
+   result  = exec_sql_cmd(db, sql_cmd, sep);
+   ok &= result == "last\n";
+   //
+   // db
+   sqlite3_close(db);
+   return ok;
+}
+// END C++
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin memory_connection_xam.cpp dev}
+
+Working Copy of a Database in Memory: Example and Test
+######################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end memory_connection_xam.cpp}
+*/
+// BEGIN C++
+# include <dismod_at/memory_connection.hpp>
+# include <dismod_at/open_connection.hpp>
+# include <dismod_at/exec_sql_cmd.hpp>
+
+bool memory_connection_xam(void)
+{  bool   ok = true;
+   using dismod_at::exec_sql_cmd;
+   //
+   // disk_db
+   std::string  file_name = "example.db";
+   bool         new_file  = true;
+   sqlite3*     disk_db   = dismod_at::open_connection(file_name, new_file);
+   //
+   // mytable
+   exec_sql_cmd(disk_db, "create table mytable(name text, value real)");
+   exec_sql_cmd(disk_db, "insert into mytable values('one', 1.0)");
+   //
+   // db
+   // this also closes disk_db
+   sqlite3* db = dismod_at::open_memory_connection(disk_db);
+   //
+   // the copy contains mytable
+   char sep = ',';
+   std::string result = exec_sql_cmd(db, "select * from mytable", sep);
+   ok &= result == "one,1.0\n";
+   //
+   // change the copy
+   exec_sql_cmd(db, "insert into mytable values('two', 2.0)");
+   //
+   // write the copy back to the file
+   dismod_at::close_connection(db);
+   //
+   // check the file
+   new_file = false;
+   disk_db  = dismod_at::open_connection(file_name, new_file);
+   result   = exec_sql_cmd(disk_db, "select * from mytable", sep);
+   ok &= result == "one,1.0\ntwo,2.0\n";
+   //
+   // the temporary table that holds the file name is not written back
+   result   = exec_sql_cmd(disk_db,
+      "select count(*) from sqlite_master where name='memory_file'", sep
+   );
+   ok &= result == "0\n";
+   //
+   // close_connection is sqlite3_close for a connection that is not in memory
+   dismod_at::close_connection(disk_db);
+   return ok;
+}
+// END C++
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin sqlite_profile_xam.cpp dev}
+
+SQLite Performance Settings: Example and Test
+#############################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end sqlite_profile_xam.cpp}
+*/
+// BEGIN C++
+# include <dismod_at/sqlite_profile.hpp>
+# include <dismod_at/open_connection.hpp>
+
+bool sqlite_profile_xam(void)
+{  bool   ok = true;
+   //
+   // db
+   std::string  file_name = "example.db";
+   bool         new_file  = true;
+   sqlite3*     db        = dismod_at::open_connection(file_name, new_file);
+   //
+   // fast
+   // this database is empty so the page size changes
+   std::string message = dismod_at::sqlite_profile(db, "fast");
+   ok &= message.find("sqlite_profile = fast") == 0;
+   ok &= message.find("page_size = 65536") != std::string::npos;
+   ok &= message.find("journal_mode = truncate") != std::string::npos;
+   ok &= message.find("synchronous = 1") != std::string::npos;
+   ok &= message.find("cache_size = -65536") != std::string::npos;
+   ok &= message.find("temp_store = 2") != std::string::npos;
+   //
+   // small writes do not use the bulk settings
+   ok &= ! dismod_at::sqlite_bulk_begin(db, 10);
+   //
+   // large writes use the bulk settings until sqlite_bulk_end
+   ok &= dismod_at::sqlite_bulk_begin(db, 10000000);
+   message = dismod_at::sqlite_profile(db, "safe");
+   ok &= message.find("journal_mode = memory") != std::string::npos;
+   ok &= message.find("synchronous = 0") != std::string::npos;
+   dismod_at::sqlite_bulk_end(db);
+   //
+   // safe does not change the settings
+   message = dismod_at::sqlite_profile(db, "safe");
+   ok &= message.find("sqlite_profile = safe") == 0;
+   ok &= message.find("journal_mode = truncate") != std::string::npos;
+   //
+   // bulk
+   message = dismod_at::sqlite_profile(db, "bulk");
+   ok &= message.find("sqlite_profile = bulk") == 0;
+   ok &= message.find("journal_mode = memory") != std::string::npos;
+   ok &= message.find("synchronous = 0") != std::string::npos;
+   ok &= message.find("cache_size = -262144") != std::string::npos;
+   //
+   // large writes only switch settings for the fast profile
+   ok &= ! dismod_at::sqlite_bulk_begin(db, 10000000);
+   //
+   // db
+   sqlite3_close(db);
+   return ok;
+}
+// END C++
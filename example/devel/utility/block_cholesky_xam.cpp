@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin block_cholesky_xam.cpp dev}
+
+Example and Test of Block Cholesky Factorization
+################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end block_cholesky_xam.cpp}
+*/
+// BEGIN C++
+# include <cmath>
+# include <limits>
+# include <dismod_at/block_cholesky.hpp>
+
+bool block_cholesky_xam(void)
+{  bool ok = true;
+   double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
+   //
+   // H restricted to indices {0, 3} is [ [4, 2], [2, 3] ]
+   // H restricted to index {1} is [ 2 ]
+   // index 2 does not appear
+   size_t n = 4, nnz = 4;
+   CppAD::vector<size_t> row(nnz), col(nnz);
+   CppAD::vector<double> val(nnz);
+   row[0] = 0; col[0] = 0; val[0] = 4.0;
+   row[1] = 3; col[1] = 0; val[1] = 2.0;
+   row[2] = 3; col[2] = 3; val[2] = 3.0;
+   row[3] = 1; col[3] = 1; val[3] = 2.0;
+   dismod_at::block_cholesky chol(n, row, col, val);
+   ok &= chol.ok();
+   ok &= chol.n_block() == 2;
+   //
+   // inverse of first block is [ [3, -2], [-2, 4] ] / 8
+   CppAD::vector<double> g(n);
+   g[0] = 1.0;
+   g[1] = 1.0;
+   g[2] = 5.0;
+   g[3] = 1.0;
+   double check = (3.0 - 2.0 - 2.0 + 4.0) / 8.0 + 1.0 / 2.0;
+   ok &= std::fabs( chol.inv_quad(g) - check ) < eps99;
+   //
+   // only the second block
+   g[0] = 0.0;
+   g[3] = 0.0;
+   ok &= std::fabs( chol.inv_quad(g) - 0.5 ) < eps99;
+   //
+   // a matrix that is not positive definite
+   val[1] = 4.0;
+   dismod_at::block_cholesky not_pd(n, row, col, val);
+   ok &= ! not_pd.ok();
+   //
+   return ok;
+}
+// END C++
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-22 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 /*
 {xrst_begin child_info_xam.cpp dev}
@@ -29,20 +29,25 @@ bool child_info_xam(void)
    size_t parent_node_id = 0;
 
    // node_table
-   size_t n_node = 4;
+   size_t n_node = 6;
    CppAD::vector<dismod_at::node_struct> node_table(n_node);
    node_table[0].parent = DISMOD_AT_NULL_INT; // parent node
    node_table[1].parent =  0; // child_id = 0
    node_table[2].parent =  0; // child_id = 1
    node_table[3].parent =  2; // grand child node below child_id = 2
+   node_table[4].parent = DISMOD_AT_NULL_INT; // not below parent node
+   node_table[5].parent =  4; // not below parent node
 
    // data_table
-   size_t n_data = 4;
+   size_t n_data = 7;
    CppAD::vector<dismod_at::data_struct> data_table(n_data);
    data_table[0].node_id = 3; // in child_id = 1  set
    data_table[1].node_id = 2; // in child_id = 1  set
    data_table[2].node_id = 1; // in child_id = 0  set
    data_table[3].node_id = 0; // in parent node   set
+   data_table[4].node_id = 5; // not in parent node or descendant set
+   data_table[5].node_id = 4; // not in parent node or descendant set
+   data_table[6].node_id = 3; // in child_id = 1  set
 
    // constructor
    dismod_at::child_info child_info4data(
@@ -62,6 +67,9 @@ bool child_info_xam(void)
    ok &= child_info4data.table_id2child(1) == 1;      // second data child_id = 1
    ok &= child_info4data.table_id2child(2) == 0;      // third  data child_id = 0
    ok &= child_info4data.table_id2child(3) == n_child;// fourth in parent set
+   ok &= child_info4data.table_id2child(4) == n_child + 1;
+   ok &= child_info4data.table_id2child(5) == n_child + 1;
+   ok &= child_info4data.table_id2child(6) == 1;
 
    return ok;
 }
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin lanczos_sample_xam.cpp dev}
+
+Example and Test of Matrix Free Sampling Using the Lanczos Method
+#################################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end lanczos_sample_xam.cpp}
+*/
+// BEGIN C++
+# include <cmath>
+# include <limits>
+# include <dismod_at/lanczos_sample.hpp>
+
+namespace {
+   // H = Q * D * Q^T where Q = I - 2 * u * u^T / (u^T * u)
+   // y = Q * diag(d) * Q^T * x
+   void product(
+      const CppAD::vector<double>& u ,
+      const CppAD::vector<double>& d ,
+      const CppAD::vector<double>& x ,
+      CppAD::vector<double>&       y )
+   {  size_t n = x.size();
+      double uu = 0.0, ux = 0.0;
+      for(size_t i = 0; i < n; ++i)
+      {  uu += u[i] * u[i];
+         ux += u[i] * x[i];
+      }
+      // y = Q^T x
+      for(size_t i = 0; i < n; ++i)
+         y[i] = x[i] - 2.0 * u[i] * ux / uu;
+      // y = diag(d) * y
+      double uy = 0.0;
+      for(size_t i = 0; i < n; ++i)
+      {  y[i] *= d[i];
+         uy   += u[i] * y[i];
+      }
+      // y = Q * y
+      for(size_t i = 0; i < n; ++i)
+         y[i] -= 2.0 * u[i] * uy / uu;
+   }
+}
+
+bool lanczos_sample_xam(void)
+{  bool ok = true;
+   typedef CppAD::vector<double> vector;
+   //
+   // u, d
+   size_t n = 6;
+   vector u(n), d(n), d_inv_sqrt(n);
+   for(size_t i = 0; i < n; ++i)
+   {  u[i]          = double(i + 1);
+      d[i]          = double(i + 1) * double(i + 1);
+      d_inv_sqrt[i] = 1.0 / double(i + 1);
+   }
+   //
+   // hes_vec
+   auto hes_vec = [&u, &d](const vector& x, vector& y)
+   {  product(u, d, x, y); };
+   //
+   // z
+   vector z(n);
+   for(size_t i = 0; i < n; ++i)
+      z[i] = std::sin( double(i + 1) );
+   //
+   // check = H^{-1/2} z = Q * diag(d_inv_sqrt) * Q^T * z
+   vector check(n);
+   product(u, d_inv_sqrt, z, check);
+   //
+   // exact case: Krylov dimension equal n
+   vector sample, ritz;
+   std::string msg = dismod_at::lanczos_sample(n, hes_vec, z, sample, ritz);
+   ok &= msg == "";
+   ok &= sample.size() == n;
+   for(size_t i = 0; i < n; ++i)
+      ok &= std::fabs( sample[i] - check[i] ) < 1e-10;
+   //
+   // Ritz values are the eigenvalues of H
+   ok &= ritz.size() == n;
+   for(size_t i = 0; i < n; ++i)
+      ok &= std::fabs( ritz[i] / d[i] - 1.0 ) < 1e-10;
+   //
+   // approximate case: Ritz values are within the spectrum of H
+   size_t n_step = 3;
+   msg = dismod_at::lanczos_sample(n_step, hes_vec, z, sample, ritz);
+   ok &= msg == "";
+   ok &= ritz.size() == n_step;
+   for(size_t i = 0; i < n_step; ++i)
+   {  ok &= d[0] * (1.0 - 1e-10) <= ritz[i];
+      ok &= ritz[i] <= d[n-1] * (1.0 + 1e-10);
+   }
+   //
+   return ok;
+}
+// END C++
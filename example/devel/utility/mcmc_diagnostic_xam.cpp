@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin mcmc_diagnostic_xam.cpp dev}
+
+Example and Test of Markov Chain Monte Carlo Diagnostics
+########################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end mcmc_diagnostic_xam.cpp}
+*/
+// BEGIN C++
+# include <cmath>
+# include <dismod_at/mcmc_diagnostic.hpp>
+
+namespace {
+   // uniform on [-1, 1] using a linear congruential generator
+   double uniform(unsigned long& state)
+   {  state = (state * 1103515245UL + 12345UL) % 2147483648UL;
+      return 2.0 * double(state) / 2147483648.0 - 1.0;
+   }
+}
+
+bool mcmc_diagnostic_xam(void)
+{  bool   ok = true;
+   //
+   size_t n_chain = 4;
+   size_t n_draw  = 1000;
+   CppAD::vector<double> draw(n_chain * n_draw);
+   unsigned long state = 1;
+   double r_hat, ess;
+   //
+   // independent draws from the same distribution
+   for(size_t k = 0; k < n_chain * n_draw; ++k)
+      draw[k] = uniform(state);
+   dismod_at::mcmc_diagnostic(n_chain, draw, r_hat, ess);
+   ok &= std::fabs(r_hat - 1.0) < 0.01;
+   ok &= 0.7 * double(n_chain * n_draw) < ess;
+   ok &= ess < 1.3 * double(n_chain * n_draw);
+   //
+   // highly correlated draws: x[i] = a * x[i-1] + e[i]
+   // integrated autocorrelation time is (1 + a) / (1 - a) = 19
+   double a = 0.9;
+   for(size_t c = 0; c < n_chain; ++c)
+   {  draw[c * n_draw] = uniform(state);
+      for(size_t i = 1; i < n_draw; ++i)
+         draw[c * n_draw + i] = a * draw[c * n_draw + i - 1] + uniform(state);
+   }
+   dismod_at::mcmc_diagnostic(n_chain, draw, r_hat, ess);
+   ok &= r_hat < 1.05;
+   ok &= double(n_chain * n_draw) / 40.0 < ess;
+   ok &= ess < double(n_chain * n_draw) / 10.0;
+   //
+   // chains that have not mixed
+   for(size_t c = 0; c < n_chain; ++c)
+      for(size_t i = 0; i < n_draw; ++i)
+         draw[c * n_draw + i] = double(c) + uniform(state);
+   dismod_at::mcmc_diagnostic(n_chain, draw, r_hat, ess);
+   ok &= r_hat > 1.5;
+   //
+   // degenerate case
+   for(size_t k = 0; k < n_chain * n_draw; ++k)
+      draw[k] = 1.0;
+   dismod_at::mcmc_diagnostic(n_chain, draw, r_hat, ess);
+   ok &= std::isnan(r_hat);
+   ok &= std::isnan(ess);
+   //
+   return ok;
+}
+// END C++
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin ode2_checkpoint_xam.cpp dev}
+
+Example and Test of Checkpoint Function for One ODE Step
+########################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end ode2_checkpoint_xam.cpp}
+*/
+// BEGIN C++
+# include <cppad/cppad.hpp>
+# include <dismod_at/ode2_checkpoint.hpp>
+# include <dismod_at/eigen_ode2.hpp>
+# include <dismod_at/trap_ode2.hpp>
+
+namespace {
+   bool run_case(size_t case_number, const CppAD::vector<double>& b)
+   {  bool ok = true;
+      using CppAD::NearEqual;
+      typedef CppAD::AD<double>     a1_double;
+      typedef CppAD::vector<double>    vector;
+      typedef CppAD::vector<a1_double> a1_vector;
+      double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
+      //
+      // x = (b, yi, tf)
+      vector x(7);
+      for(size_t i = 0; i < 4; ++i)
+         x[i] = b[i];
+      x[4] = 1.0;
+      x[5] = 2.0;
+      x[6] = 0.1;
+      //
+      // f: function that uses the checkpoint
+      // g: function that does not use the checkpoint
+      CppAD::ADFun<double> f, g;
+      for(size_t k = 0; k < 2; ++k)
+      {  a1_vector ax(7), a1_b(4), a1_yi(2), a1_yf(2);
+         for(size_t i = 0; i < 7; ++i)
+            ax[i] = x[i];
+         CppAD::Independent(ax);
+         for(size_t i = 0; i < 4; ++i)
+            a1_b[i] = ax[i];
+         a1_yi[0] = ax[4];
+         a1_yi[1] = ax[5];
+         a1_double a1_tf = ax[6];
+         if( k == 0 )
+         {  a1_yf = dismod_at::ode2_checkpoint(
+               case_number, a1_b, a1_yi, a1_tf
+            );
+            f.Dependent(ax, a1_yf);
+         }
+         else
+         {  if( case_number == 0 )
+               a1_yf = dismod_at::trap_ode2(a1_b, a1_yi, a1_tf);
+            else
+               a1_yf = dismod_at::eigen_ode2(case_number, a1_b, a1_yi, a1_tf);
+            g.Dependent(ax, a1_yf);
+         }
+      }
+      //
+      // the checkpoint is one operation in the tape for f
+      ok &= f.size_op() < g.size_op();
+      //
+      // compare function values
+      vector fx = f.Forward(0, x);
+      vector gx = g.Forward(0, x);
+      for(size_t i = 0; i < 2; ++i)
+         ok &= NearEqual(fx[i], gx[i], eps99, eps99);
+      //
+      // compare derivatives
+      vector f_jac = f.Jacobian(x);
+      vector g_jac = g.Jacobian(x);
+      for(size_t i = 0; i < 2 * 7; ++i)
+         ok &= NearEqual(f_jac[i], g_jac[i], eps99, eps99);
+      //
+      return ok;
+   }
+}
+
+bool ode2_checkpoint_xam(void)
+{  bool ok = true;
+   typedef CppAD::vector<double> vector;
+   vector b(4);
+   //
+   // must be done before any recording that uses ode2_checkpoint
+   dismod_at::ode2_checkpoint_setup();
+   // -------------------------------------------------------------------
+   // trapezoidal method
+   b[0] = -3.0 , b[1] =  1.0;
+   b[2] =  1.0 , b[3] = -3.0;
+   ok &= run_case(0, b);
+   // -------------------------------------------------------------------
+   // b1 = 0, b2 = 0
+   b[0] = -3.0;  b[1] = 0.0;
+   b[2] = 0.0;   b[3] = -2.0;
+   ok &= run_case(1, b);
+   // -------------------------------------------------------------------
+   // b1 != 0, b2 = 0, b0 != b3
+   b[0] = -3.0 , b[1] =  1.0;
+   b[2] =  0.0 , b[3] = -2.0;
+   ok &= run_case(2, b);
+   // -------------------------------------------------------------------
+   // b1 = 0, b2 != 0, b0 != b3
+   b[0] = -3.0 , b[1] =  0.0;
+   b[2] =  1.0 , b[3] = -2.0;
+   ok &= run_case(3, b);
+   // -------------------------------------------------------------------
+   // b1 != 0, b2 != 0
+   b[0] = -3.0 , b[1] =  1.0;
+   b[2] =  1.0 , b[3] = -3.0;
+   ok &= run_case(4, b);
+   // -------------------------------------------------------------------
+   return ok;
+}
+// END C++
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin pack_warm_start_xam.cpp dev}
+
+C++ pack_warm_start: Example and Test
+#####################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end pack_warm_start_xam.cpp}
+*/
+// BEGIN C++
+# include <dismod_at/pack_warm_start.hpp>
+
+bool pack_warm_start_xam(void)
+{  bool   ok = true;
+   //
+   // warm_start
+   size_t n = 2, m = 1;
+   CppAD::mixed::warm_start_struct warm_start;
+   warm_start.mu      = 1e-3;
+   warm_start.scale_f = 2.0;
+   warm_start.x_info.resize(n);
+   warm_start.g_info.resize(m);
+   for(size_t j = 0; j < n; ++j)
+   {  warm_start.x_info[j].x       = double(j + 1);
+      warm_start.x_info[j].z_L     = 0.0;
+      warm_start.x_info[j].z_U     = 0.5;
+      warm_start.x_info[j].scale_x = 3.0;
+   }
+   warm_start.g_info[0].lambda  = 4.0;
+   warm_start.g_info[0].scale_g = 5.0;
+   //
+   // random_opt
+   CppAD::vector<double> random_opt(3);
+   for(size_t k = 0; k < 3; ++k)
+      random_opt[k] = 0.1 * double(k);
+   //
+   // pack and unpack
+   CppAD::vector<double> vec = dismod_at::pack_warm_start(
+      warm_start, random_opt
+   );
+   CppAD::vector<double> random_check;
+   CppAD::mixed::warm_start_struct check =
+      dismod_at::unpack_warm_start(vec, random_check);
+   //
+   ok &= check.mu      == warm_start.mu;
+   ok &= check.scale_f == warm_start.scale_f;
+   ok &= check.x_info.size() == n;
+   ok &= check.g_info.size() == m;
+   for(size_t j = 0; j < n; ++j)
+   {  ok &= check.x_info[j].x       == warm_start.x_info[j].x;
+      ok &= check.x_info[j].z_L     == warm_start.x_info[j].z_L;
+      ok &= check.x_info[j].z_U     == warm_start.x_info[j].z_U;
+      ok &= check.x_info[j].scale_x == warm_start.x_info[j].scale_x;
+   }
+   ok &= check.g_info[0].lambda  == warm_start.g_info[0].lambda;
+   ok &= check.g_info[0].scale_g == warm_start.g_info[0].scale_g;
+   ok &= random_check.size() == 3;
+   for(size_t k = 0; k < 3; ++k)
+      ok &= random_check[k] == random_opt[k];
+   //
+   // a vector packed before the random effects were included
+   size_t size_old = 4 + 4 * n + 2 * m;
+   CppAD::vector<double> vec_old(size_old);
+   for(size_t i = 0; i < size_old; ++i)
+      vec_old[i] = vec[i];
+   check = dismod_at::unpack_warm_start(vec_old, random_check);
+   ok &= check.x_info.size() == n;
+   ok &= check.x_info[1].x == warm_start.x_info[1].x;
+   ok &= random_check.size() == 0;
+   //
+   return ok;
+}
+// END C++
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin parallel_loop_xam.cpp dev}
+
+Example and Test of Running a Loop Using Multiple Threads
+#########################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end parallel_loop_xam.cpp}
+*/
+// BEGIN C++
+# include <cmath>
+# include <cppad/cppad.hpp>
+# include <dismod_at/parallel_loop.hpp>
+
+bool parallel_loop_xam(void)
+{  bool ok = true;
+   //
+   // n_loop, result
+   size_t n_loop = 100;
+   CppAD::vector<double> result(n_loop);
+   for(size_t i = 0; i < n_loop; ++i)
+      result[i] = 0.0;
+   //
+   for(size_t n_thread = 1; n_thread <= 4; ++n_thread)
+   {  //
+      // work
+      auto work = [n_loop, n_thread, &result](size_t thread)
+      {  // temporary vectors that are local to this thread
+         CppAD::vector<double> temp(2);
+         CppAD::vector< CppAD::AD<double> > a1_temp(1);
+         for(size_t i = thread; i < n_loop; i += n_thread)
+         {  temp[0]    = double(i);
+            temp[1]    = std::sqrt( temp[0] );
+            a1_temp[0] = temp[0] * temp[1];
+            result[i]  = Value( a1_temp[0] ) + double(n_thread);
+         }
+      };
+      //
+      // parallel_loop
+      dismod_at::parallel_loop(n_thread, work);
+      //
+      // check
+      for(size_t i = 0; i < n_loop; ++i)
+      {  double check = double(i) * std::sqrt( double(i) ) + double(n_thread);
+         ok &= result[i] == check;
+      }
+   }
+   return ok;
+}
+// END C++
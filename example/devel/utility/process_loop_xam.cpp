@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin process_loop_xam.cpp dev}
+
+Example and Test of Running a Loop Using Multiple Processes
+###########################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end process_loop_xam.cpp}
+*/
+// BEGIN C++
+# include <string>
+# include <vector>
+# include <dismod_at/process_loop.hpp>
+
+bool process_loop_xam(void)
+{  bool ok = true;
+   //
+   // n_task
+   size_t n_task = 10;
+   //
+   for(size_t n_process = 1; n_process <= 4; ++n_process)
+   {  //
+      // changed
+      // this change is only seen by this process when n_process is one
+      size_t changed = 0;
+      //
+      // work
+      // returns task copies of the character 'a' + task
+      auto work = [&changed](size_t task, bool child)
+      {  ++changed;
+         std::string bytes( task, char('a' + task) );
+         return bytes;
+      };
+      //
+      // result
+      std::vector<size_t> order;
+      auto result = [&ok, &order](size_t task, const std::string& bytes)
+      {  ok &= bytes == std::string( task, char('a' + task) );
+         order.push_back(task);
+      };
+      //
+      // process_loop
+      std::string msg =
+         dismod_at::process_loop(n_process, n_task, work, result);
+      ok &= msg == "";
+      //
+      // check
+      ok &= order.size() == n_task;
+      for(size_t task = 0; task < order.size(); ++task)
+         ok &= order[task] == task;
+      if( n_process == 1 )
+         ok &= changed == n_task;
+   }
+   return ok;
+}
+// END C++
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin stream_summary_xam.cpp dev}
+
+Example and Test of Streaming Summary Statistics
+################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end stream_summary_xam.cpp}
+*/
+// BEGIN C++
+# include <cmath>
+# include <limits>
+# include <dismod_at/stream_summary.hpp>
+
+bool stream_summary_xam(void)
+{  bool ok = true;
+   double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
+   //
+   // prob
+   CppAD::vector<double> prob(3);
+   prob[0] = 0.1;
+   prob[1] = 0.5;
+   prob[2] = 0.9;
+   //
+   // small case: quantiles are exact
+   dismod_at::stream_summary small(prob);
+   small.add(3.0);
+   small.add(1.0);
+   small.add(2.0);
+   ok &= small.n_value() == 3;
+   ok &= std::fabs( small.mean() - 2.0 ) < eps99;
+   ok &= std::fabs( small.std_dev() - 1.0 ) < eps99;
+   ok &= std::fabs( small.quantile(0) - 1.2 ) < eps99;
+   ok &= std::fabs( small.quantile(1) - 2.0 ) < eps99;
+   ok &= std::fabs( small.quantile(2) - 2.8 ) < eps99;
+   //
+   // large case: values are a permutation of 0, ..., n - 1
+   // so the p quantile is p * (n - 1)
+   size_t n = 10007;
+   dismod_at::stream_summary large(prob);
+   for(size_t i = 0; i < n; ++i)
+      large.add( double( (i * 7919) % n ) );
+   ok &= large.n_value() == n;
+   //
+   // mean and standard deviation are exact
+   double mean = double(n - 1) / 2.0;
+   double var  = double(n) * double(n + 1) / 12.0;
+   ok &= std::fabs( large.mean() / mean - 1.0 ) < eps99;
+   ok &= std::fabs( large.std_dev() / std::sqrt(var) - 1.0 ) < 1e-10;
+   //
+   // quantiles are approximate
+   for(size_t k = 0; k < prob.size(); ++k)
+   {  double check = prob[k] * double(n - 1);
+      ok &= std::fabs( large.quantile(k) - check ) < 0.01 * double(n);
+   }
+   return ok;
+}
+// END C++
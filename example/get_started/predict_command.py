@@ -52,6 +52,9 @@ file_name      = 'get_started.db'
 dismod_at.system_command_prc( [program, file_name, 'init'] )
 dismod_at.system_command_prc( [program, file_name, 'fit', 'both'] )
 dismod_at.system_command_prc( [program, file_name, 'predict', 'fit_var'] )
+dismod_at.system_command_prc(
+   [program, file_name, 'predict', 'fit_var', 'summary']
+)
 # -----------------------------------------------------------------------
 # connect to database
 connection = dismod_at.create_connection(
@@ -63,6 +66,7 @@ var_table      = dismod_at.get_table_dict(connection, 'var')
 fit_var_table  = dismod_at.get_table_dict(connection, 'fit_var')
 avgint_table   = dismod_at.get_table_dict(connection, 'avgint')
 predict_table  = dismod_at.get_table_dict(connection, 'predict')
+summary_table  = dismod_at.get_table_dict(connection, 'predict_summary')
 assert len(avgint_table) == 1
 #
 for var_id in range( len(var_table) ) :
@@ -90,6 +94,15 @@ predict_row   = predict_table[0]
 avg_integrand = predict_row['avg_integrand']
 assert abs( avg_integrand / model_value - 1.0 ) < 1e-7
 #
+# summary of the one set of model variables in the fit_var table
+assert len(summary_table) == len(avgint_table)
+summary_row = summary_table[0]
+assert summary_row['avgint_id'] == 0
+assert summary_row['n_sample'] == 1
+assert summary_row['std'] == 0.0
+for column in [ 'mean', 'lower', 'median', 'upper' ] :
+   assert abs( summary_row[column] / model_value - 1.0 ) < 1e-7
+#
 # -----------------------------------------------------------------------
 print('predict_command: OK')
 # END PYTHON
@@ -18,6 +18,9 @@
 # This example demonstrates using
 # The :ref:`option_table@Zero Sum Constraints@zero_sum_child_rate`
 # to improve the speed and accuracy of estimation of the fixed effects.
+# It also checks that the
+# :ref:`option_table@Zero Sum Constraints@zero_sum_basis` option
+# gives a solution that satisfies the same constraints.
 #
 # Problem Parameters
 # ******************
@@ -299,84 +302,94 @@ def example_db (file_name) :
    )
    # ----------------------------------------------------------------------
 # ===========================================================================
-# Create database and run init, start, fit with zero sum for random effects
+# Create database
 file_name = 'example.db'
 example_db(file_name)
-#
 program = '../../devel/dismod_at'
-dismod_at.system_command_prc([ program, file_name, 'init' ])
-dismod_at.system_command_prc([ program, file_name, 'fit', 'both' ])
-# -----------------------------------------------------------------------
-# connect to database
-connection      = dismod_at.create_connection(
-   file_name, new = False, readonly = True
-)
 # -----------------------------------------------------------------------
-# check the zero random effects solution
-#
-# get variable and fit_var tables
-var_table     = dismod_at.get_table_dict(connection, 'var')
-fit_var_table = dismod_at.get_table_dict(connection, 'fit_var')
-rate_table    = dismod_at.get_table_dict(connection, 'rate')
-node_table    = dismod_at.get_table_dict(connection, 'node')
-time_table    = dismod_at.get_table_dict(connection, 'time')
-#
-# for node = north_america, canada, united_states, mexico
-#  for time = 1990, 2010
-#     for rate = iota, rho :
-n_var = len(var_table)
-assert n_var == 4 * 2 * 2
-#
-# initialize sum of random effects for each rate and time
-sum_random = {
-   'iota' : [ 0.0, 0.0 ],
-   'rho'  : [ 0.0, 0.0 ]
-}
-# check of values uses the fact that the data density is Gaussian
-count_random = 0
-ok           = True
-for var_id in range( n_var ) :
-   var_type = var_table[var_id]['var_type']
-   assert( var_type == 'rate' )
-   #
-   rate_id   = var_table[var_id]['rate_id']
-   rate_name = rate_table[rate_id]['rate_name']
-   #
-   node_id   = var_table[var_id]['node_id']
-   node_name = node_table[node_id]['node_name']
+# check_fit
+def check_fit() :
+   # connect to database
+   connection      = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   # -----------------------------------------------------------------------
+   # check the zero random effects solution
    #
-   # note there are only two time_id values in time_table
-   time_id   = var_table[var_id]['time_id']
-   time      = time_table[time_id]['time']
+   # get variable and fit_var tables
+   var_table     = dismod_at.get_table_dict(connection, 'var')
+   fit_var_table = dismod_at.get_table_dict(connection, 'fit_var')
+   rate_table    = dismod_at.get_table_dict(connection, 'rate')
+   node_table    = dismod_at.get_table_dict(connection, 'node')
+   time_table    = dismod_at.get_table_dict(connection, 'time')
    #
-   value     = fit_var_table[var_id]['fit_var_value']
+   # for node = north_america, canada, united_states, mexico
+   #  for time = 1990, 2010
+   #     for rate = iota, rho :
+   n_var = len(var_table)
+   assert n_var == 4 * 2 * 2
    #
-   if node_name == 'north_america' :
-      if rate_name == 'iota' :
-         relerr = value / iota_parent - 1.0
+   # initialize sum of random effects for each rate and time
+   sum_random = {
+      'iota' : [ 0.0, 0.0 ],
+      'rho'  : [ 0.0, 0.0 ]
+   }
+   # check of values uses the fact that the data density is Gaussian
+   count_random = 0
+   ok           = True
+   for var_id in range( n_var ) :
+      var_type = var_table[var_id]['var_type']
+      assert( var_type == 'rate' )
+      #
+      rate_id   = var_table[var_id]['rate_id']
+      rate_name = rate_table[rate_id]['rate_name']
+      #
+      node_id   = var_table[var_id]['node_id']
+      node_name = node_table[node_id]['node_name']
+      #
+      # note there are only two time_id values in time_table
+      time_id   = var_table[var_id]['time_id']
+      time      = time_table[time_id]['time']
+      #
+      value     = fit_var_table[var_id]['fit_var_value']
+      #
+      if node_name == 'north_america' :
+         if rate_name == 'iota' :
+            relerr = value / iota_parent - 1.0
+         else :
+            relerr = value / rho_parent - 1.0
+      elif node_name == 'canada' :
+         relerr = value / rate_effect_child  - 1.0
+      elif node_name == 'mexico' :
+         relerr = value - 0.0
       else :
-         relerr = value / rho_parent - 1.0
-   elif node_name == 'canada' :
-      relerr = value / rate_effect_child  - 1.0
-   elif node_name == 'mexico' :
-      relerr = value - 0.0
-   else :
-      assert node_name == 'united_states'
-      relerr = - value / rate_effect_child  - 1.0
-   if abs(relerr) > 0.1 :
-      print('node_name, relerr=', node_name, relerr)
-      print('python_seed = ', python_seed)
-      assert False
-   if node_name != 'north_america' :
-      sum_random[rate_name][time_id] += value
-      count_random += 1
-assert count_random == 3 * 2 * 2
-for rate in [ 'iota', 'rho' ] :
-   for time_id in [ 0 , 1 ] :
-      if( abs( sum_random[rate][time_id] ) ) > 1e-9 :
-         print('rate, sum random = ', rate, sum_random[rate][time_id] )
+         assert node_name == 'united_states'
+         relerr = - value / rate_effect_child  - 1.0
+      if abs(relerr) > 0.1 :
+         print('node_name, relerr=', node_name, relerr)
          print('python_seed = ', python_seed)
          assert False
+      if node_name != 'north_america' :
+         sum_random[rate_name][time_id] += value
+         count_random += 1
+   assert count_random == 3 * 2 * 2
+   for rate in [ 'iota', 'rho' ] :
+      for time_id in [ 0 , 1 ] :
+         if( abs( sum_random[rate][time_id] ) ) > 1e-9 :
+            print('rate, sum random = ', rate, sum_random[rate][time_id] )
+            print('python_seed = ', python_seed)
+            assert False
+   connection.close()
+# -----------------------------------------------------------------------
+# Run init, fit with zero sum for random effects using constraints and then
+# using a basis that eliminates the constraints
+for zero_sum_basis in [ 'false', 'true' ] :
+   dismod_at.system_command_prc(
+      [ program, file_name, 'set', 'option', 'zero_sum_basis', zero_sum_basis ]
+   )
+   dismod_at.system_command_prc([ program, file_name, 'init' ])
+   dismod_at.system_command_prc([ program, file_name, 'fit', 'both' ])
+   check_fit()
 #
 # -----------------------------------------------------------------------
 print('zsum_child_rate.py: OK')
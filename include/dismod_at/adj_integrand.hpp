@@ -41,6 +41,8 @@ private:
    //
    CppAD::vector< CppAD::vector<double> >     double_rate_;
    CppAD::vector< CppAD::vector<a1_double> >  a1_double_rate_;
+   //
+   CppAD::vector<a1_double>                   a1_double_x_;
 
    // template version of line
    template <class Float>
@@ -53,6 +55,7 @@ private:
       size_t                                    child            ,
       size_t                                    subgroup_id      ,
       const CppAD::vector<double>&              x                ,
+      const CppAD::vector<Float>&               x_cov            ,
       const CppAD::vector<Float>&               pack_vec         ,
       CppAD::vector<Float>&                     mulcov           ,
       CppAD::vector< CppAD::vector<Float> >&    rate
@@ -96,6 +99,41 @@ public:
       const CppAD::vector<double>&              x                ,
       const CppAD::vector<a1_double>&           pack_vec
    );
+   // double version of line with separate covariate values for effects
+   CppAD::vector<double> line(
+      size_t                                    node_id          ,
+      const CppAD::vector<double>&              line_age         ,
+      const CppAD::vector<double>&              line_time        ,
+      size_t                                    integrand_id     ,
+      size_t                                    n_child          ,
+      size_t                                    child            ,
+      size_t                                    subgroup_id      ,
+      const CppAD::vector<double>&              x                ,
+      const CppAD::vector<double>&              x_cov            ,
+      const CppAD::vector<double>&              pack_vec
+   );
+   // a1_double version of line with covariate values that are variables
+   CppAD::vector<a1_double> line(
+      size_t                                    node_id          ,
+      const CppAD::vector<double>&              line_age         ,
+      const CppAD::vector<double>&              line_time        ,
+      size_t                                    integrand_id     ,
+      size_t                                    n_child          ,
+      size_t                                    child            ,
+      size_t                                    subgroup_id      ,
+      const CppAD::vector<double>&              x                ,
+      const CppAD::vector<a1_double>&           a1_x             ,
+      const CppAD::vector<a1_double>&           pack_vec
+   );
+   // depend
+   void depend(
+      size_t                                    integrand_id     ,
+      size_t                                    n_child          ,
+      size_t                                    child            ,
+      size_t                                    subgroup_id      ,
+      CppAD::vector<size_t>&                    pack_index       ,
+      CppAD::vector<size_t>&                    covariate_index
+   ) const;
 };
 
 } // END_DISMOD_AT_NAMESPACE
@@ -14,6 +14,7 @@ Contents
 ********
 {xrst_toc_table
    devel/model/avg_integrand.cpp
+   devel/model/lexis_grid.cpp
 }
 
 {xrst_end devel_avg_integrand}
@@ -28,6 +29,7 @@ Contents
 # include "time_line_vec.hpp"
 # include "weight_info.hpp"
 # include "cov2weight_map.hpp"
+# include "lexis_grid.hpp"
 
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
@@ -41,10 +43,20 @@ private:
    const CppAD::vector<integrand_struct>&    integrand_table_;
    const CppAD::vector<weight_info>&         w_info_vec_;
 
+   // set by set_ode_lexis_grid (false by constructor)
+   bool                                      ode_lexis_grid_;
+
+   // incremented by new_pack_vec (zero by constructor)
+   size_t                                    pack_generation_;
+
    // temporaries used to avoid memory re-allocation (need constructor)
    time_line_vec<double>                     double_time_line_object_;
    time_line_vec<a1_double>                  a1_double_time_line_object_;
    //
+   // ODE solutions shared between rectangles (need constructor)
+   lexis_grid<double>                        double_lexis_object_;
+   lexis_grid<a1_double>                     a1_double_lexis_object_;
+   //
    adj_integrand                             adjint_obj_;
 
    // other temporaries used to avoid memory re-allocation
@@ -72,7 +84,9 @@ private:
       const CppAD::vector<double>&     x                ,
       const CppAD::vector<Float>&      pack_vec         ,
       //
+      const CppAD::vector<Float>*      x_cov            ,
       time_line_vec<Float>&            time_line_object ,
+      lexis_grid<Float>&               lexis_object     ,
       CppAD::vector<Float>&            line_adj
    );
 
@@ -90,6 +104,7 @@ private:
       size_t                       subgroup_id          ,
       const CppAD::vector<double>& x                    ,
       const CppAD::vector<Float>&  pack_vec             ,
+      const CppAD::vector<Float>*  x_cov                ,
       time_line_vec<Float>&        time_line_object     ,
       CppAD::vector<Float>&        line_adj
    );
@@ -111,6 +126,22 @@ public:
       const CppAD::vector<smooth_info>&         s_info_vec       ,
       const pack_info&                          pack_object
    );
+   // set_ode_lexis_grid
+   void set_ode_lexis_grid(bool ode_lexis_grid);
+   //
+   // new_pack_vec
+   void new_pack_vec(void);
+   //
+   // components of pack_vec and x that rectangle depends on
+   void depend(
+      size_t                 integrand_id    ,
+      size_t                 n_child         ,
+      size_t                 child           ,
+      size_t                 subgroup_id     ,
+      CppAD::vector<size_t>& pack_index      ,
+      CppAD::vector<size_t>& covariate_index
+   ) const;
+   //
    // double version of rectangle
    double rectangle(
       size_t                           node_id          ,
@@ -141,6 +172,22 @@ public:
       const CppAD::vector<double>&     x                ,
       const CppAD::vector<a1_double>&  pack_vec
    );
+   // a1_double version of rectangle with covariate values that are variables
+   a1_double rectangle(
+      size_t                           node_id          ,
+      double                           age_lower        ,
+      double                           age_upper        ,
+      double                           time_lower       ,
+      double                           time_upper       ,
+      size_t                           weight_id        ,
+      size_t                           integrand_id     ,
+      size_t                           n_child          ,
+      size_t                           child            ,
+      size_t                           subgroup_id      ,
+      const CppAD::vector<double>&     x                ,
+      const CppAD::vector<a1_double>&  a1_x             ,
+      const CppAD::vector<a1_double>&  pack_vec
+   );
 };
 
 } // END_DISMOD_AT_NAMESPACE
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_BLOCK_CHOLESKY_HPP
+# define DISMOD_AT_BLOCK_CHOLESKY_HPP
+
+# include <cppad/utility/vector.hpp>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+class block_cholesky {
+private:
+   // dimension of the matrix
+   const size_t                           n_;
+   //
+   // block_[i] is the block that index i belongs to
+   // (n_block_ if row and column i of the matrix are not present)
+   CppAD::vector<size_t>                  block_;
+   //
+   // local_[i] is the index of i within its block
+   CppAD::vector<size_t>                  local_;
+   //
+   // index_[b] is the matrix indices that are in block b
+   CppAD::vector< CppAD::vector<size_t> > index_;
+   //
+   // factor_[b] is the lower triangular Cholesky factor for block b
+   // in row major order
+   CppAD::vector< CppAD::vector<double> > factor_;
+   //
+   // number of blocks
+   size_t                                 n_block_;
+   //
+   // is the matrix positive definite
+   bool                                   ok_;
+   //
+   // temporary used by inv_quad
+   mutable CppAD::vector<double>          temp_;
+public:
+   // constructor
+   block_cholesky(
+      size_t                        n   ,
+      const CppAD::vector<size_t>&  row ,
+      const CppAD::vector<size_t>&  col ,
+      const CppAD::vector<double>&  val
+   );
+   //
+   // ok
+   bool ok(void) const;
+   //
+   // n_block
+   size_t n_block(void) const;
+   //
+   // inv_quad
+   double inv_quad(const CppAD::vector<double>& g) const;
+};
+
+} // END_DISMOD_AT_NAMESPACE
+
+# endif
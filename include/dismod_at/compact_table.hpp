@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_COMPACT_TABLE_HPP
+# define DISMOD_AT_COMPACT_TABLE_HPP
+
+# include <sqlite3.h>
+# include <string>
+# include <cppad/utility/vector.hpp>
+
+namespace dismod_at {
+   void put_compact_table(
+      sqlite3*                            db             ,
+      const std::string&                  storage_format ,
+      const std::string&                  table_name     ,
+      const CppAD::vector<std::string>&   col_name       ,
+      size_t                              n_index        ,
+      const CppAD::vector<double>&        value
+   );
+   bool get_compact_table(
+      sqlite3*                            db             ,
+      const std::string&                  table_name     ,
+      const CppAD::vector<std::string>&   col_name       ,
+      CppAD::vector<int>&                 index          ,
+      CppAD::vector<int>&                 position       ,
+      CppAD::vector<double>&              value
+   );
+}
+
+# endif
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-22 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 # ifndef DISMOD_AT_COV2WEIGHT_MAP_HPP
 # define DISMOD_AT_COV2WEIGHT_MAP_HPP
@@ -22,6 +22,7 @@ private:
    size_t                 split_covariate_id_;
    double                 split_covariate_reference_;
    CppAD::vector<double>  split_value_vec_;
+   CppAD::vector<size_t>  cov_offset_;
    CppAD::vector<size_t>  weight_id_vec_;
    // END_CTOR_OUTPUTS
 public:
@@ -35,7 +36,15 @@ public:
       const CppAD::vector<rate_eff_cov_struct>&   rate_eff_cov_table
    );
    //
+   // split_id
+   size_t split_id(const CppAD::vector<double>& x) const;
+   //
    // weight_id
+   size_t weight_id(
+      size_t                       covariate_id ,
+      size_t                       node_id      ,
+      size_t                       split_id
+   ) const;
    size_t weight_id(
       size_t                       covariate_id ,
       size_t                       node_id       ,
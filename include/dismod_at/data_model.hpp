@@ -6,6 +6,8 @@
 # define DISMOD_AT_DATA_MODEL_HPP
 
 # include <limits>
+# include <memory>
+# include <vector>
 # include <cppad/utility/vector.hpp>
 # include "subset_data.hpp"
 # include "get_integrand_table.hpp"
@@ -30,7 +32,20 @@ class data_model {
       density_enum          density;
       size_t                child;
       bool                  depend_on_ran_var;
+      size_t                group;
    } data_ode_info;
+   //
+   // information for a group of data points with the same averaging
+   struct group_info {
+      // number of data points in this group
+      size_t                                           n_subset;
+      // pack_vec indices that are arguments to the checkpoint function
+      CppAD::vector<size_t>                            pack_index;
+      // covariate indices that are arguments to the checkpoint function
+      CppAD::vector<size_t>                            covariate_index;
+      // checkpoint function (null if it has not been recorded)
+      std::unique_ptr< CppAD::chkpoint_two<double> >   checkpoint;
+   };
 private:
    // constant values
    const bool                   fit_simulated_data_;
@@ -46,9 +61,37 @@ private:
    CppAD::vector<data_ode_info>   data_info_;
    CppAD::vector<double>          minimum_meas_cv_;
    //
+   // same_rectangle_[subset_id] is the first subset_id that has the same
+   // arguments to avg_integrand::rectangle as subset_id
+   CppAD::vector<size_t>          same_rectangle_;
+   //
+   // subset_id values in the order that the average integrands are
+   // computed (sorted by child, node, integrand, weight, age, and time)
+   CppAD::vector<size_t>          eval_order_;
+   //
    // Has replace_like been called.
    // Set false by constructor and true by replace_like.
    bool                         replace_like_called_;
+   //
+   // subset_id values grouped by density with the constants that do not
+   // depend on the model variables (set by replace_like).
+   CppAD::vector<residual_batch_struct> like_batch_;
+   //
+   // set by set_ode_lexis_grid (false by constructor)
+   bool                         ode_lexis_grid_;
+   //
+   // set by set_number_thread (one by constructor)
+   size_t                       number_thread_;
+   //
+   // set by set_aggregate_data (false by constructor)
+   bool                         aggregate_data_;
+   //
+   // set true by record_checkpoint (false by constructor)
+   bool                         checkpoint_recorded_;
+   //
+   // group_info_[ data_info_[subset_id].group ] is the group information
+   // for subset_id (set by constructor).
+   std::vector<group_info>      group_info_;
 
    // set by consructor, except that following fields set by replace_like
    // subset_data_obj_[subset_id].density_id
@@ -64,6 +107,47 @@ private:
    // Used to compute average of noise effects
    // (effectively const)
    avg_noise_effect             avg_noise_obj_;
+   //
+   // average and like_one using the specified workspace
+   template <class Float>
+   Float average(
+      size_t                        subset_id   ,
+      const CppAD::vector<Float>&   pack_vec    ,
+      avg_integrand&                avgint_obj
+   );
+   template <class Float>
+   residual_struct<Float> like_one(
+      size_t                        subset_id     ,
+      const CppAD::vector<Float>&   pack_vec      ,
+      const Float&                  avg           ,
+      Float&                        delta         ,
+      avg_noise_effect&             avg_noise_obj
+   );
+   //
+   // error_exit if the density is binomial and avg is not positive
+   template <class Float>
+   void binomial_avg_check(size_t subset_id, const Float& avg) const;
+   //
+   // transformed standard deviation used by like_one
+   template <class Float>
+   Float like_delta(
+      size_t                        subset_id     ,
+      const CppAD::vector<Float>&   pack_vec      ,
+      const Float&                  avg           ,
+      avg_noise_effect&             avg_noise_obj
+   );
+   //
+   // average using checkpoint function for this group
+   bool checkpoint_average(
+      size_t                           subset_id ,
+      const CppAD::vector<double>&     pack_vec  ,
+      double&                          avg
+   );
+   bool checkpoint_average(
+      size_t                           subset_id ,
+      const CppAD::vector<a1_double>&  pack_vec  ,
+      a1_double&                       avg
+   );
 
 public:
    template <class SubsetStruct>
@@ -96,6 +180,20 @@ public:
       const CppAD::vector<subset_data_struct>& subset_data_obj
    );
    //
+   void set_ode_lexis_grid(bool ode_lexis_grid);
+   //
+   void new_pack_vec(void);
+   //
+   void set_number_thread(size_t number_thread);
+   //
+   void set_aggregate_data(bool aggregate_data);
+   //
+   void record_checkpoint(size_t n_var);
+   //
+   size_t same_rectangle(size_t subset_id) const;
+   //
+   size_t eval_order(size_t k) const;
+   //
    // compute an average integrand: data_model is effectively const
    template <class Float>
    Float average(
@@ -119,6 +217,14 @@ public:
       bool                          parent   ,
       const  CppAD::vector<Float>&  pack_vec
    );
+   // compute average integrand, delta, and residual for all data points
+   // using number_thread_ threads (effectively const)
+   void average_all(
+      const CppAD::vector<double>&               pack_vec     ,
+      CppAD::vector<double>&                     avg_vec      ,
+      CppAD::vector<double>&                     delta_vec    ,
+      CppAD::vector< residual_struct<double> >&  residual_vec
+   );
 };
 
 } // END_DISMOD_AT_NAMESPACE
@@ -7,6 +7,7 @@
 
 # include <string>
 # include <map>
+# include <functional>
 # include <sqlite3.h>
 # include <cppad/utility/vector.hpp>
 # include <dismod_at/data_model.hpp>
@@ -20,11 +21,16 @@
 namespace dismod_at {
    void fit_command(
       bool                                          use_warm_start   ,
+      size_t                                        number_start     ,
       const std::string&                            variables        ,
       const std::string&                            simulate_index   ,
       sqlite3*                                      db               ,
       CppAD::vector<dismod_at::subset_data_struct>& subset_data_obj  ,
       dismod_at::data_model&                        data_object      ,
+      const CppAD::vector<double>&                  stage_step_size  ,
+      const std::function<
+         dismod_at::data_model*(double)
+      >&                                            new_stage_model  ,
       dismod_at::prior_model&                       prior_object     ,
       const dismod_at::pack_info&                   pack_object      ,
       const dismod_at::pack_prior&                  var2prior        ,
@@ -7,6 +7,7 @@
 # define DISMOD_AT_FIT_MODEL_HPP
 
 # include <map>
+# include <functional>
 # include <sqlite3.h>
 # include <dismod_at/a1_double.hpp>
 # include <cppad/mixed/cppad_mixed.hpp>
@@ -69,6 +70,26 @@ namespace dismod_at {
       CppAD::vector<double>             random_upper_;
       size_t                            n_random_equal_;
       //
+      // Random effects eliminated using a sum-to-zero basis.
+      // Indices are in the random effects with constants removed
+      // (see remove_const). For each set k, zero_sum_last_[k] is equal to
+      // minus the sum of zero_sum_other_[ell] for ell between
+      // zero_sum_start_[k] and zero_sum_start_[k+1] - 1.
+      CppAD::vector<size_t>             zero_sum_last_;
+      CppAD::vector<size_t>             zero_sum_start_;
+      CppAD::vector<size_t>             zero_sum_other_;
+      //
+      // Zero sum constraints that are not eliminated; i.e., A_rcv
+      // for the cppad_mixed base class (column indices are cppad_mixed
+      // random effects).
+      CppAD::mixed::d_sparse_rcv        zero_sum_con_;
+      //
+      // Mapping between random effects with constants removed and
+      // cppad_mixed random effects; var2mixed_[j] is mixed2var_.size()
+      // if j is eliminated using the sum-to-zero basis.
+      CppAD::vector<size_t>             var2mixed_;
+      CppAD::vector<size_t>             mixed2var_;
+      //
       // Offset in log scaling for each component of the fixed vector;
       // If fixed_is_scaled_[j], fixed_vec[j] in dismod_at has value
       // log( fixed_vec[j] + fixed_scale_eta_[j] ) during optimization.
@@ -103,6 +124,42 @@ namespace dismod_at {
          const CppAD::vector<Float>& fixed_after  ,
          CppAD::vector<Float>&       fixed_before
       ) const;
+      //
+      // sample fixed effects using Hessian vector products
+      std::string sample_fixed_lanczos(
+         size_t                                    n_step             ,
+         CppAD::vector<double>&                    sample_fix         ,
+         const std::function<void(
+            const CppAD::vector<double>&, CppAD::vector<double>&
+         )>&                                       hes_fixed_vec      ,
+         const CppAD::vector<double>&              fixed_opt          ,
+         const CppAD::vector<double>&              fixed_lower        ,
+         const CppAD::vector<double>&              fixed_upper        ,
+         const std::map<std::string, std::string>& option_map
+      );
+      //
+      // convert between dismod_at and cppad_mixed random effects
+      template <class Float>
+      CppAD::vector<Float> remove_random(
+         const CppAD::vector<Float>& random_vec
+      ) const;
+      template <class Float>
+      CppAD::vector<Float> restore_random(
+         const CppAD::vector<Float>& mixed_vec
+      ) const;
+      CppAD::vector<size_t> mixed_random2var_id(void) const;
+      //
+      // improve starting fixed and random effects using Gauss-Newton steps
+      bool gauss_newton_fixed(
+         size_t                                    max_iter           ,
+         double                                    tolerance          ,
+         const CppAD::vector<double>&              fixed_lower        ,
+         const CppAD::vector<double>&              fixed_upper        ,
+         const CppAD::vector<double>&              random_lower       ,
+         const CppAD::vector<double>&              random_upper       ,
+         CppAD::vector<double>&                    fixed_in           ,
+         CppAD::vector<double>&                    random_in
+      );
       // -------------------------------------------------------------------
       // virtual functions used by cppad_mixed base class
       a1_vector ran_likelihood(
@@ -121,6 +178,26 @@ namespace dismod_at {
       void fatal_error(const std::string& error_message) override;
       // display warning message and continue
       void warning(const std::string& warning_message) override;
+      // constructor that is passed the zero sum constraints
+      // (used by the public constructor)
+      fit_model(
+         const CppAD::mixed::d_sparse_rcv&    con_rcv               ,
+         bool                                 zero_sum_basis        ,
+         sqlite3*                             db                    ,
+         int                                  simulate_index        ,
+         bool                                 warn_on_stderr        ,
+         double                               bound_random          ,
+         const pack_info&                     pack_object           ,
+         const pack_prior&                    var2prior             ,
+         const CppAD::vector<double>&         start_var             ,
+         const CppAD::vector<double>&         scale_var             ,
+         const CppAD::vector<prior_struct>&   prior_table           ,
+         const prior_model&                   prior_object          ,
+         const remove_const&                  random_const          ,
+         bool                                 quasi_fixed           ,
+         data_model&                          data_object           ,
+         bool                                 trace_init
+      );
    // =======================================================================
    public:
       // constructor
@@ -139,6 +216,7 @@ namespace dismod_at {
          bool                                 quasi_fixed           ,
          const CppAD::vector<bool>&           zero_sum_child_rate   ,
          const CppAD::vector<bool>&           zero_sum_mulcov_group ,
+         bool                                 zero_sum_basis        ,
          data_model&                          data_object           ,
          bool                                 trace_init = false
       );
@@ -167,10 +245,23 @@ namespace dismod_at {
          const CppAD::vector<double>&             fit_var_value      ,
          const std::map<std::string, std::string>& option_map
       );
+      // sample from posterior distribution using Hamiltonian Monte Carlo
+      void sample_mcmc(
+         size_t                                   n_sample           ,
+         CppAD::vector<double>&                   sample_out         ,
+         CppAD::vector<double>&                   acceptance_out     ,
+         CppAD::vector<double>&                   step_size_out      ,
+         const CppAD::vector<double>&             fit_var_value      ,
+         const std::map<std::string, std::string>& option_map
+      );
       // random_obj_hes
       CppAD::mixed::d_sparse_rcv random_obj_hes(
          const CppAD::vector<double>&   pack_vec
       );
+      // fixed effects objective that does not depend on the starting point
+      double fixed_objective(
+         const CppAD::vector<double>&   pack_vec
+      );
       // cppad_mixed_info
       std::map<std::string, size_t> cppad_mixed_info(void) const
       {  return cppad_mixed_info_; }
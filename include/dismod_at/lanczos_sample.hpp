@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_LANCZOS_SAMPLE_HPP
+# define DISMOD_AT_LANCZOS_SAMPLE_HPP
+
+# include <string>
+# include <functional>
+# include <cppad/utility/vector.hpp>
+
+namespace dismod_at {
+   extern std::string lanczos_sample(
+      size_t                                            n_step  ,
+      const std::function<void(
+         const CppAD::vector<double>& x, CppAD::vector<double>& y
+      )>&                                               hes_vec ,
+      const CppAD::vector<double>&                      z       ,
+      CppAD::vector<double>&                            sample  ,
+      CppAD::vector<double>&                            ritz
+   );
+}
+
+# endif
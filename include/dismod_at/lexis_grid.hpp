@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_LEXIS_GRID_HPP
+# define DISMOD_AT_LEXIS_GRID_HPP
+
+# include <map>
+# include <tuple>
+# include <vector>
+# include <cppad/utility/vector.hpp>
+# include "adj_integrand.hpp"
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+template <class Float>
+class lexis_grid {
+private:
+   // (integrand_id, node_id, child, subgroup_id, x) for one surface
+   typedef std::tuple<
+      size_t, size_t, size_t, size_t, std::vector<double>
+   > key_type;
+   //
+   // maps cohort index k to the solution at each age in age_grid_
+   typedef std::map< int, CppAD::vector<Float> > surface_type;
+   //
+   // constants
+   const double                       ode_step_size_;
+   const CppAD::vector<double>        age_grid_;
+   //
+   // solution surfaces that have been computed so far
+   std::map<key_type, surface_type>   surface_map_;
+   //
+   // generation of pack_vec corresponding to surface_map_
+   size_t                             generation_;
+   //
+   // surface used by the previous call to value and its key
+   // (null if surface_map_ has changed since then)
+   surface_type*                      last_surface_;
+   size_t                             last_integrand_id_;
+   size_t                             last_node_id_;
+   size_t                             last_child_;
+   size_t                             last_subgroup_id_;
+   CppAD::vector<double>              last_x_;
+   //
+   // temporaries used to avoid memory re-allocation
+   CppAD::vector<double>              line_time_;
+   //
+   // find_surface
+   surface_type& find_surface(
+      size_t                          node_id      ,
+      size_t                          integrand_id ,
+      size_t                          child        ,
+      size_t                          subgroup_id  ,
+      const CppAD::vector<double>&    x
+   );
+   //
+   // cohort
+   const CppAD::vector<Float>& cohort(
+      adj_integrand&                  adjint_obj   ,
+      surface_type&                   surface      ,
+      int                             k            ,
+      size_t                          node_id      ,
+      size_t                          integrand_id ,
+      size_t                          n_child      ,
+      size_t                          child        ,
+      size_t                          subgroup_id  ,
+      const CppAD::vector<double>&    x            ,
+      const CppAD::vector<Float>&     pack_vec
+   );
+public:
+   // constructor
+   lexis_grid(double ode_step_size, const CppAD::vector<double>& age_grid);
+   //
+   // copy constructor (last_surface_ cannot point into the other map)
+   lexis_grid(const lexis_grid& other);
+   //
+   // clear
+   void clear(void);
+   //
+   // set_generation
+   void set_generation(size_t generation);
+   //
+   // n_cohort
+   size_t n_cohort(void) const;
+   //
+   // value
+   Float value(
+      adj_integrand&                  adjint_obj   ,
+      double                          age          ,
+      double                          time         ,
+      size_t                          node_id      ,
+      size_t                          integrand_id ,
+      size_t                          n_child      ,
+      size_t                          child        ,
+      size_t                          subgroup_id  ,
+      const CppAD::vector<double>&    x            ,
+      const CppAD::vector<Float>&     pack_vec
+   );
+};
+
+} // END_DISMOD_AT_NAMESPACE
+
+# endif
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-22 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 # ifndef DISMOD_AT_LOG_MESSAGE_HPP
 # define DISMOD_AT_LOG_MESSAGE_HPP
@@ -24,6 +24,10 @@ namespace dismod_at {
       const std::string& table_name   ,
       const size_t&      row_id
    );
+   extern void log_buffer(
+      sqlite3*           db           ,
+      bool               buffer
+   );
 }
 
 # endif
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_MCMC_DIAGNOSTIC_HPP
+# define DISMOD_AT_MCMC_DIAGNOSTIC_HPP
+
+# include <cppad/utility/vector.hpp>
+
+namespace dismod_at {
+   extern void mcmc_diagnostic(
+      size_t                         n_chain ,
+      const CppAD::vector<double>&   draw    ,
+      double&                        r_hat   ,
+      double&                        ess
+   );
+}
+
+# endif
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_MEMORY_CONNECTION_HPP
+# define DISMOD_AT_MEMORY_CONNECTION_HPP
+
+# include <sqlite3.h>
+# include <string>
+namespace dismod_at {
+   extern sqlite3* open_memory_connection(
+      sqlite3*           disk_db
+   );
+   extern void close_connection(
+      sqlite3*           db
+   );
+}
+
+# endif
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_ODE2_CHECKPOINT_HPP
+# define DISMOD_AT_ODE2_CHECKPOINT_HPP
+
+# include <cppad/utility/vector.hpp>
+# include "a1_double.hpp"
+
+namespace dismod_at {
+   extern void ode2_checkpoint_setup(void);
+   //
+   extern CppAD::vector<a1_double> ode2_checkpoint(
+      size_t                           case_number ,
+      const CppAD::vector<a1_double>&  b           ,
+      const CppAD::vector<a1_double>&  yi          ,
+      const a1_double&                 tf
+   );
+}
+# endif
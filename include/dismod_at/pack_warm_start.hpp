@@ -10,10 +10,12 @@
 
 namespace dismod_at {
    CppAD::vector<double> pack_warm_start(
-      const CppAD::mixed::warm_start_struct& warm_start
+      const CppAD::mixed::warm_start_struct& warm_start ,
+      const CppAD::vector<double>&           random_opt
    );
    CppAD::mixed::warm_start_struct unpack_warm_start(
-      const CppAD::vector<double>& vec
+      const CppAD::vector<double>& vec        ,
+      CppAD::vector<double>&       random_opt
    );
 }
 
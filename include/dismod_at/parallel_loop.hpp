@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_PARALLEL_LOOP_HPP
+# define DISMOD_AT_PARALLEL_LOOP_HPP
+
+# include <cstddef>
+# include <functional>
+
+namespace dismod_at {
+   extern void parallel_loop(
+      size_t                                 n_thread ,
+      const std::function<void(size_t)>&     work
+   );
+}
+
+# endif
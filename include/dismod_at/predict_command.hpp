@@ -20,6 +20,8 @@ namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 void predict_command(
    const std::string&                                    source              ,
    bool                                                  zero_meas_value     ,
+   bool                                                  summary             ,
+   bool                                                  delta               ,
    sqlite3*                                              db                  ,
    const dismod_at::db_input_struct&                     db_input            ,
    const dismod_at::pack_info&                           pack_object         ,
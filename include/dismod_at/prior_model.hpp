@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-24 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 # ifndef DISMOD_AT_PRIOR_MODEL_HPP
 # define DISMOD_AT_PRIOR_MODEL_HPP
@@ -25,15 +25,35 @@ namespace dismod_at {
       // means used for priors, see documentation in replace_mean
       CppAD::vector<double>              prior_mean_;
 
-      // log_prior
+      // list of prior terms that are not uniform
+      // (structure of arrays, one element per term)
+      struct term_list_struct {
+         // variable index for y in residual_density
+         CppAD::vector<size_t>       var_id;
+         // variable index for z (null for a value prior)
+         CppAD::vector<size_t>       z_var_id;
+         // variable index for standard deviation multiplier (or null)
+         CppAD::vector<size_t>       mulstd_offset;
+         // residual_struct index; i.e., 3 * var_id + k
+         CppAD::vector<size_t>       index;
+         // prior information
+         CppAD::vector<density_enum> density;
+         CppAD::vector<double>       mean;
+         CppAD::vector<double>       delta;
+         CppAD::vector<double>       eta;
+         CppAD::vector<double>       nu;
+      };
+      term_list_struct                   fixed_term_;
+      term_list_struct                   random_term_;
+
+      // compile_terms: set fixed_term_ and random_term_
+      void compile_terms(void);
+
+      // eval_terms
       template <class Float>
-      residual_struct<Float> log_prior(
-         const prior_struct& prior        ,
-         const Float&        mulstd       ,
-         const Float&        z            ,
-         const Float&        y            ,
-         size_t              index        ,
-         bool                difference
+      CppAD::vector< residual_struct<Float> > eval_terms(
+         const term_list_struct&     term         ,
+         const CppAD::vector<Float>& pack_vec
       ) const;
    public:
       // ctor
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_PROCESS_LOOP_HPP
+# define DISMOD_AT_PROCESS_LOOP_HPP
+
+# include <cstddef>
+# include <string>
+# include <functional>
+
+namespace dismod_at {
+   extern std::string process_loop(
+      size_t                                                 n_process ,
+      size_t                                                 n_task    ,
+      const std::function<std::string(size_t, bool)>&        work      ,
+      const std::function<void(size_t, const std::string&)>& result
+   );
+}
+
+# endif
@@ -1,11 +1,12 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
-// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
 // ----------------------------------------------------------------------------
 # ifndef DISMOD_AT_RESIDUAL_DENSITY_HPP
 # define DISMOD_AT_RESIDUAL_DENSITY_HPP
 
 # include <utility>
+# include <cppad/utility/vector.hpp>
 # include "get_density_table.hpp"
 
 namespace dismod_at {
@@ -39,6 +40,35 @@ namespace dismod_at {
       const Float&       d_sample_size  ,
       size_t             index
    );
+
+   // BEGIN_RESIDUAL_BATCH_STRUCT
+   struct residual_batch_struct {
+      // real_data_enum or simulated_data_enum
+      residual_enum          residual_type;
+      // density for every element of this batch
+      density_enum           density;
+      // index for each element of this batch
+      CppAD::vector<size_t>  index;
+      // y for real data, z for simulated data
+      CppAD::vector<double>  obs;
+      // eta, nu, and sample size for each element
+      CppAD::vector<double>  eta;
+      CppAD::vector<double>  nu;
+      CppAD::vector<double>  sample_size;
+      // constants set by residual_batch_const
+      CppAD::vector<double>  log_obs;
+      CppAD::vector<double>  log_n_choose_k;
+   };
+   // END_RESIDUAL_BATCH_STRUCT
+
+   extern void residual_batch_const(residual_batch_struct& batch);
+
+   extern void residual_density_batch(
+      const residual_batch_struct&               batch        ,
+      const CppAD::vector<double>&               mu_vec       ,
+      const CppAD::vector<double>&               delta_vec    ,
+      CppAD::vector< residual_struct<double> >&  residual_vec
+   );
 }
 
 # endif
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_SQLITE_PROFILE_HPP
+# define DISMOD_AT_SQLITE_PROFILE_HPP
+
+# include <sqlite3.h>
+# include <string>
+
+namespace dismod_at {
+   std::string sqlite_profile(
+      sqlite3*             db           ,
+      const std::string&   profile
+   );
+   bool sqlite_bulk_begin(
+      sqlite3*             db           ,
+      size_t               n_value
+   );
+   void sqlite_bulk_end(
+      sqlite3*             db
+   );
+}
+
+# endif
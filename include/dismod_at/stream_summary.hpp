@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-26 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_STREAM_SUMMARY_HPP
+# define DISMOD_AT_STREAM_SUMMARY_HPP
+
+# include <cppad/utility/vector.hpp>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+class stream_summary {
+private:
+   // probabilities for the quantiles
+   CppAD::vector<double> prob_;
+   //
+   // number of values added so far
+   size_t                n_value_;
+   //
+   // mean of the values added so far
+   double                mean_;
+   //
+   // sum of squares of the deviations from mean_
+   double                sum_sq_;
+   //
+   // P-squared markers: height_[5*k+i], position_[5*k+i], and
+   // desired_[5*k+i] are the i-th marker for the k-th quantile.
+   // During the first five calls to add, height_[0], ..., height_[4]
+   // holds the values (in sorted order).
+   CppAD::vector<double> height_;
+   CppAD::vector<double> position_;
+   CppAD::vector<double> desired_;
+public:
+   // constructor
+   stream_summary(const CppAD::vector<double>& prob);
+   //
+   // add
+   void add(double value);
+   //
+   // n_value
+   size_t n_value(void) const;
+   //
+   // mean
+   double mean(void) const;
+   //
+   // std_dev
+   double std_dev(void) const;
+   //
+   // quantile
+   double quantile(size_t k) const;
+};
+
+} // END_DISMOD_AT_NAMESPACE
+
+# endif
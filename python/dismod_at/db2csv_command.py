@@ -899,6 +899,11 @@ def db2csv_command(database_file_arg) :
    have_table['truth_var']       = check4table('truth_var')
    have_table['sample']          = check4table('sample')
    have_table['data_sim']        = check4table('data_sim')
+   #
+   # compact storage; see get_table_dict
+   for table in [ 'sample', 'data_sim' ] :
+      if not have_table[table] :
+         have_table[table] = check4table(table + '_blob')
    have_table['prior_sim']       = check4table('prior_sim')
    have_table['fit_var']         = check4table('fit_var')
    have_table['fit_data_subset'] = check4table('fit_data_subset')
@@ -1208,6 +1213,8 @@ def db2csv_command(database_file_arg) :
       [ "accept_after_max_steps_fixed",      "5"],
       [ "accept_after_max_steps_random",     "5"],
       [ "age_avg_split",                     ""],
+      [ "aggregate_data",                    "false"],
+      [ "asymptotic_lanczos_step",           "0"],
       [ "asymptotic_rcond_lower",            "0.0"],
       [ "avgint_extra_columns",              ""],
       [ "bound_frac_fixed",                  "1e-2"],
@@ -1216,12 +1223,20 @@ def db2csv_command(database_file_arg) :
       [ "data_extra_columns",                ""],
       [ "derivative_test_fixed",             "none"],
       [ "derivative_test_random",            "none"],
+      [ "gauss_newton_fixed",                "0"],
       [ "hold_out_integrand",                ""],
       [ "limited_memory_max_history_fixed",  "30"],
       [ "max_num_iter_fixed",                "100"],
       [ "max_num_iter_random",               "100"],
+      [ "mcmc_number_chain",                 "4"],
+      [ "mcmc_number_leapfrog",              "10"],
+      [ "mcmc_number_warmup",                "200"],
       [ "meas_noise_effect",                 "add_std_scale_all"],
+      [ "memory_database",                   "false"],
       [ "method_random",                     "ipopt_random"],
+      [ "number_thread",                     "1"],
+      [ "ode_lexis_grid",                    "false"],
+      [ "ode_step_schedule",                 ""],
       [ "ode_step_size",                     "10.0"],
       [ "other_database",                    ""],
       [ "other_input_table",                 ""],
@@ -1233,10 +1248,13 @@ def db2csv_command(database_file_arg) :
       [ "random_seed",                       "0"],
       [ "rate_case",                         "iota_pos_rho_zero"],
       [ "splitting_covariate",               ""],
+      [ "sqlite_profile",                    "safe"],
+      [ "storage_format",                    "long"],
       [ "tolerance_fixed",                   "1e-8"],
       [ "tolerance_random",                  "1e-8"],
       [ "trace_init_fit_model",              "false"],
       [ "warn_on_stderr",                    "true"],
+      [ "zero_sum_basis",                    "false"],
       [ "zero_sum_child_rate",               ""],
       [ "zero_sum_mulcov_group",             ""],
       # END_SORT_THIS_LINE_MINUS_1
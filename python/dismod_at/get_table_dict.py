@@ -50,6 +50,14 @@
 #
 # You can determine the type for all the columns in the table using
 # :ref:`get_name_type-name` .
+#
+# Compact Storage
+# ***************
+# If *tbl_name* is ``sample`` or ``data_sim`` ,
+# and the table was written using the
+# :ref:`sample_table@Compact Storage` format,
+# the corresponding ``_blob`` table is read and *table_dict*
+# is the same as if the table had been written using the long format.
 # {xrst_toc_hidden
 #    example/table/get_table_dict.py
 # }
@@ -60,9 +68,55 @@
 #
 # {xrst_end get_table_dict}
 # ---------------------------------------------------------------------------
+# column names for the tables that can use compact storage
+compact_col_name = {
+   'sample'   : ( 'sample_index',   'var_id',         'var_value' ),
+   'data_sim' : ( 'simulate_index', 'data_subset_id', 'data_sim_value' ),
+}
+#
+# get_compact_table
+# returns None if tbl_name_blob does not exist
+def get_compact_table(connection, tbl_name) :
+   import array
+   #
+   # check if table exists
+   blob_name = tbl_name + '_blob'
+   cursor    = connection.cursor()
+   cmd       = "select name from sqlite_master where type='table' AND name="
+   cmd      += "'" + blob_name + "';"
+   if len( cursor.execute(cmd).fetchall() ) == 0 :
+      return None
+   #
+   # table_dict
+   (index_name, position_name, value_name) = compact_col_name[tbl_name]
+   cmd  = f'select {index_name}, sizeof_value, {value_name} from {blob_name} '
+   cmd += f'order by {blob_name}_id'
+   table_dict = list()
+   for (index, sizeof_value, blob) in cursor.execute(cmd) :
+      if sizeof_value == 8 :
+         value_vec = array.array('d')
+      else :
+         assert sizeof_value == 4
+         value_vec = array.array('f')
+      value_vec.frombytes(blob)
+      for (position, value) in enumerate(value_vec) :
+         row = {
+            index_name    : index ,
+            position_name : position ,
+            value_name    : float(value) ,
+         }
+         table_dict.append(row)
+   return table_dict
+#
 def get_table_dict(connection, tbl_name) :
    import dismod_at
    #
+   # compact storage
+   if tbl_name in compact_col_name :
+      table_dict = get_compact_table(connection, tbl_name)
+      if table_dict is not None :
+         return table_dict
+   #
    (col_name, col_type) = dismod_at.get_name_type(connection, tbl_name)
    assert col_name[0] == tbl_name + '_id'
    del col_name[0]
@@ -141,7 +141,9 @@ def plot_rate_fit(database, pdf_file, plot_title, rate_set) :
       else :
          tables[name] = dismod_at.get_table_dict(connection, name)
    assert 'sample' not in other_input_table_list
-   if check4table(connection, 'sample') :
+   have_sample  = check4table(connection, 'sample')
+   have_sample  = have_sample or check4table(connection, 'sample_blob')
+   if have_sample :
       tables['sample'] = dismod_at.get_table_dict(connection, 'sample')
    connection.close()
    if other_connection != None :
@@ -0,0 +1,115 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Check that the aggregate_data option combines duplicate gaussian and
+# log_gaussian data rows: the fixed likelihood tape is smaller and the
+# optimization follows the same path as without aggregation.
+# ----------------------------------------------------------------------------
+import sys
+import os
+import copy
+# ---------------------------------------------------------------------------
+# check execution is from distribution directory
+test_program  = 'test/user/aggregate_data.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+print(test_program)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# import get_started_db example
+sys.path.append( os.getcwd() + '/example/get_started' )
+import get_started_db
+#
+# change into the test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ---------------------------------------------------------------------------
+# create get_started.db
+get_started_db.get_started_db()
+# -----------------------------------------------------------------------
+# Replace the data table by three gaussian and three log_gaussian copies
+# of its only row that have different measured values and standard deviations.
+file_name      = 'get_started.db'
+program        = '../../devel/dismod_at'
+connection     = dismod_at.create_connection(
+   file_name, new = False, readonly = False
+)
+density_table  = dismod_at.get_table_dict(connection, 'density')
+data_table     = dismod_at.get_table_dict(connection, 'data')
+assert len(data_table) == 1
+new_table      = list()
+for density_name in [ 'gaussian', 'log_gaussian' ] :
+   density_id = None
+   for (row_id, row) in enumerate( density_table ) :
+      if row['density_name'] == density_name :
+         density_id = row_id
+   for factor in [ 0.9, 1.0, 1.2 ] :
+      row = copy.copy( data_table[0] )
+      row['density_id'] = density_id
+      row['eta']        = 1e-6
+      row['meas_value'] = factor * row['meas_value']
+      row['meas_std']   = factor * row['meas_std']
+      new_table.append( row )
+dismod_at.replace_table(connection, 'data', new_table)
+connection.close()
+# -----------------------------------------------------------------------
+# fit
+# returns the fit_var values, the trace_fixed objective values,
+# and the size of the fixed likelihood tape
+def fit(aggregate_data) :
+   for command in [
+      [ 'set', 'option', 'aggregate_data', aggregate_data ] ,
+      [ 'init' ] ,
+      [ 'fit', 'fixed' ] ,
+   ] :
+      dismod_at.system_command_prc( [ program, file_name ] + command )
+   #
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   fit_var_table     = dismod_at.get_table_dict(connection, 'fit_var')
+   trace_fixed_table = dismod_at.get_table_dict(connection, 'trace_fixed')
+   mixed_info_table  = dismod_at.get_table_dict(connection, 'mixed_info')
+   connection.close()
+   #
+   fit_var_value = [ row['fit_var_value'] for row in fit_var_table ]
+   obj_value     = [ row['obj_value'] for row in trace_fixed_table ]
+   size_var      = None
+   for row in mixed_info_table :
+      if row['mixed_name'] == 'fix_like_fun.size_var' :
+         size_var = int( row['mixed_value'] )
+   return fit_var_value, obj_value, size_var
+# -----------------------------------------------------------------------
+# compare fits with and without aggregation
+separate_var, separate_obj, separate_size    = fit('false')
+aggregate_var, aggregate_obj, aggregate_size = fit('true')
+#
+# the fixed likelihood tape is smaller
+assert aggregate_size < separate_size
+#
+# the optimizer takes the same steps
+assert len(separate_obj) == len(aggregate_obj)
+for k in range( len(separate_obj) ) :
+   diff = abs( aggregate_obj[k] - separate_obj[k] )
+   assert diff <= 1e-10 * ( 1.0 + abs( separate_obj[k] ) )
+#
+# same solution
+assert len(separate_var) == len(aggregate_var)
+for var_id in range( len(separate_var) ) :
+   if separate_var[var_id] == 0.0 :
+      assert aggregate_var[var_id] == 0.0
+   else :
+      assert abs( aggregate_var[var_id] / separate_var[var_id] - 1.0 ) < 1e-8
+# -----------------------------------------------------------------------
+print('aggregate_data.py: OK')
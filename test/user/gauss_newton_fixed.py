@@ -0,0 +1,99 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Check that the gauss_newton_fixed option is used for Gaussian data,
+# reduces the number of Ipopt iterations, and does not change the fit.
+# Also check that it is not used, and a warning is logged, for Laplace data.
+# ----------------------------------------------------------------------------
+import sys
+import os
+# ---------------------------------------------------------------------------
+# check execution is from distribution directory
+test_program  = 'test/user/gauss_newton_fixed.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+print(test_program)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# import get_started_db example
+sys.path.append( os.getcwd() + '/example/get_started' )
+import get_started_db
+#
+# change into the test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ---------------------------------------------------------------------------
+# create get_started.db
+get_started_db.get_started_db()
+file_name = 'get_started.db'
+program   = '../../devel/dismod_at'
+# -----------------------------------------------------------------------
+# fit
+# returns the fit_var values, the number of Ipopt iterations,
+# and the number of gauss_newton_fixed not used warnings
+def fit(gauss_newton_fixed) :
+   for command in [
+      [ 'set', 'option', 'gauss_newton_fixed', gauss_newton_fixed ] ,
+      [ 'init' ] ,
+      [ 'fit', 'fixed' ] ,
+   ] :
+      dismod_at.system_command_prc( [ program, file_name ] + command )
+   #
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   fit_var_table     = dismod_at.get_table_dict(connection, 'fit_var')
+   trace_fixed_table = dismod_at.get_table_dict(connection, 'trace_fixed')
+   log_table         = dismod_at.get_table_dict(connection, 'log')
+   connection.close()
+   #
+   fit_var_value = [ row['fit_var_value'] for row in fit_var_table ]
+   n_not_used    = 0
+   for row in log_table :
+      if row['message'].startswith('gauss_newton_fixed: not used') :
+         n_not_used += 1
+   return fit_var_value, len(trace_fixed_table), n_not_used
+# -----------------------------------------------------------------------
+# compare fits with and without Gauss-Newton iterations
+ipopt_var, ipopt_iter, ipopt_not_used = fit('0')
+gauss_var, gauss_iter, gauss_not_used = fit('10')
+#
+# the Gauss-Newton iterations were used and reduced the Ipopt iterations
+assert ipopt_not_used == 0
+assert gauss_not_used == 0
+assert gauss_iter < ipopt_iter
+#
+# same solution
+assert len(ipopt_var) == len(gauss_var)
+for var_id in range( len(ipopt_var) ) :
+   if ipopt_var[var_id] == 0.0 :
+      assert abs( gauss_var[var_id] ) < 1e-8
+   else :
+      assert abs( gauss_var[var_id] / ipopt_var[var_id] - 1.0 ) < 1e-6
+# -----------------------------------------------------------------------
+# Laplace data: the Gauss-Newton iterations are not used
+connection    = dismod_at.create_connection(
+   file_name, new = False, readonly = False
+)
+density_table = dismod_at.get_table_dict(connection, 'density')
+data_table    = dismod_at.get_table_dict(connection, 'data')
+for (density_id, row) in enumerate( density_table ) :
+   if row['density_name'] == 'laplace' :
+      data_table[0]['density_id'] = density_id
+dismod_at.replace_table(connection, 'data', data_table)
+connection.close()
+laplace_var, laplace_iter, laplace_not_used = fit('10')
+assert laplace_not_used == 1
+# -----------------------------------------------------------------------
+print('gauss_newton_fixed.py: OK')
@@ -0,0 +1,101 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Check the fit command multistart table and that the best start gives
+# the same solution as an ordinary fit when the problem has one optimum.
+# ----------------------------------------------------------------------------
+import sys
+import os
+# ---------------------------------------------------------------------------
+# check execution is from distribution directory
+test_program  = 'test/user/multistart.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+print(test_program)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# import get_started_db example
+sys.path.append( os.getcwd() + '/example/get_started' )
+import get_started_db
+#
+# change into the test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ---------------------------------------------------------------------------
+# create get_started.db
+get_started_db.get_started_db()
+file_name = 'get_started.db'
+program   = '../../devel/dismod_at'
+# -----------------------------------------------------------------------
+# run_fit
+def run_fit(extra_args) :
+   for command in [ [ 'init' ] , [ 'fit', 'both' ] + extra_args ] :
+      dismod_at.system_command_prc( [ program, file_name ] + command )
+   #
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   fit_var_table = dismod_at.get_table_dict(connection, 'fit_var')
+   multistart_table = None
+   if len(extra_args) > 0 :
+      multistart_table = dismod_at.get_table_dict(connection, 'multistart')
+   connection.close()
+   fit_var = [ row['fit_var_value'] for row in fit_var_table ]
+   return fit_var, multistart_table
+# -----------------------------------------------------------------------
+# ordinary fit
+single, table = run_fit( [] )
+#
+# multistart fit
+number_start = 3
+multi, table = run_fit( [ 'multistart', str(number_start) ] )
+#
+# multistart table
+assert len(table) == number_start
+n_best   = 0
+obj_best = None
+for row in table :
+   if row['best'] == 1 :
+      n_best  += 1
+      obj_best = row['obj_value']
+assert n_best == 1
+for row in table :
+   assert obj_best <= row['obj_value']
+#
+# all the starts converge to the same solution and the objective does not
+# depend on the starting point (the trace_fixed obj_value does)
+for row in table :
+   assert abs( row['obj_value'] - obj_best ) <= 1e-6 * ( 1.0 + abs(obj_best) )
+#
+# solutions
+assert len(single) == len(multi)
+for var_id in range( len(single) ) :
+   if single[var_id] == 0.0 :
+      assert abs( multi[var_id] ) < 1e-8
+   else :
+      assert abs( multi[var_id] / single[var_id] - 1.0 ) < 1e-4
+#
+# run the starts in separate processes
+dismod_at.system_command_prc(
+   [ program, file_name, 'set', 'option', 'number_thread', str(number_start) ]
+)
+parallel, parallel_table = run_fit( [ 'multistart', str(number_start) ] )
+#
+# the results do not depend on the number of processes
+assert parallel == multi
+for start_id in range(number_start) :
+   for key in [ 'obj_value', 'inf_pr', 'inf_du', 'n_iter', 'best' ] :
+      assert parallel_table[start_id][key] == table[start_id][key]
+# -----------------------------------------------------------------------
+print('multistart.py: OK')
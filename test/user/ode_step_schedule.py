@@ -0,0 +1,93 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Check that the ode_step_schedule option logs each stage, that the final
+# stage needs fewer iterations than a fit that only uses ode_step_size,
+# and that it gives the same solution.
+# ----------------------------------------------------------------------------
+import sys
+import os
+# ---------------------------------------------------------------------------
+# check execution is from distribution directory
+test_program  = 'test/user/ode_step_schedule.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+print(test_program)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# import get_started_db example
+sys.path.append( os.getcwd() + '/example/get_started' )
+import get_started_db
+#
+# change into the test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ---------------------------------------------------------------------------
+# create get_started.db
+get_started_db.get_started_db()
+file_name = 'get_started.db'
+program   = '../../devel/dismod_at'
+# -----------------------------------------------------------------------
+# run_fit
+def run_fit(ode_step_schedule) :
+   for command in [
+      [ 'set', 'option', 'ode_step_schedule', ode_step_schedule ] ,
+      [ 'init' ] ,
+      [ 'fit', 'both' ] ,
+   ] :
+      dismod_at.system_command_prc( [ program, file_name ] + command )
+   #
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   fit_var_table     = dismod_at.get_table_dict(connection, 'fit_var')
+   trace_fixed_table = dismod_at.get_table_dict(connection, 'trace_fixed')
+   log_table         = dismod_at.get_table_dict(connection, 'log')
+   connection.close()
+   fit_var = [ row['fit_var_value'] for row in fit_var_table ]
+   n_iter  = trace_fixed_table[-1]['iter']
+   #
+   # stage messages logged by the most recent fit command
+   stage_message = list()
+   for row in log_table :
+      if row['message_type'] == 'command' :
+         if row['message'].startswith('begin fit') :
+            stage_message = list()
+      if row['message'].startswith('ode_step_schedule:') :
+         stage_message.append( row['message'] )
+   return fit_var, n_iter, stage_message
+# -----------------------------------------------------------------------
+# fit without and with a schedule
+single, single_iter, message = run_fit('')
+assert len(message) == 0
+staged, staged_iter, message = run_fit('40.0 20.0')
+assert len(message) == 3
+for i, step_size in enumerate( [ '40', '20', '10' ] ) :
+   check = 'ode_step_schedule: ode_step_size = ' + step_size
+   assert message[i].startswith( check )
+#
+# the final stage starts near the solution
+check = ', iterations = ' + str(staged_iter) + ','
+assert check in message[2]
+assert staged_iter < single_iter
+#
+# solutions
+assert len(single) == len(staged)
+for var_id in range( len(single) ) :
+   if single[var_id] == 0.0 :
+      assert abs( staged[var_id] ) < 1e-8
+   else :
+      assert abs( staged[var_id] / single[var_id] - 1.0 ) < 1e-4
+# -----------------------------------------------------------------------
+print('ode_step_schedule.py: OK')
@@ -0,0 +1,179 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Test predict fit_var delta using a model with one fixed effect iota
+# that is measured directly by Sincidence data with Gaussian noise.
+# In this case the standard deviation of the prediction is
+# 1 / sqrt( sum_i 1 / meas_std_i^2 ).
+# The fixed effect is scaled (eta is not null) so that the conversion
+# of derivatives to the scaled space is tested.
+# ---------------------------------------------------------------------------
+iota_true  = 0.01
+meas_std   = [ 1e-3, 2e-3, 4e-3 ]
+eta        = 1e-3
+# ---------------------------------------------------------------------------
+# BEGIN PYTHON
+import sys
+import os
+import math
+test_program  = 'test/user/predict_delta.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# change into the build/test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ------------------------------------------------------------------------
+def example_db (file_name) :
+   def fun_iota_parent(a, t) :
+      return ('prior_iota_parent', None, None)
+   #
+   # age_list, time_list
+   age_list    = [ 0.0, 100.0 ]
+   time_list   = [ 1990.0, 2010.0 ]
+   #
+   # integrand table
+   integrand_table = [ { 'name':'Sincidence' } ]
+   #
+   # node table
+   node_table = [ { 'name':'world', 'parent':'' } ]
+   #
+   # weight table
+   weight_table = list()
+   #
+   # covariate table
+   covariate_table = list()
+   #
+   # mulcov table
+   mulcov_table = list()
+   #
+   # avgint table
+   avgint_table = [ {
+      'integrand':   'Sincidence',
+      'node':        'world',
+      'subgroup':    'world',
+      'weight':      '',
+      'age_lower':   50.0,
+      'age_upper':   50.0,
+      'time_lower':  2000.0,
+      'time_upper':  2000.0,
+   } ]
+   #
+   # data table
+   data_table = list()
+   for std in meas_std :
+      row = {
+         'integrand':   'Sincidence',
+         'node':        'world',
+         'subgroup':    'world',
+         'density':     'gaussian',
+         'weight':      '',
+         'hold_out':    False,
+         'age_lower':   50.0,
+         'age_upper':   50.0,
+         'time_lower':  2000.0,
+         'time_upper':  2000.0,
+         'meas_value':  iota_true,
+         'meas_std':    std,
+      }
+      data_table.append( row )
+   #
+   # prior_table
+   prior_table = [ {
+      'name':     'prior_iota_parent',
+      'density':  'uniform',
+      'lower':    iota_true / 100.0,
+      'upper':    iota_true * 100.0,
+      'mean':     iota_true / 3.0,
+      'eta':      eta,
+   } ]
+   #
+   # smooth table
+   smooth_table = [ {
+      'name':    'smooth_iota_parent',
+      'age_id':  [ 0 ],
+      'time_id': [ 0 ],
+      'fun':     fun_iota_parent
+   } ]
+   #
+   # rate table
+   rate_table = [ {
+      'name':          'iota',
+      'parent_smooth': 'smooth_iota_parent',
+      'child_smooth':  None,
+   } ]
+   #
+   # option_table
+   option_table = [
+      { 'name':'rate_case',              'value':'iota_pos_rho_zero' },
+      { 'name':'parent_node_name',       'value':'world'             },
+      { 'name':'print_level_fixed',      'value':'0'                 },
+      { 'name':'tolerance_fixed',        'value':'1e-10'             },
+   ]
+   #
+   # nslist_dict, subgroup_table
+   nslist_dict    = dict()
+   subgroup_table = [ { 'subgroup':'world', 'group':'world' } ]
+   #
+   # create database
+   dismod_at.create_database(
+      file_name,
+      age_list,
+      time_list,
+      integrand_table,
+      node_table,
+      subgroup_table,
+      weight_table,
+      covariate_table,
+      avgint_table,
+      data_table,
+      prior_table,
+      smooth_table,
+      nslist_dict,
+      rate_table,
+      mulcov_table,
+      option_table
+   )
+   return
+# ===========================================================================
+file_name  = 'example.db'
+example_db(file_name)
+#
+program = '../../devel/dismod_at'
+dismod_at.system_command_prc([ program, file_name, 'init' ])
+dismod_at.system_command_prc([ program, file_name, 'fit', 'fixed' ])
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'asymptotic', 'fixed', '10' ]
+)
+dismod_at.system_command_prc(
+   [ program, file_name, 'predict', 'fit_var', 'delta' ]
+)
+# -----------------------------------------------------------------------
+connection    = dismod_at.create_connection(
+   file_name, new = False, readonly = True
+)
+predict_table = dismod_at.get_table_dict(connection, 'predict')
+connection.close()
+#
+# check
+assert len(predict_table) == 1
+row   = predict_table[0]
+check = 1.0 / math.sqrt( sum( [ 1.0 / (std * std) for std in meas_std ] ) )
+assert abs( row['avg_integrand'] / iota_true - 1.0 ) < 1e-6
+assert abs( row['avg_std'] / check - 1.0 ) < 1e-4
+# -----------------------------------------------------------------------------
+print('predict_delta.py: OK')
+# -----------------------------------------------------------------------------
+# END PYTHON
@@ -0,0 +1,122 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Check the asymptotic sample command with asymptotic_lanczos_step non-zero
+# and no random effects: the fixed effects Hessian is not formed
+# (the hes_fixed table is not created) and the samples have the same
+# statistics as the samples that factor the Hessian.
+# ----------------------------------------------------------------------------
+import sys
+import os
+import math
+# ---------------------------------------------------------------------------
+# check execution is from distribution directory
+test_program  = 'test/user/sample_lanczos.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+print(test_program)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# import get_started_db example
+sys.path.append( os.getcwd() + '/example/get_started' )
+import get_started_db
+#
+# change into the test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ---------------------------------------------------------------------------
+# create get_started.db
+get_started_db.get_started_db()
+file_name = 'get_started.db'
+program   = '../../devel/dismod_at'
+# -----------------------------------------------------------------------
+# get_table
+def get_table(table_name) :
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   table = dismod_at.get_table_dict(connection, table_name)
+   connection.close()
+   return table
+# -----------------------------------------------------------------------
+# sample_stats
+# mean and standard deviation of the samples for each var_id
+def sample_stats(n_var, number_sample) :
+   sample_table = get_table('sample')
+   assert len(sample_table) == n_var * number_sample
+   sum_value = n_var * [0.0]
+   sum_sq    = n_var * [0.0]
+   for row in sample_table :
+      var_id             = row['var_id']
+      sum_value[var_id] += row['var_value']
+      sum_sq[var_id]    += row['var_value'] * row['var_value']
+   mean = list()
+   std  = list()
+   for var_id in range(n_var) :
+      avg = sum_value[var_id] / number_sample
+      var = sum_sq[var_id] / number_sample - avg * avg
+      mean.append(avg)
+      std.append( math.sqrt( max(var, 0.0) ) )
+   return mean, std, sample_table
+# -----------------------------------------------------------------------
+# does_table_exist
+def does_table_exist(table_name) :
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   sql_cmd  = 'SELECT name FROM sqlite_master WHERE type="table" '
+   sql_cmd += 'AND name="' + table_name + '"'
+   result   = dismod_at.sql_command(connection, sql_cmd)
+   connection.close()
+   return len(result) > 0
+# -----------------------------------------------------------------------
+# fit
+for command in [
+   [ 'set', 'option', 'random_seed', '123' ] ,
+   [ 'init' ] ,
+   [ 'fit', 'fixed' ] ,
+] :
+   dismod_at.system_command_prc( [ program, file_name ] + command )
+fit_var_table = get_table('fit_var')
+n_var         = len(fit_var_table)
+#
+# samples that factor the Hessian
+number_sample = 1000
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'asymptotic', 'fixed', str(number_sample) ]
+)
+assert does_table_exist('hes_fixed')
+chol_mean, chol_std, chol_table = sample_stats(n_var, number_sample)
+#
+# samples that use Hessian vector products
+dismod_at.system_command_prc( [
+   program, file_name, 'set', 'option', 'asymptotic_lanczos_step', '10'
+] )
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'asymptotic', 'fixed', str(number_sample) ]
+)
+assert not does_table_exist('hes_fixed')
+lanczos_mean, lanczos_std, lanczos_table = sample_stats(n_var, number_sample)
+#
+# compare
+for var_id in range(n_var) :
+   fit_value = fit_var_table[var_id]['fit_var_value']
+   if chol_std[var_id] == 0.0 :
+      assert lanczos_std[var_id] == 0.0
+      assert lanczos_mean[var_id] == fit_value
+   else :
+      assert abs( lanczos_mean[var_id] - fit_value ) < 0.2 * chol_std[var_id]
+      assert abs( lanczos_std[var_id] / chol_std[var_id] - 1.0 ) < 0.15
+# -----------------------------------------------------------------------
+print('sample_lanczos.py: OK')
@@ -0,0 +1,153 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Check the sample command mcmc method: the samples agree with the
+# asymptotic samples for a nearly Gaussian posterior, the diagnostic table
+# is reasonable, and the samples are reproducible given the random seed
+# and do not depend on the number of threads.
+# ----------------------------------------------------------------------------
+import sys
+import os
+import math
+# ---------------------------------------------------------------------------
+# check execution is from distribution directory
+test_program  = 'test/user/sample_mcmc.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+print(test_program)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# import get_started_db example
+sys.path.append( os.getcwd() + '/example/get_started' )
+import get_started_db
+#
+# change into the test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ---------------------------------------------------------------------------
+# create get_started.db
+get_started_db.get_started_db()
+file_name = 'get_started.db'
+program   = '../../devel/dismod_at'
+# -----------------------------------------------------------------------
+# get_table
+def get_table(table_name) :
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   table = dismod_at.get_table_dict(connection, table_name)
+   connection.close()
+   return table
+# -----------------------------------------------------------------------
+# sample_stats
+# mean and standard deviation of the samples for each var_id
+def sample_stats(n_var, number_sample) :
+   sample_table = get_table('sample')
+   assert len(sample_table) == n_var * number_sample
+   sum_value = n_var * [0.0]
+   sum_sq    = n_var * [0.0]
+   for row in sample_table :
+      var_id             = row['var_id']
+      sum_value[var_id] += row['var_value']
+      sum_sq[var_id]    += row['var_value'] * row['var_value']
+   mean = list()
+   std  = list()
+   for var_id in range(n_var) :
+      avg = sum_value[var_id] / number_sample
+      var = sum_sq[var_id] / number_sample - avg * avg
+      mean.append(avg)
+      std.append( math.sqrt( max(var, 0.0) ) )
+   return mean, std, sample_table
+# -----------------------------------------------------------------------
+# fit
+for command in [
+   [ 'set', 'option', 'random_seed', '123' ] ,
+   [ 'init' ] ,
+   [ 'fit', 'both' ] ,
+] :
+   dismod_at.system_command_prc( [ program, file_name ] + command )
+fit_var_table = get_table('fit_var')
+n_var         = len(fit_var_table)
+#
+# asymptotic samples
+number_sample = 400
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'asymptotic', 'both', str(number_sample) ]
+)
+asy_mean, asy_std, asy_table = sample_stats(n_var, number_sample)
+#
+# mcmc samples
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'mcmc', 'both', str(number_sample) ]
+)
+mcmc_mean, mcmc_std, mcmc_table = sample_stats(n_var, number_sample)
+#
+# compare
+for var_id in range(n_var) :
+   fit_value = fit_var_table[var_id]['fit_var_value']
+   if asy_std[var_id] == 0.0 :
+      assert mcmc_std[var_id] == 0.0
+      assert mcmc_mean[var_id] == fit_value
+   else :
+      assert abs( mcmc_mean[var_id] - fit_value ) < 0.5 * asy_std[var_id]
+      assert abs( mcmc_std[var_id] / asy_std[var_id] - 1.0 ) < 0.3
+#
+# mcmc_diagnostic table
+number_chain     = 4
+diagnostic_table = get_table('mcmc_diagnostic')
+assert len(diagnostic_table) == 2 * number_chain + 2 * n_var
+for row in diagnostic_table :
+   name  = row['diagnostic_name']
+   value = row['diagnostic_value']
+   if name == 'acceptance_rate' :
+      assert row['var_id'] is None
+      assert 0.3 < value and value <= 1.0
+   elif name == 'step_size' :
+      assert row['var_id'] is None
+      assert 0.0 < value
+   else :
+      assert name in [ 'r_hat', 'ess' ]
+      assert row['chain_id'] is None
+      var_id = row['var_id']
+      if asy_std[var_id] == 0.0 :
+         assert value is None
+      elif name == 'r_hat' :
+         assert value < 1.1
+      else :
+         assert 10.0 < value
+#
+# reproducible
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'mcmc', 'both', str(number_sample) ]
+)
+check_mean, check_std, check_table = sample_stats(n_var, number_sample)
+for sample_id in range( len(mcmc_table) ) :
+   value = mcmc_table[sample_id]['var_value']
+   check = check_table[sample_id]['var_value']
+   assert value == check
+#
+# chains run in parallel give the same samples
+dismod_at.system_command_prc(
+   [ program, file_name, 'set', 'option', 'number_thread', '2' ]
+)
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'mcmc', 'both', str(number_sample) ]
+)
+check_mean, check_std, check_table = sample_stats(n_var, number_sample)
+for sample_id in range( len(mcmc_table) ) :
+   value = mcmc_table[sample_id]['var_value']
+   check = check_table[sample_id]['var_value']
+   assert value == check
+# -----------------------------------------------------------------------
+print('sample_mcmc.py: OK')
@@ -0,0 +1,224 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-26 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# Test that the data_sim and sample tables are the same when written
+# using the long, float64, and float32 storage formats.
+# ---------------------------------------------------------------------------
+iota_true  = 0.01
+meas_std   = [ 1e-3, 2e-3, 4e-3 ]
+eta        = 1e-3
+# ---------------------------------------------------------------------------
+# BEGIN PYTHON
+import sys
+import os
+import math
+test_program  = 'test/user/storage_format.py'
+check_program = sys.argv[0].replace('\\', '/')
+if check_program != test_program  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + test_program + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# change into the build/test/user directory
+if not os.path.exists('build/test/user') :
+   os.makedirs('build/test/user')
+os.chdir('build/test/user')
+# ------------------------------------------------------------------------
+def example_db (file_name) :
+   def fun_iota_parent(a, t) :
+      return ('prior_iota_parent', None, None)
+   #
+   # age_list, time_list
+   age_list    = [ 0.0, 100.0 ]
+   time_list   = [ 1990.0, 2010.0 ]
+   #
+   # integrand table
+   integrand_table = [ { 'name':'Sincidence' } ]
+   #
+   # node table
+   node_table = [ { 'name':'world', 'parent':'' } ]
+   #
+   # weight table
+   weight_table = list()
+   #
+   # covariate table
+   covariate_table = list()
+   #
+   # mulcov table
+   mulcov_table = list()
+   #
+   # avgint table
+   avgint_table = [ {
+      'integrand':   'Sincidence',
+      'node':        'world',
+      'subgroup':    'world',
+      'weight':      '',
+      'age_lower':   50.0,
+      'age_upper':   50.0,
+      'time_lower':  2000.0,
+      'time_upper':  2000.0,
+   } ]
+   #
+   # data table
+   data_table = list()
+   for std in meas_std :
+      row = {
+         'integrand':   'Sincidence',
+         'node':        'world',
+         'subgroup':    'world',
+         'density':     'gaussian',
+         'weight':      '',
+         'hold_out':    False,
+         'age_lower':   50.0,
+         'age_upper':   50.0,
+         'time_lower':  2000.0,
+         'time_upper':  2000.0,
+         'meas_value':  iota_true,
+         'meas_std':    std,
+      }
+      data_table.append( row )
+   #
+   # prior_table
+   prior_table = [ {
+      'name':     'prior_iota_parent',
+      'density':  'uniform',
+      'lower':    iota_true / 100.0,
+      'upper':    iota_true * 100.0,
+      'mean':     iota_true / 3.0,
+      'eta':      eta,
+   } ]
+   #
+   # smooth table
+   smooth_table = [ {
+      'name':    'smooth_iota_parent',
+      'age_id':  [ 0 ],
+      'time_id': [ 0 ],
+      'fun':     fun_iota_parent
+   } ]
+   #
+   # rate table
+   rate_table = [ {
+      'name':          'iota',
+      'parent_smooth': 'smooth_iota_parent',
+      'child_smooth':  None,
+   } ]
+   #
+   # option_table
+   option_table = [
+      { 'name':'rate_case',              'value':'iota_pos_rho_zero' },
+      { 'name':'parent_node_name',       'value':'world'             },
+      { 'name':'print_level_fixed',      'value':'0'                 },
+      { 'name':'tolerance_fixed',        'value':'1e-10'             },
+      { 'name':'random_seed',            'value':'1234'              },
+   ]
+   #
+   # nslist_dict, subgroup_table
+   nslist_dict    = dict()
+   subgroup_table = [ { 'subgroup':'world', 'group':'world' } ]
+   #
+   # create database
+   dismod_at.create_database(
+      file_name,
+      age_list,
+      time_list,
+      integrand_table,
+      node_table,
+      subgroup_table,
+      weight_table,
+      covariate_table,
+      avgint_table,
+      data_table,
+      prior_table,
+      smooth_table,
+      nslist_dict,
+      rate_table,
+      mulcov_table,
+      option_table
+   )
+   return
+# ===========================================================================
+file_name  = 'example.db'
+example_db(file_name)
+#
+program = '../../devel/dismod_at'
+dismod_at.system_command_prc([ program, file_name, 'init' ])
+dismod_at.system_command_prc(
+   [ program, file_name, 'set', 'truth_var', 'prior_mean' ]
+)
+#
+# table_dict
+table_dict = dict()
+for storage_format in [ 'long', 'float64', 'float32' ] :
+   #
+   # storage_format
+   connection = dismod_at.create_connection(file_name)
+   command    = "delete from option where option_name = 'storage_format'"
+   dismod_at.sql_command(connection, command)
+   command    = "insert into option (option_name, option_value) values "
+   command   += f"('storage_format', '{storage_format}')"
+   dismod_at.sql_command(connection, command)
+   connection.close()
+   #
+   # data_sim, sample
+   dismod_at.system_command_prc([ program, file_name, 'simulate', '2' ])
+   dismod_at.system_command_prc(
+      [ program, file_name, 'sample', 'simulate', 'both', '2' ]
+   )
+   dismod_at.system_command_prc(
+      [ program, file_name, 'predict', 'sample' ]
+   )
+   dismod_at.system_command_prc(
+      [ program, file_name, 'set', 'start_var', 'sample', '1' ]
+   )
+   dismod_at.system_command_prc( [ program, file_name, 'db2csv' ] )
+   #
+   # table_dict
+   connection = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   table_dict[storage_format] = dict()
+   for table_name in [ 'data_sim', 'sample', 'predict', 'start_var' ] :
+      table_dict[storage_format][table_name] = \
+         dismod_at.get_table_dict(connection, table_name)
+   cursor   = connection.cursor()
+   command  = "select name from sqlite_master where type='table'"
+   table_list = [ row[0] for row in cursor.execute(command) ]
+   connection.close()
+   #
+   # check which tables exist
+   compact = storage_format != 'long'
+   for table_name in [ 'data_sim', 'sample' ] :
+      assert (table_name in table_list) == (not compact)
+      assert (table_name + '_blob' in table_list) == compact
+#
+# check
+for storage_format in [ 'float64', 'float32' ] :
+   if storage_format == 'float64' :
+      eps = 1e-10
+   else :
+      eps = 1e-5
+   for table_name in table_dict['long'] :
+      long_table = table_dict['long'][table_name]
+      this_table = table_dict[storage_format][table_name]
+      assert len(long_table) == len(this_table)
+      for (long_row, this_row) in zip(long_table, this_table) :
+         assert long_row.keys() == this_row.keys()
+         for key in long_row :
+            long_value = long_row[key]
+            this_value = this_row[key]
+            if type(long_value) == float :
+               assert abs( this_value - long_value ) <= eps * abs(long_value)
+            else :
+               assert this_value == long_value
+# -----------------------------------------------------------------------------
+print('storage_format.py: OK')
+# -----------------------------------------------------------------------------
+# END PYTHON